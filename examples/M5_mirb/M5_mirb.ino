@@ -29,6 +29,7 @@ void mrubyc(uint8_t *mrbbuf)
     vm->pc_irep = vm->irep;
     vm->pc = 0;
     vm->current_regs = vm->regs;
+    mrbc_extend_regs(vm, vm->irep->nregs);
     vm->flag_preemption = 0;
     vm->callinfo_top = 0;
     vm->error_code = 0;
@@ -0,0 +1,36 @@
+/* assembled by hand to match bench_alloc.rb. (not generated by mrbc)
+   RITE0004 bytecode in big endian order. */
+#include <stdint.h>
+extern const uint8_t code[];
+const uint8_t
+#if defined __GNUC__
+__attribute__((aligned(4)))
+#elif defined _MSC_VER
+__declspec(align(4))
+#endif
+code[] = {
+0x52,0x49,0x54,0x45,0x30,0x30,0x30,0x34,0x32,0xd1,0x00,0x00,0x01,0x7f,0x4d,0x41,
+0x54,0x5a,0x30,0x30,0x30,0x30,0x49,0x52,0x45,0x50,0x00,0x00,0x01,0x61,0x30,0x30,
+0x30,0x30,0x00,0x00,0x00,0x00,0x00,0x09,0x00,0x10,0x00,0x00,0x00,0x00,0x00,0x37,
+0x04,0x80,0x00,0x05,0x05,0x00,0x00,0x05,0x04,0x80,0x00,0x43,0x04,0xc3,0xe7,0x83,
+0x04,0x80,0x00,0x92,0x00,0x80,0x40,0x37,0x04,0x80,0x00,0x06,0x04,0x80,0x80,0x20,
+0x01,0x02,0x40,0x01,0x01,0xbf,0xff,0x83,0x00,0x40,0x0d,0x97,0x02,0x00,0x00,0x3d,
+0x02,0x80,0x00,0xbd,0x02,0x00,0xc0,0xa0,0x04,0x80,0xc0,0x01,0x05,0x01,0x00,0x01,
+0x02,0x82,0x41,0x37,0x04,0x80,0xc0,0x01,0x05,0x01,0x40,0x01,0x03,0x02,0x40,0xbf,
+0x04,0xbf,0xff,0x83,0x05,0x00,0xc0,0x01,0x03,0x82,0x40,0x41,0x04,0x80,0x00,0x11,
+0x04,0x81,0x00,0x20,0x04,0x02,0x40,0x01,0x04,0x80,0xc0,0x01,0x05,0x40,0x07,0x83,
+0x04,0x81,0x40,0xa0,0x05,0x3f,0xff,0x83,0x04,0x81,0x80,0xb2,0x04,0xc0,0x01,0x99,
+0x04,0x80,0x40,0x01,0x05,0x01,0x00,0x01,0x04,0x81,0xc0,0xa0,0x04,0x80,0xc0,0x01,
+0x04,0x80,0xc0,0xad,0x01,0x82,0x40,0x01,0x04,0x80,0xc0,0x01,0x05,0x00,0x00,0x91,
+0x04,0x82,0x00,0xb3,0x04,0xbf,0xf0,0x98,0x04,0x80,0x00,0x06,0x05,0x00,0x01,0x3d,
+0x05,0x80,0x00,0x06,0x05,0x80,0x80,0x20,0x06,0x00,0x80,0x01,0x05,0x82,0x40,0xae,
+0x05,0x02,0xc0,0x3e,0x05,0x80,0x01,0xbd,0x05,0x02,0xc0,0x3e,0x04,0x82,0x80,0xa0,
+0x04,0x80,0x00,0x06,0x04,0x82,0xc0,0x20,0x00,0x00,0x00,0x4a,0x00,0x00,0x00,0x04,
+0x00,0x00,0x03,0x61,0x62,0x63,0x00,0x00,0x03,0x64,0x65,0x66,0x00,0x00,0x07,0x61,
+0x6c,0x6c,0x6f,0x63,0x3a,0x20,0x00,0x00,0x03,0x20,0x75,0x73,0x00,0x00,0x00,0x0c,
+0x00,0x03,0x46,0x6f,0x6f,0x00,0x00,0x01,0x4e,0x00,0x00,0x06,0x6d,0x69,0x63,0x72,
+0x6f,0x73,0x00,0x00,0x01,0x2b,0x00,0x00,0x03,0x6e,0x65,0x77,0x00,0x00,0x01,0x25,
+0x00,0x00,0x02,0x3d,0x3d,0x00,0x00,0x04,0x70,0x75,0x73,0x68,0x00,0x00,0x01,0x3c,
+0x00,0x00,0x01,0x2d,0x00,0x00,0x04,0x70,0x75,0x74,0x73,0x00,0x00,0x08,0x6d,0x65,
+0x6d,0x5f,0x73,0x74,0x61,0x74,0x00,0x45,0x4e,0x44,0x00,0x00,0x00,0x00,0x08,
+};
@@ -0,0 +1,42 @@
+#include <mrubyc_for_ESP32_Arduino.h>
+
+extern const uint8_t code[];
+
+#define MEMSIZE (1024*30)
+static uint8_t mempool[MEMSIZE];
+
+// micros() for ruby script.
+static void c_micros(mrb_vm *vm, mrb_value *v, int argc)
+{
+  SET_INT_RETURN(micros());
+}
+
+// memory statistics for ruby script. (needs MRBC_DEBUG)
+static void c_mem_stat(mrb_vm *vm, mrb_value *v, int argc)
+{
+#ifdef MRBC_DEBUG
+  int total, used, free, fragmentation;
+  mrbc_alloc_statistics(&total, &used, &free, &fragmentation);
+  console_printf("total %d used %d free %d fragmentation %d\n",
+                 total, used, free, fragmentation);
+#endif
+}
+
+void setup() {
+  delay(1000);
+
+  Serial.println("--- begin setup");
+  mrbc_init(mempool, MEMSIZE);
+  mrbc_define_method(0, mrbc_class_object, "micros", c_micros);
+  mrbc_define_method(0, mrbc_class_object, "mem_stat", c_mem_stat);
+  if(NULL == mrbc_create_task( code, 0 )){
+    Serial.println("mrbc_create_task error");
+    return;
+  }
+  Serial.println("--- run mruby script");
+  mrbc_run();
+}
+
+void loop() {
+  delay(1000);
+}
@@ -0,0 +1,27 @@
+#
+# Allocation benchmark
+#
+#  Creates and drops many small objects (String, Array, Hash, Range
+#  and instances). Every 16th String is kept alive to make holes in the
+#  heap, then the memory statistics are printed.
+#  Compare with MRBC_SLAB_MAX_SIZE=0 (TLSF only).
+#
+class Foo
+end
+
+N = 2000
+keep = []
+
+t = micros
+i = 0
+while i < N
+  s = "abc" + "def"
+  a = [i, s]
+  h = {i => a}
+  r = (0..i)
+  o = Foo.new
+  keep.push(s) if i % 16 == 0
+  i += 1
+end
+puts "alloc: #{micros - t} us"
+mem_stat
@@ -0,0 +1,57 @@
+/* assembled by hand to match bench_const.rb. (not generated by mrbc)
+   RITE0004 bytecode in big endian order. */
+#include <stdint.h>
+extern const uint8_t code[];
+const uint8_t
+#if defined __GNUC__
+__attribute__((aligned(4)))
+#elif defined _MSC_VER
+__declspec(align(4))
+#endif
+code[] = {
+0x52,0x49,0x54,0x45,0x30,0x30,0x30,0x34,0x49,0x13,0x00,0x00,0x02,0xcd,0x4d,0x41,
+0x54,0x5a,0x30,0x30,0x30,0x30,0x49,0x52,0x45,0x50,0x00,0x00,0x02,0xaf,0x30,0x30,
+0x30,0x30,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x05,0x00,0x01,0x00,0x00,0x00,0x45,
+0x00,0xd3,0x87,0x83,0x00,0x80,0x00,0x12,0x00,0xc0,0x00,0x03,0x00,0x80,0x00,0x92,
+0x00,0xc0,0x00,0x83,0x00,0x80,0x01,0x12,0x00,0xc0,0x01,0x03,0x00,0x80,0x01,0x92,
+0x00,0xc0,0x01,0x83,0x00,0x80,0x02,0x12,0x00,0xc0,0x02,0x03,0x00,0x80,0x02,0x92,
+0x00,0xc0,0x02,0x83,0x00,0x80,0x03,0x12,0x00,0xc0,0x03,0x03,0x00,0x80,0x03,0x92,
+0x00,0xc0,0x03,0x83,0x00,0x80,0x04,0x12,0x00,0xc0,0x04,0x03,0x00,0x80,0x04,0x92,
+0x00,0xc0,0x04,0x83,0x00,0x80,0x05,0x12,0x00,0xc0,0x05,0x03,0x00,0x80,0x05,0x92,
+0x00,0xc0,0x05,0x83,0x00,0x80,0x06,0x12,0x00,0xc0,0x06,0x03,0x00,0x80,0x06,0x92,
+0x00,0xc0,0x06,0x83,0x00,0x80,0x07,0x12,0x00,0xc0,0x07,0x03,0x00,0x80,0x07,0x92,
+0x00,0xc0,0x07,0x83,0x00,0x80,0x08,0x12,0x00,0xc0,0x08,0x03,0x00,0x80,0x08,0x92,
+0x00,0xc0,0x08,0x83,0x00,0x80,0x09,0x12,0x00,0xc0,0x09,0x03,0x00,0x80,0x09,0x92,
+0x00,0xc0,0x09,0x83,0x00,0x80,0x0a,0x12,0x00,0xc0,0x0a,0x03,0x00,0x80,0x0a,0x92,
+0x00,0xc0,0x0a,0x83,0x00,0x80,0x0b,0x12,0x00,0xc0,0x0b,0x03,0x00,0x80,0x0b,0x92,
+0x00,0xbf,0xff,0x83,0x00,0x80,0x0c,0x0a,0x00,0x80,0x00,0x48,0x01,0x00,0x00,0xc0,
+0x00,0x86,0x40,0x46,0x00,0x80,0x00,0x06,0x01,0x00,0x00,0x3d,0x01,0x80,0x00,0x11,
+0x01,0x00,0xc0,0x3e,0x01,0x80,0x00,0xbd,0x01,0x00,0xc0,0x3e,0x01,0x80,0x00,0x06,
+0x01,0x86,0x40,0x20,0x01,0x00,0xc0,0x3e,0x01,0x80,0x01,0x3d,0x01,0x00,0xc0,0x3e,
+0x00,0x86,0x80,0xa0,0x00,0x80,0x00,0x06,0x01,0x00,0x0c,0x09,0x00,0x86,0x80,0xa0,
+0x00,0x00,0x00,0x4a,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x0d,0x20,0x69,
+0x74,0x65,0x72,0x61,0x74,0x69,0x6f,0x6e,0x73,0x3a,0x20,0x00,0x00,0x03,0x20,0x75,
+0x73,0x00,0x00,0x00,0x1b,0x00,0x01,0x4e,0x00,0x00,0x01,0x41,0x00,0x00,0x01,0x42,
+0x00,0x00,0x01,0x43,0x00,0x00,0x01,0x44,0x00,0x00,0x01,0x45,0x00,0x00,0x01,0x46,
+0x00,0x00,0x01,0x47,0x00,0x00,0x01,0x48,0x00,0x00,0x01,0x49,0x00,0x00,0x01,0x4a,
+0x00,0x00,0x01,0x4b,0x00,0x00,0x01,0x4c,0x00,0x00,0x01,0x4d,0x00,0x00,0x01,0x4f,
+0x00,0x00,0x01,0x50,0x00,0x00,0x01,0x51,0x00,0x00,0x01,0x52,0x00,0x00,0x01,0x53,
+0x00,0x00,0x01,0x54,0x00,0x00,0x01,0x55,0x00,0x00,0x01,0x56,0x00,0x00,0x01,0x57,
+0x00,0x00,0x01,0x58,0x00,0x00,0x02,0x24,0x67,0x00,0x00,0x05,0x62,0x65,0x6e,0x63,
+0x68,0x00,0x00,0x04,0x70,0x75,0x74,0x73,0x00,0x00,0x00,0x00,0x00,0x00,0x07,0x00,
+0x0b,0x00,0x00,0x00,0x00,0x00,0x22,0x00,0x00,0x00,0x00,0x26,0x03,0x80,0x00,0x06,
+0x03,0x80,0x00,0x20,0x00,0x81,0xc0,0x01,0x01,0x3f,0xff,0x83,0x03,0x80,0x80,0x01,
+0x04,0x00,0x00,0x91,0x03,0x80,0x80,0xb3,0x03,0xc0,0x0a,0x19,0x03,0x80,0x01,0x91,
+0x04,0x00,0x02,0x11,0x03,0x81,0x40,0xac,0x04,0x00,0x03,0x11,0x03,0x81,0x40,0xac,
+0x04,0x00,0x03,0x91,0x03,0x81,0x40,0xac,0x03,0x80,0x04,0x0a,0x03,0x80,0x04,0x91,
+0x01,0x81,0xc0,0x01,0x03,0x80,0x05,0x11,0x02,0x01,0xc0,0x01,0x03,0x80,0x05,0x91,
+0x02,0x81,0xc0,0x01,0x03,0x80,0x06,0x11,0x03,0x01,0xc0,0x01,0x03,0x80,0x80,0x01,
+0x03,0x81,0x40,0xad,0x01,0x01,0xc0,0x01,0x00,0x3f,0xf4,0x17,0x03,0x80,0x00,0x06,
+0x03,0x80,0x00,0x20,0x04,0x00,0x40,0x01,0x03,0x83,0x40,0xae,0x03,0x80,0x00,0x29,
+0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0e,0x00,0x06,0x6d,0x69,0x63,0x72,0x6f,0x73,
+0x00,0x00,0x01,0x4e,0x00,0x00,0x01,0x3c,0x00,0x00,0x01,0x41,0x00,0x00,0x01,0x48,
+0x00,0x00,0x01,0x2b,0x00,0x00,0x01,0x50,0x00,0x00,0x01,0x58,0x00,0x00,0x02,0x24,
+0x67,0x00,0x00,0x05,0x41,0x72,0x72,0x61,0x79,0x00,0x00,0x04,0x48,0x61,0x73,0x68,
+0x00,0x00,0x06,0x53,0x74,0x72,0x69,0x6e,0x67,0x00,0x00,0x04,0x4d,0x61,0x74,0x68,
+0x00,0x00,0x01,0x2d,0x00,0x45,0x4e,0x44,0x00,0x00,0x00,0x00,0x08,
+};
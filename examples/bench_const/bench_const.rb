@@ -0,0 +1,50 @@
+#
+# Constant lookup benchmark
+#
+#  Reads constants, class names and a global variable in a loop. Each
+#  of them is a lookup of the global or constant table. 24 constants
+#  and 14 built-in classes are stored in the table.
+#  Compare with MRBC_USE_CONST_CACHE 0 in vm_config.h.
+#
+N = 10000
+A = 1
+B = 2
+C = 3
+D = 4
+E = 5
+F = 6
+G = 7
+H = 8
+I = 9
+J = 10
+K = 11
+L = 12
+M = 13
+O = 14
+P = 15
+Q = 16
+R = 17
+S = 18
+T = 19
+U = 20
+V = 21
+W = 22
+X = 23
+$g = 0
+
+def bench
+  t = micros
+  i = 0
+  while i < N
+    $g = A + H + P + X
+    a = Array
+    b = Hash
+    c = String
+    d = Math
+    i += 1
+  end
+  micros - t
+end
+
+puts "#{N} iterations: #{bench} us"
+puts $g
@@ -0,0 +1,55 @@
+/* assembled by hand to match bench_float.rb. (not generated by mrbc)
+   RITE0004 bytecode in big endian order. */
+#include <stdint.h>
+extern const uint8_t code[];
+const uint8_t
+#if defined __GNUC__
+__attribute__((aligned(4)))
+#elif defined _MSC_VER
+__declspec(align(4))
+#endif
+code[] = {
+0x52,0x49,0x54,0x45,0x30,0x30,0x30,0x34,0x0e,0xdf,0x00,0x00,0x02,0xa8,0x4d,0x41,
+0x54,0x5a,0x30,0x30,0x30,0x30,0x49,0x52,0x45,0x50,0x00,0x00,0x02,0x8a,0x30,0x30,
+0x30,0x30,0x00,0x00,0x00,0x00,0x00,0x11,0x00,0x18,0x00,0x00,0x00,0x00,0x00,0x72,
+0x08,0xd3,0x87,0x83,0x08,0x80,0x00,0x12,0x08,0x80,0x00,0x06,0x08,0x80,0x40,0x20,
+0x00,0x84,0x40,0x01,0x01,0x80,0x00,0x02,0x02,0x00,0x00,0x82,0x02,0x80,0x01,0x02,
+0x03,0x00,0x01,0x82,0x03,0x80,0x02,0x02,0x04,0x00,0x02,0x82,0x04,0x80,0x03,0x02,
+0x05,0x00,0x03,0x82,0x01,0x3f,0xff,0x83,0x00,0x40,0x13,0x17,0x08,0x81,0xc0,0x01,
+0x09,0x02,0x00,0x01,0x08,0x80,0x80,0xae,0x05,0x84,0x40,0x01,0x08,0x82,0x40,0x01,
+0x09,0x02,0xc0,0x01,0x09,0x81,0x80,0x01,0x09,0x00,0xc0,0xb0,0x08,0x81,0x00,0xac,
+0x04,0x84,0x40,0x01,0x08,0x82,0xc0,0x01,0x09,0x02,0x80,0x01,0x08,0x80,0x80,0xae,
+0x09,0x01,0x80,0x01,0x08,0x81,0x40,0xb1,0x06,0x04,0x40,0x01,0x08,0x80,0xc0,0x01,
+0x09,0x02,0xc0,0x01,0x08,0x80,0xc0,0xb0,0x09,0x01,0x00,0x01,0x09,0x82,0x40,0x01,
+0x09,0x00,0xc0,0xb0,0x08,0x81,0x00,0xac,0x09,0x01,0x40,0x01,0x09,0x83,0x00,0x01,
+0x09,0x00,0xc0,0xb0,0x08,0x81,0x00,0xac,0x06,0x84,0x40,0x01,0x05,0x02,0xc0,0x01,
+0x08,0x82,0x00,0x01,0x09,0x03,0x40,0x01,0x09,0x81,0x80,0x01,0x09,0x00,0xc0,0xb0,
+0x08,0x81,0x00,0xac,0x04,0x04,0x40,0x01,0x08,0x80,0x80,0x01,0x08,0x81,0x00,0xad,
+0x01,0x04,0x40,0x01,0x08,0x80,0x80,0x01,0x09,0x00,0x00,0x11,0x08,0x81,0x80,0xb3,
+0x08,0xbf,0xeb,0x18,0x08,0x80,0x00,0x06,0x09,0x00,0x04,0x3d,0x09,0x80,0x00,0x06,
+0x09,0x80,0x40,0x20,0x0a,0x00,0x40,0x01,0x09,0x80,0x80,0xae,0x09,0x04,0xc0,0x3e,
+0x09,0x80,0x04,0xbd,0x09,0x04,0xc0,0x3e,0x08,0x81,0xc0,0xa0,0x08,0x80,0x00,0x06,
+0x09,0x00,0x05,0x3d,0x09,0x82,0x00,0x01,0x09,0x04,0xc0,0x3e,0x08,0x81,0xc0,0xa0,
+0x08,0x80,0x00,0x06,0x08,0x80,0x40,0x20,0x00,0x84,0x40,0x01,0x07,0x00,0x05,0x82,
+0x07,0x80,0x06,0x02,0x08,0x00,0x06,0x82,0x01,0x3f,0xff,0x83,0x00,0x40,0x07,0x17,
+0x08,0x83,0xc0,0x01,0x09,0x03,0x80,0x01,0x09,0x84,0x00,0x01,0x0a,0x03,0xc0,0x01,
+0x09,0x80,0x80,0xae,0x09,0x00,0xc0,0xb0,0x08,0x81,0x00,0xac,0x07,0x84,0x40,0x01,
+0x08,0x84,0x00,0x01,0x08,0x82,0x00,0x20,0x08,0x04,0x40,0x01,0x08,0x80,0x80,0x01,
+0x08,0x81,0x00,0xad,0x01,0x04,0x40,0x01,0x08,0x80,0x80,0x01,0x09,0x00,0x00,0x11,
+0x08,0x81,0x80,0xb3,0x08,0xbf,0xf7,0x18,0x08,0x80,0x00,0x06,0x09,0x00,0x07,0x3d,
+0x09,0x80,0x00,0x06,0x09,0x80,0x40,0x20,0x0a,0x00,0x40,0x01,0x09,0x80,0x80,0xae,
+0x09,0x04,0xc0,0x3e,0x09,0x80,0x07,0xbd,0x09,0x04,0xc0,0x3e,0x08,0x81,0xc0,0xa0,
+0x08,0x80,0x00,0x06,0x09,0x00,0x08,0x3d,0x09,0x83,0xc0,0x01,0x09,0x04,0xc0,0x3e,
+0x08,0x81,0xc0,0xa0,0x00,0x00,0x00,0x4a,0x00,0x00,0x00,0x11,0x02,0x00,0x03,0x31,
+0x2e,0x32,0x02,0x00,0x03,0x30,0x2e,0x35,0x02,0x00,0x04,0x30,0x2e,0x30,0x35,0x02,
+0x00,0x04,0x30,0x2e,0x30,0x31,0x02,0x00,0x05,0x31,0x30,0x30,0x2e,0x30,0x02,0x00,
+0x03,0x30,0x2e,0x30,0x02,0x00,0x03,0x30,0x2e,0x30,0x02,0x00,0x03,0x30,0x2e,0x30,
+0x00,0x00,0x05,0x70,0x69,0x64,0x3a,0x20,0x00,0x00,0x03,0x20,0x75,0x73,0x00,0x00,
+0x06,0x20,0x70,0x76,0x20,0x3d,0x20,0x02,0x00,0x03,0x30,0x2e,0x31,0x02,0x00,0x03,
+0x30,0x2e,0x30,0x02,0x00,0x03,0x31,0x2e,0x30,0x00,0x00,0x05,0x69,0x69,0x72,0x3a,
+0x20,0x00,0x00,0x03,0x20,0x75,0x73,0x00,0x00,0x05,0x20,0x79,0x20,0x3d,0x20,0x00,
+0x00,0x00,0x09,0x00,0x01,0x4e,0x00,0x00,0x06,0x6d,0x69,0x63,0x72,0x6f,0x73,0x00,
+0x00,0x01,0x2d,0x00,0x00,0x01,0x2a,0x00,0x00,0x01,0x2b,0x00,0x00,0x01,0x2f,0x00,
+0x00,0x01,0x3c,0x00,0x00,0x04,0x70,0x75,0x74,0x73,0x00,0x00,0x02,0x2d,0x40,0x00,
+0x45,0x4e,0x44,0x00,0x00,0x00,0x00,0x08,
+};
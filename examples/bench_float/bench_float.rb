@@ -0,0 +1,44 @@
+#
+# Float benchmark (PID loop and low pass filter)
+#
+#  Run this sketch twice, with MRBC_FLOAT_TYPE MRBC_FLOAT_DOUBLE and
+#  MRBC_FLOAT_SINGLE in vm_config.h, and compare the results.
+#
+N = 10000
+
+# PID controller
+t = micros
+kp = 1.2
+ki = 0.5
+kd = 0.05
+dt = 0.01
+target = 100.0
+pv = 0.0
+integral = 0.0
+prev = 0.0
+i = 0
+while i < N
+  err = target - pv
+  integral += err * dt
+  deriv = (err - prev) / dt
+  out = kp * err + ki * integral + kd * deriv
+  prev = err
+  pv += out * dt
+  i += 1
+end
+puts "pid: #{micros - t} us"
+puts " pv = #{pv}"
+
+# 1st order IIR low pass filter
+t = micros
+alpha = 0.1
+y = 0.0
+x = 1.0
+i = 0
+while i < N
+  y += alpha * (x - y)
+  x = -x
+  i += 1
+end
+puts "iir: #{micros - t} us"
+puts " y = #{y}"
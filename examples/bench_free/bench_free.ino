@@ -0,0 +1,37 @@
+#include <mrubyc_for_ESP32_Arduino.h>
+
+extern const uint8_t code[];
+
+#define MEMSIZE (1024*30)
+static uint8_t mempool[MEMSIZE];
+
+// micros() for ruby script.
+static void c_micros(mrb_vm *vm, mrb_value *v, int argc)
+{
+  SET_INT_RETURN(micros());
+}
+
+// enable or disable deferred release.
+static void c_deferred_free(mrb_vm *vm, mrb_value *v, int argc)
+{
+  mrbc_set_deferred_free(GET_INT_ARG(1));
+}
+
+void setup() {
+  delay(1000);
+
+  Serial.println("--- begin setup");
+  mrbc_init(mempool, MEMSIZE);
+  mrbc_define_method(0, mrbc_class_object, "micros", c_micros);
+  mrbc_define_method(0, mrbc_class_object, "deferred_free", c_deferred_free);
+  if(NULL == mrbc_create_task( code, 0 )){
+    Serial.println("mrbc_create_task error");
+    return;
+  }
+  Serial.println("--- run mruby script");
+  mrbc_run();
+}
+
+void loop() {
+  delay(1000);
+}
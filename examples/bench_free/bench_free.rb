@@ -0,0 +1,31 @@
+#
+# Deferred release benchmark
+#
+#  Builds an array of W small arrays and drops it, and measures the
+#  longest pause between the iterations. Without deferred release,
+#  dropping the last reference frees all of the W arrays at once.
+#
+N = 1000
+W = 100
+
+def bench
+  big = []
+  worst = 0
+  last = micros
+  i = 0
+  while i < N
+    big.push([i, "x"])
+    big = [] if big.size >= W
+    now = micros
+    gap = now - last
+    worst = gap if gap > worst
+    last = now
+    i += 1
+  end
+  worst
+end
+
+deferred_free 0
+puts "immediate release, worst pause: #{bench} us"
+deferred_free 1
+puts "deferred release, worst pause: #{bench} us"
@@ -0,0 +1,90 @@
+/*
+  Array and Hash growth benchmark.
+
+  Pushes N elements to empty containers, and prints the time and
+  the peak heap usage. Compare the default geometric growth with
+  MRBC_GROWTH_RATE 100 and MRBC_GROWTH_MIN 6 in vm_config.h (the former
+  constant growth), and with the buffer reserved beforehand.
+*/
+#include <mrubyc_for_ESP32_Arduino.h>
+
+#define MEMSIZE (1024*60)
+static uint8_t mempool[MEMSIZE];
+
+// push n integers to each of two arrays alternately, so that a buffer
+// can not be extended in place. returns the peak heap usage.
+static int push_array(int n, int reserve)
+{
+  int peak = 0;
+  mrb_value ary1 = mrbc_array_new(NULL, 0);
+  mrb_value ary2 = mrbc_array_new(NULL, 0);
+  if( reserve ) {
+    mrbc_array_reserve(&ary1, n);
+    mrbc_array_reserve(&ary2, n);
+  }
+
+  int i;
+  for( i = 0; i < n; i++ ) {
+    mrb_value v = mrb_fixnum_value(i);
+    if( mrbc_array_push(&ary1, &v) != 0 ) break;
+    if( mrbc_array_push(&ary2, &v) != 0 ) break;
+    int used = mrbc_alloc_vm_used(0);
+    if( peak < used ) peak = used;
+  }
+  mrbc_release(&ary1);
+  mrbc_release(&ary2);
+
+  return peak;
+}
+
+// set n integer keys to the hash, and returns the peak heap usage.
+static int set_hash(int n, int reserve)
+{
+  int peak = 0;
+  mrb_value hash = mrbc_hash_new(NULL, 0);
+  if( reserve ) mrbc_hash_reserve(&hash, n);
+
+  int i;
+  for( i = 0; i < n; i++ ) {
+    mrb_value k = mrb_fixnum_value(i);
+    mrb_value v = mrb_fixnum_value(i);
+    if( mrbc_hash_set(&hash, &k, &v) != 0 ) break;
+    int used = mrbc_alloc_vm_used(0);
+    if( peak < used ) peak = used;
+  }
+  mrbc_release(&hash);
+
+  return peak;
+}
+
+static void run(const char *name, int (*func)(int, int), int n, int reserve)
+{
+  int base = mrbc_alloc_vm_used(0);
+
+  uint32_t t = micros();
+  int peak = func(n, reserve);
+  t = micros() - t;
+
+  Serial.printf("%-5s n %5d  reserve %d  %6u us  peak %6d bytes\n",
+		name, n, reserve, (unsigned)t, peak - base);
+}
+
+void setup() {
+  delay(1000);
+
+  mrbc_init(mempool, MEMSIZE);
+
+  Serial.printf("--- growth rate %d%%, min %d\n",
+		MRBC_GROWTH_RATE, MRBC_GROWTH_MIN);
+  run("Array", push_array, 100, 0);
+  run("Array", push_array, 1000, 0);
+  run("Array", push_array, 1000, 1);
+  run("Hash", set_hash, 100, 0);
+  run("Hash", set_hash, 500, 0);
+  run("Hash", set_hash, 500, 1);
+  Serial.println("--- end");
+}
+
+void loop() {
+  delay(1000);
+}
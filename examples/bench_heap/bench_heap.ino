@@ -0,0 +1,75 @@
+/*
+  Large heap stress benchmark.
+
+  Runs random alloc/free traces on a multi-megabyte memory pool in
+  PSRAM, and prints the average time per operation for each working
+  set. The time should stay flat as the heap grows.
+
+  Set MRBC_ALLOC_LARGE_HEAP to 1 in vm_config.h, and enable PSRAM.
+*/
+#include <mrubyc_for_ESP32_Arduino.h>
+
+#define MEMSIZE  (1024*1024*3)
+#define MAX_PTRS 4096
+#define N_OPS    100000
+
+static void *ptrs[MAX_PTRS];
+static uint32_t seed = 1;
+
+static uint32_t rnd(void)
+{
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+// keep n_live objects of 1..max_size bytes, and replace one at random.
+static void run_trace(int n_live, uint32_t max_size)
+{
+  int i;
+  for( i = 0; i < n_live; i++ ) {
+    ptrs[i] = mrbc_raw_alloc(rnd() % max_size + 1);
+  }
+
+  uint32_t t = micros();
+  for( i = 0; i < N_OPS; i++ ) {
+    int n = rnd() % n_live;
+    if( ptrs[n] ) mrbc_raw_free(ptrs[n]);
+    ptrs[n] = mrbc_raw_alloc(rnd() % max_size + 1);
+  }
+  t = micros() - t;
+
+  int fail = 0;
+  for( i = 0; i < n_live; i++ ) {
+    if( ptrs[i] ) mrbc_raw_free(ptrs[i]); else fail++;
+  }
+
+  Serial.printf("live %4d  size 1-%-5u  %4u ns/op  (alloc failed %d)\n",
+		n_live, max_size, (unsigned)(t * 1000ULL / N_OPS), fail);
+}
+
+void setup() {
+  delay(1000);
+
+#if !MRBC_ALLOC_LARGE_HEAP
+  Serial.println("MRBC_ALLOC_LARGE_HEAP is not set.");
+  return;
+#endif
+  uint8_t *mempool = (uint8_t *)ps_malloc(MEMSIZE);
+  if( mempool == NULL ) {
+    Serial.println("ps_malloc error");
+    return;
+  }
+  mrbc_init_alloc(mempool, MEMSIZE);
+
+  Serial.println("--- begin heap stress");
+  run_trace(64, 2048);		// ~64KB
+  run_trace(256, 2048);		// ~256KB
+  run_trace(1024, 2048);	// ~1MB
+  run_trace(2048, 2048);	// ~2MB
+  run_trace(4096, 64);		// small objects
+  Serial.println("--- end");
+}
+
+void loop() {
+  delay(1000);
+}
@@ -0,0 +1,54 @@
+/* assembled by hand to match bench_iter.rb. (not generated by mrbc)
+   RITE0004 bytecode in big endian order. */
+#include <stdint.h>
+extern const uint8_t code[];
+const uint8_t
+#if defined __GNUC__
+__attribute__((aligned(4)))
+#elif defined _MSC_VER
+__declspec(align(4))
+#endif
+code[] = {
+0x52,0x49,0x54,0x45,0x30,0x30,0x30,0x34,0x19,0x3c,0x00,0x00,0x02,0x94,0x4d,0x41,
+0x54,0x5a,0x30,0x30,0x30,0x30,0x49,0x52,0x45,0x50,0x00,0x00,0x02,0x76,0x30,0x30,
+0x30,0x30,0x00,0x00,0x00,0x00,0x00,0x06,0x00,0x0c,0x00,0x03,0x00,0x00,0x00,0x51,
+0x03,0x53,0x87,0x83,0x03,0x00,0x00,0x12,0x03,0x01,0x80,0x37,0x01,0x01,0x80,0x01,
+0x01,0xbf,0xff,0x83,0x00,0x40,0x03,0x17,0x03,0x00,0x80,0x01,0x03,0x80,0xc0,0x01,
+0x03,0x00,0x40,0xa0,0x03,0x00,0xc0,0x01,0x03,0x00,0x80,0xad,0x01,0x81,0x80,0x01,
+0x03,0x00,0xc0,0x01,0x03,0xc0,0x31,0x83,0x03,0x00,0xc0,0xb3,0x03,0x3f,0xfb,0x18,
+0x03,0x00,0x00,0x06,0x03,0x01,0x00,0x20,0x00,0x81,0x80,0x01,0x02,0x3f,0xff,0x83,
+0x03,0x00,0x00,0x11,0x03,0x80,0x01,0x40,0x03,0x01,0x40,0x21,0x03,0x00,0x00,0x06,
+0x03,0x80,0x00,0x3d,0x04,0x00,0x00,0x06,0x04,0x01,0x00,0x20,0x04,0x80,0x40,0x01,
+0x04,0x01,0x80,0xae,0x03,0x82,0x00,0x3e,0x04,0x00,0x00,0xbd,0x03,0x82,0x00,0x3e,
+0x03,0x01,0xc0,0xa0,0x03,0x00,0x00,0x06,0x03,0x01,0x00,0x20,0x00,0x81,0x80,0x01,
+0x02,0x3f,0xff,0x83,0x02,0xbf,0xff,0x83,0x00,0x40,0x03,0x17,0x03,0x00,0x80,0x01,
+0x03,0x80,0x03,0x40,0x03,0x02,0x00,0x21,0x03,0x01,0x40,0x01,0x03,0x00,0x80,0xad,
+0x02,0x81,0x80,0x01,0x03,0x01,0x40,0x01,0x03,0x80,0x00,0x11,0x04,0x40,0x31,0x83,
+0x03,0x82,0x40,0xb1,0x03,0x00,0xc0,0xb3,0x03,0x3f,0xfa,0x18,0x03,0x00,0x00,0x06,
+0x03,0x80,0x01,0x3d,0x04,0x00,0x00,0x06,0x04,0x01,0x00,0x20,0x04,0x80,0x40,0x01,
+0x04,0x01,0x80,0xae,0x03,0x82,0x00,0x3e,0x04,0x00,0x01,0xbd,0x03,0x82,0x00,0x3e,
+0x03,0x01,0xc0,0xa0,0x03,0x00,0x00,0x06,0x03,0x01,0x00,0x20,0x00,0x81,0x80,0x01,
+0x02,0x3f,0xff,0x83,0x03,0x3f,0xff,0x83,0x03,0x80,0x00,0x11,0x03,0x01,0x80,0xc1,
+0x03,0x80,0x05,0x40,0x03,0x02,0x00,0x21,0x03,0x00,0x00,0x06,0x03,0x80,0x02,0x3d,
+0x04,0x00,0x00,0x06,0x04,0x01,0x00,0x20,0x04,0x80,0x40,0x01,0x04,0x01,0x80,0xae,
+0x03,0x82,0x00,0x3e,0x04,0x00,0x02,0xbd,0x03,0x82,0x00,0x3e,0x03,0x01,0xc0,0xa0,
+0x00,0x00,0x00,0x4a,0x00,0x00,0x00,0x06,0x00,0x00,0x07,0x74,0x69,0x6d,0x65,0x73,
+0x3a,0x20,0x00,0x00,0x03,0x20,0x75,0x73,0x00,0x00,0x0c,0x41,0x72,0x72,0x61,0x79,
+0x23,0x65,0x61,0x63,0x68,0x3a,0x20,0x00,0x00,0x03,0x20,0x75,0x73,0x00,0x00,0x0c,
+0x52,0x61,0x6e,0x67,0x65,0x23,0x65,0x61,0x63,0x68,0x3a,0x20,0x00,0x00,0x03,0x20,
+0x75,0x73,0x00,0x00,0x00,0x0a,0x00,0x01,0x4e,0x00,0x00,0x04,0x70,0x75,0x73,0x68,
+0x00,0x00,0x01,0x2b,0x00,0x00,0x01,0x3c,0x00,0x00,0x06,0x6d,0x69,0x63,0x72,0x6f,
+0x73,0x00,0x00,0x05,0x74,0x69,0x6d,0x65,0x73,0x00,0x00,0x01,0x2d,0x00,0x00,0x04,
+0x70,0x75,0x74,0x73,0x00,0x00,0x04,0x65,0x61,0x63,0x68,0x00,0x00,0x01,0x2f,0x00,
+0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x05,0x00,0x00,0x00,0x00,0x00,0x06,0x00,0x00,
+0x02,0x00,0x00,0x26,0x01,0x01,0x00,0x15,0x01,0x80,0x40,0x01,0x01,0x00,0x00,0xac,
+0x01,0x01,0x00,0x16,0x01,0x00,0x00,0x29,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,
+0x00,0x01,0x2b,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x05,0x00,0x00,0x00,0x00,
+0x00,0x06,0x00,0x00,0x02,0x00,0x00,0x26,0x01,0x01,0x00,0x15,0x01,0x80,0x40,0x01,
+0x01,0x00,0x00,0xac,0x01,0x01,0x00,0x16,0x01,0x00,0x00,0x29,0x00,0x00,0x00,0x00,
+0x00,0x00,0x00,0x01,0x00,0x01,0x2b,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x05,
+0x00,0x00,0x00,0x00,0x00,0x06,0x00,0x00,0x02,0x00,0x00,0x26,0x01,0x01,0x00,0x15,
+0x01,0x80,0x40,0x01,0x01,0x00,0x00,0xac,0x01,0x01,0x00,0x16,0x01,0x00,0x00,0x29,
+0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x01,0x2b,0x00,0x45,0x4e,0x44,0x00,
+0x00,0x00,0x00,0x08,
+};
@@ -0,0 +1,33 @@
+#
+# Iteration (block call) benchmark
+#
+#  Integer#times, Array#each and Range#each call the block
+#  through mrbc_yield().
+#
+N = 10000
+
+a = []
+i = 0
+while i < 100
+  a.push(i)
+  i += 1
+end
+
+t = micros
+s = 0
+N.times {|i| s += i }
+puts "times: #{micros - t} us"
+
+t = micros
+s = 0
+j = 0
+while j < N / 100
+  a.each {|x| s += x }
+  j += 1
+end
+puts "Array#each: #{micros - t} us"
+
+t = micros
+s = 0
+(0...N).each {|i| s += i }
+puts "Range#each: #{micros - t} us"
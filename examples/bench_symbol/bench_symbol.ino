@@ -0,0 +1,90 @@
+/*
+  Symbol table benchmark.
+
+  Interns 200, 2,000 and 20,000 symbols in addition to the built-in
+  ones, and prints the time of the lookups of the existing names and of
+  the names not in the table, and the heap used by the symbols.
+  Compare with MRBC_SYMBOL_SEARCH_LINER defined in vm_config.h.
+  20,000 symbols need about 400KB of heap. On a board with PSRAM, set
+  MRBC_ALLOC_LARGE_HEAP to 1, and the PSRAM is added as a region.
+*/
+#include <mrubyc_for_ESP32_Arduino.h>
+
+#define MEMSIZE (1024*40)
+static uint8_t mempool[MEMSIZE];
+
+#define NAME_SIZE 12
+#define LOOKUPS 20000
+static mrb_sym first_id = -1;	// symbol id of the first name.
+static int n_names;
+
+static void make_name(char *buf, int i)
+{
+  sprintf(buf, "sym_%05d", i);
+}
+
+// intern the names up to n. the names are copied to the heap.
+static int intern(int n)
+{
+  char buf[NAME_SIZE];
+  for( ; n_names < n; n_names++ ) {
+    make_name(buf, n_names);
+    mrb_sym sym_id = mrbc_symbol(mrbc_symbol_new(NULL, buf));
+    if( sym_id < 0 ) return -1;
+    if( first_id < 0 ) first_id = sym_id;
+  }
+  return 0;
+}
+
+static void run(int n)
+{
+  static int used;
+  int base = mrbc_alloc_vm_used(0);
+  if( intern(n) != 0 ) {
+    Serial.printf("n %5d  overflow. see MAX_SYMBOLS_COUNT and the heap\n", n);
+    return;
+  }
+  used += mrbc_alloc_vm_used(0) - base;
+
+  // lookup the existing names in a scattered order.
+  uint32_t t = micros();
+  int i;
+  for( i = 0; i < LOOKUPS; i++ ) {
+    str_to_symid( symid_to_str(first_id + i * 7919 % n) );
+  }
+  uint32_t t_hit = micros() - t;
+
+  // lookup the names not in the table.
+  static char miss[64][NAME_SIZE];
+  for( i = 0; i < 64; i++ ) {
+    make_name(miss[i], i * 7919 % n);
+    miss[i][0] = 'x';
+  }
+  t = micros();
+  for( i = 0; i < LOOKUPS; i++ ) {
+    mrbc_search_symid( miss[i % 64] );
+  }
+  uint32_t t_miss = micros() - t;
+
+  Serial.printf("n %5d  hit %6u us  miss %6u us  heap %6d bytes\n",
+		n, (unsigned)t_hit, (unsigned)t_miss, used);
+}
+
+void setup() {
+  delay(1000);
+
+  mrbc_init(mempool, MEMSIZE);
+#if defined(BOARD_HAS_PSRAM) && MRBC_ALLOC_LARGE_HEAP
+  mrbc_add_alloc_region(ps_malloc(1024*1024), 1024*1024, MRBC_ALLOC_SLOW);
+#endif
+
+  Serial.printf("--- symbol lookup (%d lookups each)\n", LOOKUPS);
+  run(200);
+  run(2000);
+  run(20000);
+  Serial.println("--- end");
+}
+
+void loop() {
+  delay(1000);
+}
@@ -0,0 +1,79 @@
+/* assembled by hand to match bench_vm.rb. (not generated by mrbc)
+   RITE0004 bytecode in big endian order. */
+#include <stdint.h>
+extern const uint8_t code[];
+const uint8_t
+#if defined __GNUC__
+__attribute__((aligned(4)))
+#elif defined _MSC_VER
+__declspec(align(4))
+#endif
+code[] = {
+0x52,0x49,0x54,0x45,0x30,0x30,0x30,0x34,0xcb,0xea,0x00,0x00,0x04,0x29,0x4d,0x41,
+0x54,0x5a,0x30,0x30,0x30,0x30,0x49,0x52,0x45,0x50,0x00,0x00,0x04,0x0b,0x30,0x30,
+0x30,0x30,0x00,0x00,0x00,0x00,0x00,0x05,0x00,0x0a,0x00,0x02,0x00,0x00,0x00,0x9f,
+0x02,0xd3,0x87,0x83,0x02,0x80,0x00,0x12,0x02,0x80,0x00,0x48,0x03,0x00,0x00,0xc0,
+0x02,0x80,0x40,0x46,0x02,0x80,0x00,0x05,0x03,0x00,0x00,0x05,0x02,0x80,0x80,0x43,
+0x02,0x80,0x00,0xc5,0x02,0x80,0x01,0x11,0x02,0x80,0xc0,0x20,0x02,0x01,0x40,0x01,
+0x02,0x80,0x00,0x06,0x02,0x81,0x00,0x20,0x00,0x81,0x40,0x01,0x01,0x3f,0xff,0x83,
+0x00,0x40,0x01,0x97,0x02,0x80,0x80,0x01,0x02,0x81,0x40,0xad,0x01,0x01,0x40,0x01,
+0x02,0x80,0x80,0x01,0x03,0x00,0x00,0x11,0x02,0x81,0x80,0xb3,0x02,0xbf,0xfc,0x98,
+0x02,0x80,0x00,0x06,0x03,0x00,0x00,0x3d,0x03,0x80,0x00,0x06,0x03,0x81,0x00,0x20,
+0x04,0x00,0x40,0x01,0x03,0x81,0xc0,0xae,0x03,0x01,0xc0,0x3e,0x03,0x80,0x00,0xbd,
+0x03,0x01,0xc0,0x3e,0x02,0x82,0x00,0xa0,0x02,0x80,0x00,0x06,0x02,0x81,0x00,0x20,
+0x00,0x81,0x40,0x01,0x01,0x3f,0xff,0x83,0x00,0x40,0x02,0x17,0x01,0x80,0x80,0x01,
+0x02,0x80,0x80,0x01,0x02,0x81,0x40,0xad,0x01,0x01,0x40,0x01,0x02,0x80,0x80,0x01,
+0x03,0x00,0x00,0x11,0x02,0x81,0x80,0xb3,0x02,0xbf,0xfc,0x18,0x02,0x80,0x00,0x06,
+0x03,0x00,0x01,0x3d,0x03,0x80,0x00,0x06,0x03,0x81,0x00,0x20,0x04,0x00,0x40,0x01,
+0x03,0x81,0xc0,0xae,0x03,0x01,0xc0,0x3e,0x03,0x80,0x01,0xbd,0x03,0x01,0xc0,0x3e,
+0x02,0x82,0x00,0xa0,0x02,0x80,0x00,0x06,0x02,0x81,0x00,0x20,0x00,0x81,0x40,0x01,
+0x01,0x3f,0xff,0x83,0x00,0x40,0x04,0x17,0x02,0x80,0x80,0x01,0x03,0x40,0x00,0x83,
+0x02,0x82,0x40,0xb0,0x02,0x81,0x40,0xad,0x01,0x81,0x40,0x01,0x02,0x80,0x80,0x01,
+0x02,0x81,0x40,0xad,0x01,0x01,0x40,0x01,0x02,0x80,0x80,0x01,0x03,0x00,0x00,0x11,
+0x02,0x81,0x80,0xb3,0x02,0xbf,0xfa,0x18,0x02,0x80,0x00,0x06,0x03,0x00,0x02,0x3d,
+0x03,0x80,0x00,0x06,0x03,0x81,0x00,0x20,0x04,0x00,0x40,0x01,0x03,0x81,0xc0,0xae,
+0x03,0x01,0xc0,0x3e,0x03,0x80,0x02,0xbd,0x03,0x01,0xc0,0x3e,0x02,0x82,0x00,0xa0,
+0x02,0x80,0x00,0x06,0x02,0x81,0x00,0x20,0x00,0x81,0x40,0x01,0x01,0x3f,0xff,0x83,
+0x00,0x40,0x03,0x97,0x02,0x80,0x80,0x01,0x03,0x49,0xc3,0x83,0x02,0x81,0x80,0xb3,
+0x01,0x81,0x40,0x01,0x02,0x80,0x80,0x01,0x02,0x81,0x40,0xad,0x01,0x01,0x40,0x01,
+0x02,0x80,0x80,0x01,0x03,0x00,0x00,0x11,0x02,0x81,0x80,0xb3,0x02,0xbf,0xfa,0x98,
+0x02,0x80,0x00,0x06,0x03,0x00,0x03,0x3d,0x03,0x80,0x00,0x06,0x03,0x81,0x00,0x20,
+0x04,0x00,0x40,0x01,0x03,0x81,0xc0,0xae,0x03,0x01,0xc0,0x3e,0x03,0x80,0x03,0xbd,
+0x03,0x01,0xc0,0x3e,0x02,0x82,0x00,0xa0,0x02,0x80,0x00,0x06,0x02,0x81,0x00,0x20,
+0x00,0x81,0x40,0x01,0x01,0x3f,0xff,0x83,0x00,0x40,0x02,0x97,0x02,0x80,0x00,0x06,
+0x02,0x80,0x40,0x20,0x02,0x80,0x80,0x01,0x02,0x81,0x40,0xad,0x01,0x01,0x40,0x01,
+0x02,0x80,0x80,0x01,0x03,0x00,0x00,0x11,0x02,0x81,0x80,0xb3,0x02,0xbf,0xfb,0x98,
+0x02,0x80,0x00,0x06,0x03,0x00,0x04,0x3d,0x03,0x80,0x00,0x06,0x03,0x81,0x00,0x20,
+0x04,0x00,0x40,0x01,0x03,0x81,0xc0,0xae,0x03,0x01,0xc0,0x3e,0x03,0x80,0x04,0xbd,
+0x03,0x01,0xc0,0x3e,0x02,0x82,0x00,0xa0,0x02,0x80,0x00,0x06,0x02,0x81,0x00,0x20,
+0x00,0x81,0x40,0x01,0x01,0x3f,0xff,0x83,0x00,0x40,0x02,0x97,0x02,0x81,0x00,0x01,
+0x02,0x82,0x80,0x20,0x02,0x80,0x80,0x01,0x02,0x81,0x40,0xad,0x01,0x01,0x40,0x01,
+0x02,0x80,0x80,0x01,0x03,0x00,0x00,0x11,0x02,0x81,0x80,0xb3,0x02,0xbf,0xfb,0x98,
+0x02,0x80,0x00,0x06,0x03,0x00,0x05,0x3d,0x03,0x80,0x00,0x06,0x03,0x81,0x00,0x20,
+0x04,0x00,0x40,0x01,0x03,0x81,0xc0,0xae,0x03,0x01,0xc0,0x3e,0x03,0x80,0x05,0xbd,
+0x03,0x01,0xc0,0x3e,0x02,0x82,0x00,0xa0,0x00,0x00,0x00,0x4a,0x00,0x00,0x00,0x0c,
+0x00,0x00,0x06,0x6c,0x6f,0x6f,0x70,0x3a,0x20,0x00,0x00,0x03,0x20,0x75,0x73,0x00,
+0x00,0x06,0x6d,0x6f,0x76,0x65,0x3a,0x20,0x00,0x00,0x03,0x20,0x75,0x73,0x00,0x00,
+0x07,0x61,0x72,0x69,0x74,0x68,0x3a,0x20,0x00,0x00,0x03,0x20,0x75,0x73,0x00,0x00,
+0x09,0x63,0x6f,0x6d,0x70,0x61,0x72,0x65,0x3a,0x20,0x00,0x00,0x03,0x20,0x75,0x73,
+0x00,0x00,0x06,0x73,0x65,0x6e,0x64,0x3a,0x20,0x00,0x00,0x03,0x20,0x75,0x73,0x00,
+0x00,0x06,0x69,0x76,0x61,0x72,0x3a,0x20,0x00,0x00,0x03,0x20,0x75,0x73,0x00,0x00,
+0x00,0x0b,0x00,0x01,0x4e,0x00,0x00,0x03,0x66,0x6f,0x6f,0x00,0x00,0x07,0x43,0x6f,
+0x75,0x6e,0x74,0x65,0x72,0x00,0x00,0x03,0x6e,0x65,0x77,0x00,0x00,0x06,0x6d,0x69,
+0x63,0x72,0x6f,0x73,0x00,0x00,0x01,0x2b,0x00,0x00,0x01,0x3c,0x00,0x00,0x01,0x2d,
+0x00,0x00,0x04,0x70,0x75,0x74,0x73,0x00,0x00,0x01,0x2a,0x00,0x00,0x03,0x69,0x6e,
+0x63,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x03,
+0x00,0x00,0x00,0x26,0x00,0x80,0x00,0x05,0x00,0x80,0x00,0x29,0x00,0x00,0x00,0x00,
+0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x03,0x00,0x02,0x00,0x00,
+0x00,0x08,0x00,0x00,0x00,0x80,0x00,0x48,0x01,0x00,0x00,0xc0,0x00,0x80,0x00,0x46,
+0x00,0x80,0x00,0x48,0x01,0x00,0x02,0xc0,0x00,0x80,0x40,0x46,0x00,0x80,0x00,0x84,
+0x00,0x80,0x00,0x29,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x0a,0x69,0x6e,
+0x69,0x74,0x69,0x61,0x6c,0x69,0x7a,0x65,0x00,0x00,0x03,0x69,0x6e,0x63,0x00,0x00,
+0x00,0x00,0x00,0x00,0x02,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x04,0x00,0x00,0x00,
+0x00,0x00,0x00,0x26,0x00,0xbf,0xff,0x83,0x00,0x80,0x00,0x0e,0x00,0x80,0x00,0x29,
+0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x02,0x40,0x6e,0x00,0x00,0x00,0x00,
+0x00,0x00,0x02,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x05,0x00,0x00,0x00,0x00,0x26,
+0x00,0x80,0x00,0x0d,0x00,0x80,0x40,0xad,0x00,0x80,0x00,0x0e,0x00,0x80,0x00,0x29,
+0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x02,0x40,0x6e,0x00,0x00,0x01,0x2b,
+0x00,0x45,0x4e,0x44,0x00,0x00,0x00,0x00,0x08,
+};
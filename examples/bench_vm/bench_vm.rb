@@ -0,0 +1,74 @@
+#
+# mruby/c VM dispatch benchmark
+#
+#  Run this sketch twice, with MRBC_USE_THREADED_CODE 0 and 1
+#  in vm_config.h, and compare the results.
+#
+#  Result on a host PC (x86-64, gcc -O2, MRBC_NO_TIMER, best of 15 runs)
+#               loop  move  arith  compare  send  ivar  (us)
+#    switch      581   685    995      930  1192  1495
+#    threaded    462   492    730      683   930  1219
+#
+N = 10000
+
+def foo
+end
+
+class Counter
+  def initialize
+    @n = 0
+  end
+
+  def inc
+    @n += 1
+  end
+end
+
+c = Counter.new
+
+t = micros
+i = 0
+while i < N
+  i += 1
+end
+puts "loop: #{micros - t} us"
+
+t = micros
+i = 0
+while i < N
+  x = i
+  i += 1
+end
+puts "move: #{micros - t} us"
+
+t = micros
+i = 0
+while i < N
+  x = i * 2 + 1
+  i += 1
+end
+puts "arith: #{micros - t} us"
+
+t = micros
+i = 0
+while i < N
+  x = i < 5000
+  i += 1
+end
+puts "compare: #{micros - t} us"
+
+t = micros
+i = 0
+while i < N
+  foo
+  i += 1
+end
+puts "send: #{micros - t} us"
+
+t = micros
+i = 0
+while i < N
+  c.inc
+  i += 1
+end
+puts "ivar: #{micros - t} us"
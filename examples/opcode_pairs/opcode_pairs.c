@@ -0,0 +1,29 @@
+/* assembled by hand to match opcode_pairs.rb. (not generated by mrbc)
+   RITE0004 bytecode in big endian order. */
+#include <stdint.h>
+extern const uint8_t code[];
+const uint8_t
+#if defined __GNUC__
+__attribute__((aligned(4)))
+#elif defined _MSC_VER
+__declspec(align(4))
+#endif
+code[] = {
+0x52,0x49,0x54,0x45,0x30,0x30,0x30,0x34,0xba,0x47,0x00,0x00,0x01,0x0a,0x4d,0x41,
+0x54,0x5a,0x30,0x30,0x30,0x30,0x49,0x52,0x45,0x50,0x00,0x00,0x00,0xec,0x30,0x30,
+0x30,0x30,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x06,0x00,0x01,0x00,0x00,0x00,0x12,
+0x01,0x00,0x00,0x48,0x01,0x80,0x00,0xc0,0x01,0x00,0x00,0x46,0x00,0xbf,0xff,0x83,
+0x00,0x40,0x04,0x17,0x01,0x00,0x00,0x06,0x01,0x80,0x00,0x06,0x02,0x00,0x40,0x01,
+0x01,0x80,0x00,0xa0,0x01,0x00,0x40,0xa0,0x01,0x00,0x40,0x01,0x01,0x00,0x80,0xad,
+0x00,0x80,0x80,0x01,0x01,0x00,0x40,0x01,0x01,0xc0,0x07,0x03,0x01,0x00,0xc0,0xb3,
+0x01,0x3f,0xfa,0x18,0x00,0x00,0x00,0x4a,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04,
+0x00,0x03,0x66,0x69,0x62,0x00,0x00,0x04,0x70,0x75,0x74,0x73,0x00,0x00,0x01,0x2b,
+0x00,0x00,0x01,0x3c,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x00,0x07,0x00,0x00,0x00,
+0x00,0x00,0x11,0x00,0x00,0x00,0x00,0x26,0x01,0x80,0x40,0x01,0x02,0x40,0x00,0x83,
+0x01,0x80,0x00,0xb3,0x01,0xc0,0x01,0x19,0x01,0x80,0x40,0x01,0x00,0x40,0x04,0x97,
+0x01,0x80,0x00,0x06,0x02,0x00,0x40,0x01,0x02,0x00,0x40,0xaf,0x01,0x80,0x80,0xa0,
+0x02,0x00,0x00,0x06,0x02,0x80,0x40,0x01,0x02,0x80,0x41,0x2f,0x02,0x00,0x80,0xa0,
+0x01,0x80,0xc0,0xac,0x01,0x80,0x00,0x29,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04,
+0x00,0x01,0x3c,0x00,0x00,0x01,0x2d,0x00,0x00,0x03,0x66,0x69,0x62,0x00,0x00,0x01,
+0x2b,0x00,0x45,0x4e,0x44,0x00,0x00,0x00,0x00,0x08,
+};
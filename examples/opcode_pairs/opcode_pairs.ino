@@ -0,0 +1,38 @@
+/*
+  Opcode pair profiler.
+
+  Set MRBC_PROFILE_OPCODE_PAIRS to 1 in vm_config.h, and set
+  MRBC_USE_SUPERINSTRUCTION to 0 to count the original opcodes.
+  The most frequent pairs are printed after the script finishes.
+  tools/opcode_pairs does the same on a PC, with a .mrb file.
+*/
+#include <mrubyc_for_ESP32_Arduino.h>
+
+extern const uint8_t code[];
+
+#define MEMSIZE (1024*30)
+static uint8_t mempool[MEMSIZE];
+
+void setup() {
+  delay(1000);
+
+  Serial.println("--- begin setup");
+  mrbc_init(mempool, MEMSIZE);
+  mrbc_define_user_class();
+  if(NULL == mrbc_create_task( code, 0 )){
+    Serial.println("mrbc_create_task error");
+    return;
+  }
+  Serial.println("--- run mruby script");
+  mrbc_run();
+
+#if MRBC_PROFILE_OPCODE_PAIRS
+  mrbc_print_opcode_pairs(20);
+#else
+  Serial.println("MRBC_PROFILE_OPCODE_PAIRS is not enabled");
+#endif
+}
+
+void loop() {
+  delay(1000);
+}
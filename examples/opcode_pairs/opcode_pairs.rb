@@ -0,0 +1,19 @@
+#
+# Sample script for opcode pair profiling.
+#
+#  Replace this script and opcode_pairs.c with your own program,
+#  to see which opcode pairs are executed most frequently.
+#
+def fib(n)
+  if n < 2
+    n
+  else
+    fib(n - 1) + fib(n - 2)
+  end
+end
+
+i = 0
+while i < 15
+  puts fib(i)
+  i += 1
+end
@@ -0,0 +1,36 @@
+/* assembled by hand to match test_float.rb. (not generated by mrbc)
+   RITE0004 bytecode in big endian order. */
+#include <stdint.h>
+extern const uint8_t code[];
+const uint8_t
+#if defined __GNUC__
+__attribute__((aligned(4)))
+#elif defined _MSC_VER
+__declspec(align(4))
+#endif
+code[] = {
+0x52,0x49,0x54,0x45,0x30,0x30,0x30,0x34,0x77,0x8b,0x00,0x00,0x01,0x79,0x4d,0x41,
+0x54,0x5a,0x30,0x30,0x30,0x30,0x49,0x52,0x45,0x50,0x00,0x00,0x01,0x5b,0x30,0x30,
+0x30,0x30,0x00,0x00,0x00,0x00,0x00,0x05,0x00,0x09,0x00,0x00,0x00,0x00,0x00,0x3f,
+0x00,0x80,0x00,0x02,0x01,0x3f,0xff,0x83,0x00,0x80,0x00,0xb1,0x01,0x00,0x00,0x82,
+0x01,0xbf,0xff,0x83,0x01,0x00,0x00,0xb1,0x01,0x80,0x01,0x02,0x02,0x3f,0xff,0x83,
+0x01,0x80,0x00,0xb1,0x02,0x80,0x00,0x06,0x03,0x00,0x40,0x01,0x02,0x80,0x40,0xa0,
+0x02,0x80,0x00,0x06,0x03,0x00,0x80,0x01,0x02,0x80,0x40,0xa0,0x02,0x80,0x00,0x06,
+0x03,0x00,0x40,0x01,0x03,0x00,0x80,0x20,0x02,0x80,0x40,0xa0,0x02,0x80,0x00,0x06,
+0x03,0x00,0x80,0x01,0x03,0x00,0xc0,0x20,0x02,0x80,0x40,0xa0,0x02,0x80,0x00,0x06,
+0x03,0x00,0xc0,0x01,0x03,0x00,0xc0,0x20,0x02,0x80,0x40,0xa0,0x02,0x80,0x40,0x01,
+0x03,0x00,0x80,0x01,0x03,0x80,0xc0,0x01,0x02,0x01,0x41,0xb7,0x02,0x80,0x00,0x06,
+0x03,0x01,0x00,0x01,0x03,0xc0,0x00,0x03,0x03,0x01,0x00,0xa0,0x02,0x80,0x40,0xa0,
+0x02,0x80,0x00,0x06,0x03,0x01,0x00,0x01,0x03,0xc0,0x00,0x03,0x03,0x01,0x00,0xa0,
+0x03,0xbf,0xff,0x83,0x03,0x01,0x40,0xb3,0x02,0x80,0x40,0xa0,0x02,0x80,0x00,0x06,
+0x03,0x01,0x00,0x01,0x03,0xc0,0x00,0x03,0x03,0x01,0x00,0xa0,0x03,0x80,0x80,0x01,
+0x03,0x01,0x80,0xb2,0x02,0x80,0x40,0xa0,0x02,0x80,0x00,0x06,0x03,0x01,0x00,0x01,
+0x03,0xc0,0x00,0x83,0x03,0x01,0x00,0xa0,0x03,0x00,0xc0,0x20,0x02,0x80,0x40,0xa0,
+0x02,0x80,0x00,0x06,0x03,0x00,0x80,0x01,0x03,0xbf,0xff,0x83,0x03,0x01,0xc0,0xb0,
+0x03,0x00,0xc0,0x20,0x02,0x80,0x40,0xa0,0x00,0x00,0x00,0x4a,0x00,0x00,0x00,0x03,
+0x02,0x00,0x03,0x31,0x2e,0x30,0x02,0x00,0x04,0x2d,0x31,0x2e,0x30,0x02,0x00,0x03,
+0x30,0x2e,0x30,0x00,0x00,0x00,0x08,0x00,0x01,0x2f,0x00,0x00,0x04,0x70,0x75,0x74,
+0x73,0x00,0x00,0x02,0x2d,0x40,0x00,0x00,0x05,0x63,0x6c,0x61,0x73,0x73,0x00,0x00,
+0x02,0x5b,0x5d,0x00,0x00,0x01,0x3c,0x00,0x00,0x02,0x3d,0x3d,0x00,0x00,0x01,0x2a,
+0x00,0x45,0x4e,0x44,0x00,0x00,0x00,0x00,0x08,
+};
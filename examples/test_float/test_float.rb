@@ -0,0 +1,23 @@
+#
+# Float special values test
+#
+#  Infinity, -Infinity and NaN must stay Float through registers,
+#  arrays and arithmetic. Run it with MRBC_USE_COMPACT_VALUE 1 too,
+#  where -Infinity is next to the NaN space used for other types.
+#  Expected output:
+#   inf -inf -inf Float Float -inf true true Float Float (one per line)
+#
+pinf = 1.0 / 0
+minf = -1.0 / 0
+nan = 0.0 / 0
+puts pinf
+puts minf
+puts -pinf
+puts minf.class
+puts nan.class
+a = [pinf, minf, nan]
+puts a[1]
+puts a[1] < 0
+puts a[1] == minf
+puts a[2].class
+puts (minf * 0).class
@@ -0,0 +1,29 @@
+/* assembled by hand to match test_reserve.rb. (not generated by mrbc)
+   RITE0004 bytecode in big endian order. */
+#include <stdint.h>
+extern const uint8_t code[];
+const uint8_t
+#if defined __GNUC__
+__attribute__((aligned(4)))
+#elif defined _MSC_VER
+__declspec(align(4))
+#endif
+code[] = {
+0x52,0x49,0x54,0x45,0x30,0x30,0x30,0x34,0x87,0x95,0x00,0x00,0x01,0x0c,0x4d,0x41,
+0x54,0x5a,0x30,0x30,0x30,0x30,0x49,0x52,0x45,0x50,0x00,0x00,0x00,0xee,0x30,0x30,
+0x30,0x30,0x00,0x00,0x00,0x00,0x00,0x03,0x00,0x06,0x00,0x00,0x00,0x00,0x00,0x29,
+0x01,0xc0,0x00,0x03,0x02,0x40,0x00,0x83,0x01,0x80,0xc1,0x37,0x00,0x80,0xc0,0x01,
+0x01,0x80,0x40,0x01,0x02,0x3f,0xff,0x03,0x01,0x80,0x00,0xa0,0x01,0x80,0x40,0x01,
+0x02,0x00,0x00,0x02,0x01,0x80,0x00,0xa0,0x01,0x80,0x40,0x01,0x02,0x00,0x00,0x84,
+0x01,0x80,0x00,0xa0,0x01,0x80,0x40,0x01,0x02,0x40,0x04,0x83,0x01,0x80,0x00,0xa0,
+0x01,0x80,0x00,0x06,0x02,0x00,0x40,0x01,0x02,0x00,0x80,0x20,0x01,0x80,0xc0,0xa0,
+0x01,0xc0,0x00,0x03,0x02,0x40,0x00,0x83,0x01,0x80,0xc0,0xbf,0x01,0x00,0xc0,0x01,
+0x01,0x80,0x80,0x01,0x02,0x3f,0xff,0x03,0x01,0x80,0x00,0xa0,0x01,0x80,0x80,0x01,
+0x02,0x00,0x00,0x82,0x01,0x80,0x00,0xa0,0x01,0x80,0x80,0x01,0x02,0x00,0x00,0x84,
+0x01,0x80,0x00,0xa0,0x01,0x80,0x80,0x01,0x02,0x40,0x04,0x83,0x01,0x80,0x00,0xa0,
+0x01,0x80,0x00,0x06,0x02,0x00,0x80,0x01,0x02,0x00,0x80,0x20,0x01,0x80,0xc0,0xa0,
+0x00,0x00,0x00,0x4a,0x00,0x00,0x00,0x02,0x02,0x00,0x03,0x31,0x2e,0x35,0x02,0x00,
+0x03,0x31,0x2e,0x35,0x00,0x00,0x00,0x04,0x00,0x07,0x72,0x65,0x73,0x65,0x72,0x76,
+0x65,0x00,0x00,0x01,0x78,0x00,0x00,0x04,0x73,0x69,0x7a,0x65,0x00,0x00,0x04,0x70,
+0x75,0x74,0x73,0x00,0x45,0x4e,0x44,0x00,0x00,0x00,0x00,0x08,
+};
@@ -0,0 +1,22 @@
+#
+# Array#reserve and Hash#reserve argument test
+#
+#  A negative or non-integer size is reported as ArgumentError
+#  by both classes, and the receiver is not changed.
+#  Expected output (one per line):
+#    ArgumentError ArgumentError ArgumentError 2
+#    ArgumentError ArgumentError ArgumentError 1
+#
+a = [1, 2]
+a.reserve(-1)
+a.reserve(1.5)
+a.reserve(:x)
+a.reserve(10)
+puts a.size
+
+h = {1 => 2}
+h.reserve(-1)
+h.reserve(1.5)
+h.reserve(:x)
+h.reserve(10)
+puts h.size
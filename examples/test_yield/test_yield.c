@@ -0,0 +1,31 @@
+/* assembled by hand to match test_yield.rb. (not generated by mrbc)
+   RITE0004 bytecode in big endian order. */
+#include <stdint.h>
+extern const uint8_t code[];
+const uint8_t
+#if defined __GNUC__
+__attribute__((aligned(4)))
+#elif defined _MSC_VER
+__declspec(align(4))
+#endif
+code[] = {
+0x52,0x49,0x54,0x45,0x30,0x30,0x30,0x34,0x42,0xa4,0x00,0x00,0x01,0x23,0x4d,0x41,
+0x54,0x5a,0x30,0x30,0x30,0x30,0x49,0x52,0x45,0x50,0x00,0x00,0x01,0x05,0x30,0x30,
+0x30,0x30,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x03,0x00,0x03,0x00,0x00,0x00,0x0e,
+0x00,0xc0,0x01,0x03,0x01,0x00,0x01,0x40,0x00,0x80,0x00,0x21,0x00,0xc0,0x01,0x83,
+0x01,0x40,0x02,0x03,0x00,0x80,0x41,0x37,0x01,0x00,0x03,0x40,0x00,0x80,0x40,0x21,
+0x00,0xc0,0x02,0x83,0x01,0x40,0x03,0x03,0x00,0x80,0x40,0x41,0x01,0x00,0x05,0x40,
+0x00,0x80,0x40,0x21,0x00,0x00,0x00,0x4a,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,
+0x00,0x05,0x74,0x69,0x6d,0x65,0x73,0x00,0x00,0x04,0x65,0x61,0x63,0x68,0x00,0x00,
+0x00,0x00,0x00,0x00,0x02,0x00,0x05,0x00,0x00,0x00,0x00,0x00,0x05,0x00,0x00,0x00,
+0x00,0x00,0x00,0x26,0x01,0x80,0x00,0x06,0x02,0x00,0x40,0x01,0x01,0x80,0x00,0xa0,
+0x01,0x80,0x00,0x29,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x04,0x70,0x75,
+0x74,0x73,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x05,0x00,0x00,0x00,0x00,0x00,
+0x05,0x00,0x00,0x00,0x00,0x00,0x00,0x26,0x01,0x80,0x00,0x06,0x02,0x00,0x40,0x01,
+0x01,0x80,0x00,0xa0,0x01,0x80,0x00,0x29,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,
+0x00,0x04,0x70,0x75,0x74,0x73,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x05,0x00,
+0x00,0x00,0x00,0x00,0x05,0x00,0x00,0x00,0x00,0x00,0x00,0x26,0x01,0x80,0x00,0x06,
+0x02,0x00,0x40,0x01,0x01,0x80,0x00,0xa0,0x01,0x80,0x00,0x29,0x00,0x00,0x00,0x00,
+0x00,0x00,0x00,0x01,0x00,0x04,0x70,0x75,0x74,0x73,0x00,0x45,0x4e,0x44,0x00,0x00,
+0x00,0x00,0x08,
+};
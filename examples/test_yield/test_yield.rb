@@ -0,0 +1,11 @@
+#
+# Block call test
+#
+#  The block register of each call is the last register of the top
+#  level, so the iterator keeps its state just after the end of the
+#  register stack. (see mrbc_yield())
+#  Expected output: 0 1 2 4 5 6 7 (one per line)
+#
+3.times {|i| puts i }
+[4, 5].each {|x| puts x }
+(6..7).each {|x| puts x }
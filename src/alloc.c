@@ -18,6 +18,7 @@
 #include <string.h>
 #include <assert.h>
 #include "alloc.h"
+#include "rrt0.h"
 #include "console.h"
 
 
@@ -34,6 +35,20 @@
 // 7 : 2000-3fff
 // 8 : 4000-7fff
 // 9 : 8000-ffff
+//
+// MRBC_ALLOC_LARGE_HEAP uses 32-bit block size, and FLI is extended.
+// 10 : 00010000-0001ffff
+//  :
+// 20 : 04000000-07ffffff  (up to 128MB)
+
+#if MRBC_ALLOC_LARGE_HEAP
+# ifndef MRBC_ALLOC_FLI_BIT_WIDTH
+#  define MRBC_ALLOC_FLI_BIT_WIDTH 20
+# endif
+# ifndef MRBC_ALLOC_MEMSIZE_T
+#  define MRBC_ALLOC_MEMSIZE_T     uint32_t
+# endif
+#endif
 
 #ifndef MRBC_ALLOC_FLI_BIT_WIDTH	// 0000 0000 0000 0000
 # define MRBC_ALLOC_FLI_BIT_WIDTH 9	// ~~~~~~~~~~~
@@ -58,52 +73,164 @@
 #define FLAG_FREE_BLOCK     1
 #define FLAG_USED_BLOCK     0
 
+#define FLAG_SLAB           1
+
 // memory block header
+//  (note) flags and vm_id are placed at the end of the header,
+//  so that they are at the same position as in the SLAB_SLOT.
 typedef struct USED_BLOCK {
-  unsigned int         t : 1;       //!< FLAG_TAIL_BLOCK or FLAG_NOT_TAIL_BLOCK
-  unsigned int         f : 1;       //!< FLAG_FREE_BLOCK or BLOCK_IS_NOT_FREE
-  uint8_t              vm_id;       //!< mruby/c VM ID
+  struct USED_BLOCK   *next_vm;     //!< list of blocks owned by the same VM
+  struct USED_BLOCK   *prev_vm;
 
   MRBC_ALLOC_MEMSIZE_T size;        //!< block size, header included
   MRBC_ALLOC_MEMSIZE_T prev_offset; //!< offset of previous physical block
-} USED_BLOCK;
 
-typedef struct FREE_BLOCK {
   unsigned int         t : 1;       //!< FLAG_TAIL_BLOCK or FLAG_NOT_TAIL_BLOCK
   unsigned int         f : 1;       //!< FLAG_FREE_BLOCK or BLOCK_IS_NOT_FREE
-  uint8_t              vm_id;       //!< dummy
+  unsigned int         s : 1;       //!< FLAG_SLAB if slab page
+  unsigned int         r : 3;       //!< index of memory_pools
+  uint8_t              vm_id;       //!< mruby/c VM ID
+} USED_BLOCK;
+
+typedef struct FREE_BLOCK {
+  struct FREE_BLOCK   *next_free;
+  struct FREE_BLOCK   *prev_free;
 
   MRBC_ALLOC_MEMSIZE_T size;        //!< block size, header included
   MRBC_ALLOC_MEMSIZE_T prev_offset; //!< offset of previous physical block
 
-  struct FREE_BLOCK *next_free;
-  struct FREE_BLOCK *prev_free;
+  unsigned int         t : 1;       //!< FLAG_TAIL_BLOCK or FLAG_NOT_TAIL_BLOCK
+  unsigned int         f : 1;       //!< FLAG_FREE_BLOCK or BLOCK_IS_NOT_FREE
+  unsigned int         s : 1;       //!< FLAG_SLAB if slab page
+  unsigned int         r : 3;       //!< index of memory_pools
+  uint8_t              vm_id;       //!< dummy
 } FREE_BLOCK;
 
+// slab object header
+typedef struct SLAB_SLOT {
+  unsigned int         t : 1;       //!< not used
+  unsigned int         f : 1;       //!< FLAG_FREE_BLOCK or BLOCK_IS_NOT_FREE
+  unsigned int         s : 1;       //!< FLAG_SLAB
+  uint8_t              vm_id;       //!< mruby/c VM ID
+  uint16_t             page_offset; //!< offset from the top of the page
+} SLAB_SLOT;
+
+// slab page. allocated as a TLSF block.
+typedef struct SLAB_PAGE {
+  struct SLAB_PAGE *next;           //!< list of pages that have free slots
+  struct SLAB_PAGE *prev;
+  SLAB_SLOT        *free_slot;      //!< free slot list
+  uint16_t          n_used;         //!< number of used slots
+  uint8_t           bin;            //!< index of slab_pages
+} SLAB_PAGE;
+
 #define PHYS_NEXT(p) ((uint8_t *)(p) + (p)->size)
 #define PHYS_PREV(p) ((uint8_t *)(p) - (p)->prev_offset)
 #define SET_PHYS_PREV(p1,p2)				\
   ((p2)->prev_offset = (uint8_t *)(p2)-(uint8_t *)(p1))
 
-#define SET_VM_ID(p,id)							\
-  (((USED_BLOCK *)((uint8_t *)(p) - sizeof(USED_BLOCK)))->vm_id = (id))
-#define GET_VM_ID(p)							\
-  (((USED_BLOCK *)((uint8_t *)(p) - sizeof(USED_BLOCK)))->vm_id)
-
+// the last part of the header is common to USED_BLOCK and SLAB_SLOT.
+#define BLOCK_TAIL_SIZE (sizeof(USED_BLOCK) - offsetof(USED_BLOCK, vm_id) + 1)
+#define BLOCK_TAIL(p) ((SLAB_SLOT *)((uint8_t *)(p) - BLOCK_TAIL_SIZE))
+#define SET_VM_ID(p,id) (BLOCK_TAIL(p)->vm_id = (id))
+#define GET_VM_ID(p)    (BLOCK_TAIL(p)->vm_id)
+#define IS_SLAB(p)      (BLOCK_TAIL(p)->s == FLAG_SLAB)
 
-// memory pool
-static unsigned int memory_pool_size;
-static uint8_t     *memory_pool;
 
 // free memory block index
 #define SIZE_FREE_BLOCKS \
   ((MRBC_ALLOC_FLI_BIT_WIDTH + 1) * (1 << MRBC_ALLOC_SLI_BIT_WIDTH))
-static FREE_BLOCK *free_blocks[SIZE_FREE_BLOCKS + 1];
 
 // free memory bitmap
-#define MSB_BIT1 0x8000
-static uint16_t free_fli_bitmap;
-static uint16_t free_sli_bitmap[MRBC_ALLOC_FLI_BIT_WIDTH + 2]; // + sentinel
+#if MRBC_ALLOC_FLI_BIT_WIDTH < 16
+# define MSB_BIT1 0x8000
+# define BITMAP_T uint16_t
+# define BITMAP_BITS 16
+# define NLZ(x) nlz16(x)
+#else
+# define MSB_BIT1 0x80000000UL
+# define BITMAP_T uint32_t
+# define BITMAP_BITS 32
+# define NLZ(x) nlz32(x)
+#endif
+
+// memory pool (region)
+typedef struct MEMORY_POOL {
+  uint8_t     *pool;
+  unsigned int size;
+  uint8_t      speed;               //!< MRBC_ALLOC_FAST or MRBC_ALLOC_SLOW
+
+  // free memory bitmap
+  BITMAP_T     free_fli_bitmap;
+  BITMAP_T     free_sli_bitmap[MRBC_ALLOC_FLI_BIT_WIDTH + 2]; // + sentinel
+
+  // free memory block index
+  FREE_BLOCK  *free_blocks[SIZE_FREE_BLOCKS + 1];
+} MEMORY_POOL;
+
+static MEMORY_POOL  memory_pools[MRBC_ALLOC_MAX_REGIONS];
+static int          num_memory_pools;
+#define POOL_OF(block) (&memory_pools[(block)->r])
+
+// allocation policy. requests of this size or more prefer slow regions.
+static unsigned int alloc_bulk_size;
+
+// blocks owned by each VM. (vm_id 0 is shared)
+static USED_BLOCK  *vm_blocks[MAX_VM_COUNT + 1];
+static unsigned int vm_used[MAX_VM_COUNT + 1];
+static unsigned int vm_peak[MAX_VM_COUNT + 1];
+
+// heap statistics.
+static unsigned int alloc_total;
+static unsigned int alloc_used;
+static unsigned int alloc_peak;
+static uint32_t     alloc_histogram[MRBC_ALLOC_HISTOGRAM_BINS];
+
+// low memory handling.
+static mrbc_low_memory_hook low_memory_hooks[MRBC_LOW_MEMORY_HOOKS];
+static int          num_low_memory_hooks;
+static int          in_low_memory_hooks;
+static void        *alloc_reserve;	// emergency reserve block.
+static unsigned int alloc_warning_level;	// watermarks of alloc_used.
+static unsigned int alloc_recover_level;
+static int          alloc_warning;	// alloc_used is above the warning level.
+static int          alloc_events;	// MRBC_ALLOC_EVENT_xxx
+
+#if MRBC_ALLOC_TRACE > 0
+// allocation trace ring buffer.
+static MRBC_ALLOC_TRACE_ENTRY alloc_trace[MRBC_ALLOC_TRACE];
+static unsigned int alloc_trace_pos;	// next position to write.
+static unsigned int alloc_trace_count;
+static int          alloc_trace_dumped;	// dumped by out of memory.
+
+static void trace_record(int op, int vm_id, unsigned int size,
+			 const void *ptr, const void *ret);
+#define TRACE(op, vm_id, size, ptr, ret) \
+  trace_record(MRBC_ALLOC_TRACE_##op, vm_id, size, ptr, ret)
+#else
+#define TRACE(op, vm_id, size, ptr, ret) ((void)0)
+#endif
+
+#if MRBC_SLAB_MAX_SIZE > 0
+// slab bins. payload size is 8,12,16,... up to MRBC_SLAB_MAX_SIZE.
+#define SLAB_NUM_BINS     (MRBC_SLAB_MAX_SIZE / 4 - 1)
+#define SLAB_BIN(size)    ((size) <= 8 ? 0 : ((size) - 5) >> 2)
+#define SLAB_PAYLOAD(bin) (((bin) + 2) * 4)
+#define SLAB_SLOT_SIZE(bin) (BLOCK_TAIL_SIZE + SLAB_PAYLOAD(bin))
+#define SLAB_PAGE_TOP     ((sizeof(SLAB_PAGE) + 3) & ~3)
+#define SLAB_NUM_SLOTS(bin) \
+  ((MRBC_SLAB_PAGE_SIZE - SLAB_PAGE_TOP) / SLAB_SLOT_SIZE(bin))
+#define SLAB_SLOT_PTR(slot)  ((uint8_t *)(slot) + BLOCK_TAIL_SIZE)
+#define SLAB_SLOT_NEXT(slot) (*(SLAB_SLOT **)SLAB_SLOT_PTR(slot))
+#define SLAB_SLOT_PAGE(slot) \
+  ((SLAB_PAGE *)((uint8_t *)(slot) - (slot)->page_offset))
+
+// pages that have free slots, for each VM.
+static SLAB_PAGE *slab_pages[MAX_VM_COUNT + 1][SLAB_NUM_BINS];
+
+// number of empty pages kept for reuse. (up to SLAB_NUM_BINS)
+static int slab_empty_pages;
+#endif
 
 
 //================================================================
@@ -124,6 +251,62 @@ static inline int nlz16(uint16_t x)
 }
 
 
+#if MRBC_ALLOC_FLI_BIT_WIDTH >= 16
+//================================================================
+/*! Number of leading zeros.
+
+  @param  x	target (32bit unsined)
+  @retval int	nlz value
+*/
+static inline int nlz32(uint32_t x)
+{
+  if( x == 0 ) return 32;
+
+  int n = 1;
+  if((x >> 16) == 0 ) { n += 16; x <<= 16; }
+  if((x >> 24) == 0 ) { n +=  8; x <<=  8; }
+  if((x >> 28) == 0 ) { n +=  4; x <<=  4; }
+  if((x >> 30) == 0 ) { n +=  2; x <<=  2; }
+  return n - (x >> 31);
+}
+#endif
+
+
+//================================================================
+/*! check the watermarks of the used memory, and raise the events.
+*/
+static inline void check_watermark(void)
+{
+  if( alloc_used > alloc_warning_level ) {
+    if( !alloc_warning ) {
+      alloc_warning = 1;
+      alloc_events |= MRBC_ALLOC_EVENT_WARNING;
+    }
+  } else if( alloc_warning && alloc_used < alloc_recover_level ) {
+    alloc_warning = 0;
+    alloc_events |= MRBC_ALLOC_EVENT_RECOVERED;
+  }
+}
+
+
+//================================================================
+/*! add to the used size of the VM, and update the high-water marks.
+
+  @param  vm_id	owner of the block.
+  @param  size	size to add. (negative to subtract)
+*/
+static inline void add_used(int vm_id, int size)
+{
+  vm_used[vm_id] += size;
+  if( vm_peak[vm_id] < vm_used[vm_id] ) vm_peak[vm_id] = vm_used[vm_id];
+
+  alloc_used += size;
+  if( alloc_peak < alloc_used ) alloc_peak = alloc_used;
+
+  check_watermark();
+}
+
+
 //================================================================
 /*! calc f and s, and returns fli,sli of free_blocks
 
@@ -140,8 +323,8 @@ static int calc_index(unsigned int alloc_size)
   }
 
   // calculate First Level Index.
-  int fli = 16 -
-    nlz16( alloc_size >> (MRBC_ALLOC_SLI_BIT_WIDTH + MRBC_ALLOC_IGNORE_LSBS) );
+  int fli = BITMAP_BITS -
+    NLZ( alloc_size >> (MRBC_ALLOC_SLI_BIT_WIDTH + MRBC_ALLOC_IGNORE_LSBS) );
 
   // calculate Second Level Index.
   int shift = (fli == 0) ? (fli + MRBC_ALLOC_IGNORE_LSBS) :
@@ -159,12 +342,31 @@ static int calc_index(unsigned int alloc_size)
 }
 
 
+//================================================================
+/*! the minimum size of the index. (inverse of calc_index)
+
+  @param  index	index of free_blocks
+  @retval	block size
+*/
+static unsigned int index_size(int index)
+{
+  int fli = FLI(index);
+  int sli = SLI(index);
+
+  if( fli == 0 ) return sli << MRBC_ALLOC_IGNORE_LSBS;
+
+  return (1UL << (fli + MRBC_ALLOC_SLI_BIT_WIDTH + MRBC_ALLOC_IGNORE_LSBS - 1))
+    | ((unsigned long)sli << (fli + MRBC_ALLOC_IGNORE_LSBS - 1));
+}
+
+
 //================================================================
 /*! Mark that block free and register it in the free index table.
 
+  @param  pool		Pointer to the memory pool.
   @param  target	Pointer to target block.
 */
-static void add_free_block(FREE_BLOCK *target)
+static void add_free_block(MEMORY_POOL *pool, FREE_BLOCK *target)
 {
   target->f = FLAG_FREE_BLOCK;
 
@@ -172,15 +374,15 @@ static void add_free_block(FREE_BLOCK *target)
   int fli   = FLI(index);
   int sli   = SLI(index);
 
-  free_fli_bitmap      |= (MSB_BIT1 >> fli);
-  free_sli_bitmap[fli] |= (MSB_BIT1 >> sli);
+  pool->free_fli_bitmap      |= (MSB_BIT1 >> fli);
+  pool->free_sli_bitmap[fli] |= (MSB_BIT1 >> sli);
 
   target->prev_free = NULL;
-  target->next_free = free_blocks[index];
+  target->next_free = pool->free_blocks[index];
   if( target->next_free != NULL ) {
     target->next_free->prev_free = target;
   }
-  free_blocks[index] = target;
+  pool->free_blocks[index] = target;
 
 #ifdef MRBC_DEBUG
   target->vm_id = UINT8_MAX;
@@ -194,20 +396,23 @@ static void add_free_block(FREE_BLOCK *target)
 //================================================================
 /*! just remove the free_block *target from index
 
+  @param  pool		pointer to the memory pool.
   @param  target	pointer to target block.
 */
-static void remove_index(FREE_BLOCK *target)
+static void remove_index(MEMORY_POOL *pool, FREE_BLOCK *target)
 {
   // top of linked list?
   if( target->prev_free == NULL ) {
     int index = calc_index(target->size) - 1;
-    free_blocks[index] = target->next_free;
+    pool->free_blocks[index] = target->next_free;
 
-    if( free_blocks[index] == NULL ) {
+    if( pool->free_blocks[index] == NULL ) {
       int fli = FLI(index);
       int sli = SLI(index);
-      free_sli_bitmap[fli] &= ~(MSB_BIT1 >> sli);
-      if( free_sli_bitmap[fli] == 0 ) free_fli_bitmap &= ~(MSB_BIT1 >> fli);
+      pool->free_sli_bitmap[fli] &= ~(MSB_BIT1 >> sli);
+      if( pool->free_sli_bitmap[fli] == 0 ) {
+	pool->free_fli_bitmap &= ~(MSB_BIT1 >> fli);
+      }
     }
   }
   else {
@@ -240,6 +445,7 @@ static inline FREE_BLOCK* split_block(FREE_BLOCK *target, unsigned int size)
   split->size  = target->size - size;
   SET_PHYS_PREV(target, split);
   split->t     = target->t;
+  split->r     = target->r;
   target->size = size;
   target->t    = FLAG_NOT_TAIL_BLOCK;
   if( split->t == FLAG_NOT_TAIL_BLOCK ) {
@@ -273,79 +479,176 @@ static void merge_block(FREE_BLOCK *ptr1, FREE_BLOCK *ptr2)
 }
 
 
+//================================================================
+/*! link the used block to the list of the VM.
+
+  @param  target	pointer to target block.
+  @param  vm_id		owner of the block.
+*/
+static void link_vm_block(USED_BLOCK *target, int vm_id)
+{
+  assert( vm_id <= MAX_VM_COUNT );
+
+  target->vm_id   = vm_id;
+  target->prev_vm = NULL;
+  target->next_vm = vm_blocks[vm_id];
+  if( target->next_vm != NULL ) {
+    target->next_vm->prev_vm = target;
+  }
+  vm_blocks[vm_id] = target;
+  add_used(vm_id, target->size);
+}
+
+
+//================================================================
+/*! unlink the used block from the list of the VM.
+
+  @param  target	pointer to target block.
+*/
+static void unlink_vm_block(USED_BLOCK *target)
+{
+  if( target->prev_vm == NULL ) {
+    vm_blocks[target->vm_id] = target->next_vm;
+  } else {
+    target->prev_vm->next_vm = target->next_vm;
+  }
+  if( target->next_vm != NULL ) {
+    target->next_vm->prev_vm = target->prev_vm;
+  }
+  add_used(target->vm_id, -(int)target->size);
+}
+
+
 //================================================================
 /*! initialize
 
+  The memory block is registered as a fast region.
+  Use mrbc_add_alloc_region() to add more regions.
+
   @param  ptr	pointer to free memory block.
-  @param  size	size. (max 64KB. see MRBC_ALLOC_MEMSIZE_T)
+  @param  size	size. (max 64KB, or 128MB with MRBC_ALLOC_LARGE_HEAP)
 */
 void mrbc_init_alloc(void *ptr, unsigned int size)
+{
+  assert( sizeof(USED_BLOCK) == sizeof(FREE_BLOCK) );
+  assert( BLOCK_TAIL_SIZE >= sizeof(SLAB_SLOT) );
+  assert( MRBC_ALLOC_MAX_REGIONS <= 8 );	// see USED_BLOCK::r
+
+  num_memory_pools = 0;
+  alloc_bulk_size = MRBC_ALLOC_BULK_SIZE;
+  memset( vm_blocks, 0, sizeof(vm_blocks) );
+  memset( vm_used, 0, sizeof(vm_used) );
+  memset( vm_peak, 0, sizeof(vm_peak) );
+  alloc_total = 0;
+  alloc_used = 0;
+  alloc_peak = 0;
+  memset( alloc_histogram, 0, sizeof(alloc_histogram) );
+  num_low_memory_hooks = 0;
+  in_low_memory_hooks = 0;
+  alloc_reserve = NULL;
+  alloc_warning = 0;
+  alloc_events = 0;
+#if MRBC_SLAB_MAX_SIZE > 0
+  memset( slab_pages, 0, sizeof(slab_pages) );
+  slab_empty_pages = 0;
+#endif
+#if MRBC_ALLOC_TRACE > 0
+  mrbc_alloc_trace_clear();
+#endif
+
+  mrbc_add_alloc_region( ptr, size, MRBC_ALLOC_FAST );
+  mrbc_alloc_restore_reserve();
+}
+
+
+//================================================================
+/*! add a memory region
+
+  @param  ptr	pointer to free memory block.
+  @param  size	size. (max 64KB, or 128MB with MRBC_ALLOC_LARGE_HEAP)
+  @param  speed	MRBC_ALLOC_FAST or MRBC_ALLOC_SLOW
+  @retval 0	No error.
+  @retval -1	Too many regions.
+*/
+int mrbc_add_alloc_region(void *ptr, unsigned int size, int speed)
 {
   assert( size != 0 );
   assert( size <= (MRBC_ALLOC_MEMSIZE_T)(~0) );
+  assert( (size >> (MRBC_ALLOC_FLI_BIT_WIDTH + MRBC_ALLOC_SLI_BIT_WIDTH
+		    + MRBC_ALLOC_IGNORE_LSBS)) == 0 );
+
+  if( num_memory_pools >= MRBC_ALLOC_MAX_REGIONS ) return -1;
 
-  memory_pool      = ptr;
-  memory_pool_size = size;
+  MEMORY_POOL *pool = &memory_pools[num_memory_pools];
+  memset( pool, 0, sizeof(MEMORY_POOL) );
+  pool->pool  = ptr;
+  pool->size  = size;
+  pool->speed = speed;
 
   // initialize memory pool
-  FREE_BLOCK *block = (FREE_BLOCK *)memory_pool;
+  FREE_BLOCK *block = (FREE_BLOCK *)ptr;
   block->t           = FLAG_TAIL_BLOCK;
   block->f           = FLAG_FREE_BLOCK;
-  block->size        = memory_pool_size;
+  block->s           = 0;
+  block->r           = num_memory_pools;
+  block->size        = size;
   block->prev_offset = 0;
 
-  add_free_block(block);
+  add_free_block(pool, block);
+  num_memory_pools++;
+  alloc_total += size;
+  alloc_warning_level = alloc_total / 100 * MRBC_ALLOC_WARNING_LEVEL;
+  alloc_recover_level = alloc_total / 100 * MRBC_ALLOC_RECOVER_LEVEL;
+
+  return 0;
 }
 
 
 //================================================================
-/*! allocate memory
+/*! set allocation policy
 
-  @param  size	request size.
-  @return void * pointer to allocated memory.
-  @retval NULL	error.
+  Requests of bulk_size bytes or more are allocated from slow regions,
+  and smaller ones from fast regions. If the preferred regions are
+  full, the others are used.
+
+  @param  bulk_size	threshold size. 0: everything prefers slow.
 */
-void * mrbc_raw_alloc(unsigned int size)
+void mrbc_set_alloc_policy(unsigned int bulk_size)
 {
-  // TODO: maximum alloc size
-  //  (1 << (FLI_BIT_WIDTH + SLI_BIT_WIDTH + IGNORE_LSBS)) - alpha
-
-  unsigned int alloc_size = size + sizeof(FREE_BLOCK);
+  alloc_bulk_size = bulk_size;
+}
 
-  // align 4 byte
-  alloc_size += ((4 - alloc_size) & 3);
 
-  // check minimum alloc size. if need.
-#if 0
-  if( alloc_size < (1 << MRBC_ALLOC_IGNORE_LSBS) ) {
-    alloc_size = (1 << MRBC_ALLOC_IGNORE_LSBS);
-  }
-#else
-  assert( alloc_size >= (1 << MRBC_ALLOC_IGNORE_LSBS) );
-#endif
+//================================================================
+/*! find a free block in the pool, and remove it from the index.
 
+  @param  pool		pointer to the memory pool.
+  @param  alloc_size	block size, header included.
+  @return		pointer to the block.
+  @retval NULL		not found.
+*/
+static FREE_BLOCK * find_free_block(MEMORY_POOL *pool, unsigned int alloc_size)
+{
   // find free memory block.
   int index = calc_index(alloc_size);
   int fli   = FLI(index);
   int sli   = SLI(index);
 
-  FREE_BLOCK *target = free_blocks[index];
+  FREE_BLOCK *target = pool->free_blocks[index];
 
   if( target == NULL ) {
     // uses free_fli/sli_bitmap table.
-    uint16_t masked = free_sli_bitmap[fli] & ((MSB_BIT1 >> sli) - 1);
+    BITMAP_T masked = pool->free_sli_bitmap[fli] & ((MSB_BIT1 >> sli) - 1);
     if( masked != 0 ) {
-      sli = nlz16(masked);
+      sli = NLZ(masked);
     }
     else {
-      masked = free_fli_bitmap & ((MSB_BIT1 >> fli) - 1);
+      masked = pool->free_fli_bitmap & ((MSB_BIT1 >> fli) - 1);
       if( masked != 0 ) {
-	fli = nlz16(masked);
-	sli = nlz16(free_sli_bitmap[fli]);
+	fli = NLZ(masked);
+	sli = NLZ(pool->free_sli_bitmap[fli]);
       }
       else {
-	// out of memory
-	console_print("Fatal error: Out of memory.\n");
 	return NULL;  // ENOMEM
       }
     }
@@ -355,54 +658,104 @@ void * mrbc_raw_alloc(unsigned int size)
     assert(sli <= (1 << MRBC_ALLOC_SLI_BIT_WIDTH) - 1);
 
     index = (fli << MRBC_ALLOC_SLI_BIT_WIDTH) + sli;
-    target = free_blocks[index];
+    target = pool->free_blocks[index];
     assert( target != NULL );
   }
   assert(target->size >= alloc_size);
 
   // remove free_blocks index
-  target->f          = FLAG_USED_BLOCK;
-  free_blocks[index] = target->next_free;
+  target->f = FLAG_USED_BLOCK;
+  pool->free_blocks[index] = target->next_free;
 
   if( target->next_free == NULL ) {
-    free_sli_bitmap[fli] &= ~(MSB_BIT1 >> sli);
-    if( free_sli_bitmap[fli] == 0 ) free_fli_bitmap &= ~(MSB_BIT1 >> fli);
+    pool->free_sli_bitmap[fli] &= ~(MSB_BIT1 >> sli);
+    if( pool->free_sli_bitmap[fli] == 0 ) {
+      pool->free_fli_bitmap &= ~(MSB_BIT1 >> fli);
+    }
   }
   else {
     target->next_free->prev_free = NULL;
   }
 
+  return target;
+}
+
+
+//================================================================
+/*! allocate memory from TLSF
+
+  Regions of the given speed are tried first, and then the others.
+
+  @param  size	request size.
+  @param  vm_id	owner of the block.
+  @param  speed	MRBC_ALLOC_FAST or MRBC_ALLOC_SLOW
+  @return void * pointer to allocated memory.
+  @retval NULL	error.
+*/
+static void * tlsf_alloc(unsigned int size, int vm_id, int speed)
+{
+  // TODO: maximum alloc size
+  //  (1 << (FLI_BIT_WIDTH + SLI_BIT_WIDTH + IGNORE_LSBS)) - alpha
+
+  unsigned int alloc_size = size + sizeof(FREE_BLOCK);
+
+  // align 4 byte
+  alloc_size += ((4 - alloc_size) & 3);
+
+  // check minimum alloc size. if need.
+#if 0
+  if( alloc_size < (1 << MRBC_ALLOC_IGNORE_LSBS) ) {
+    alloc_size = (1 << MRBC_ALLOC_IGNORE_LSBS);
+  }
+#else
+  assert( alloc_size >= (1 << MRBC_ALLOC_IGNORE_LSBS) );
+#endif
+
+  MEMORY_POOL *pool = NULL;
+  FREE_BLOCK *target = NULL;
+  int i;
+  for( i = 0; i < num_memory_pools * 2; i++ ) {
+    pool = &memory_pools[i % num_memory_pools];
+    if( (pool->speed == speed) != (i < num_memory_pools) ) continue;
+    target = find_free_block(pool, alloc_size);
+    if( target ) break;
+  }
+  if( target == NULL ) return NULL;  // ENOMEM
+
   // split a block
   FREE_BLOCK *release = split_block(target, alloc_size);
   if( release != NULL ) {
-    add_free_block(release);
+    add_free_block(pool, release);
   }
 
 #ifdef MRBC_DEBUG
   memset( (uint8_t *)target + sizeof(USED_BLOCK), 0xaa,
           target->size - sizeof(USED_BLOCK) );
 #endif
-  target->vm_id = 0;
+  target->s = 0;
+  link_vm_block((USED_BLOCK *)target, vm_id);
 
   return (uint8_t *)target + sizeof(USED_BLOCK);
 }
 
 
 //================================================================
-/*! release memory
+/*! release memory to TLSF
 
-  @param  ptr	Return value of mrbc_raw_alloc()
+  @param  ptr	Return value of tlsf_alloc()
 */
-void mrbc_raw_free(void *ptr)
+static void tlsf_free(void *ptr)
 {
   // get target block
   FREE_BLOCK *target = (FREE_BLOCK *)((uint8_t *)ptr - sizeof(USED_BLOCK));
+  MEMORY_POOL *pool = POOL_OF(target);
+  unlink_vm_block((USED_BLOCK *)target);
 
   // check next block, merge?
   FREE_BLOCK *next = (FREE_BLOCK *)PHYS_NEXT(target);
 
   if((target->t == FLAG_NOT_TAIL_BLOCK) && (next->f == FLAG_FREE_BLOCK)) {
-    remove_index(next);
+    remove_index(pool, next);
     merge_block(target, next);
   }
 
@@ -410,28 +763,303 @@ void mrbc_raw_free(void *ptr)
   FREE_BLOCK *prev = (FREE_BLOCK *)PHYS_PREV(target);
 
   if((prev != NULL) && (prev->f == FLAG_FREE_BLOCK)) {
-    remove_index(prev);
+    remove_index(pool, prev);
     merge_block(prev, target);
     target = prev;
   }
 
   // target, add to index
-  add_free_block(target);
+  add_free_block(pool, target);
 }
 
 
+
+#if MRBC_SLAB_MAX_SIZE > 0
 //================================================================
-/*! re-allocate memory
+/*! link the page to the bin of the owner VM.
+
+  @param  page	pointer to the page.
+*/
+static void slab_link_page(SLAB_PAGE *page)
+{
+  SLAB_PAGE **bin = &slab_pages[GET_VM_ID(page)][page->bin];
+
+  page->prev = NULL;
+  page->next = *bin;
+  if( page->next ) page->next->prev = page;
+  *bin = page;
+}
+
+
+//================================================================
+/*! unlink the page from the bin of the owner VM.
+
+  @param  page	pointer to the page.
+*/
+static void slab_unlink_page(SLAB_PAGE *page)
+{
+  if( page->prev ) {
+    page->prev->next = page->next;
+  } else {
+    slab_pages[GET_VM_ID(page)][page->bin] = page->next;
+  }
+  if( page->next ) page->next->prev = page->prev;
+}
+
+
+//================================================================
+/*! allocate a new slab page and link it to the bin.
+
+  @param  bin	index of slab_pages.
+  @param  vm_id	owner of the page.
+  @return	pointer to the page.
+  @retval NULL	error.
+*/
+static SLAB_PAGE * slab_new_page(int bin, int vm_id)
+{
+  SLAB_PAGE *page = tlsf_alloc(MRBC_SLAB_PAGE_SIZE, vm_id, MRBC_ALLOC_FAST);
+  if( page == NULL ) return NULL;	// ENOMEM
+  BLOCK_TAIL(page)->s = FLAG_SLAB;
+
+  // make free slot list.
+  int n = SLAB_NUM_SLOTS(bin);
+  int slot_size = SLAB_SLOT_SIZE(bin);
+  uint8_t *p = (uint8_t *)page + SLAB_PAGE_TOP + slot_size * (n - 1);
+  SLAB_SLOT *next = NULL;
+  while( n-- > 0 ) {
+    SLAB_SLOT *slot = (SLAB_SLOT *)p;
+    slot->t = 0;
+    slot->f = FLAG_FREE_BLOCK;
+    slot->s = FLAG_SLAB;
+    slot->page_offset = p - (uint8_t *)page;
+    SLAB_SLOT_NEXT(slot) = next;
+    next = slot;
+    p -= slot_size;
+  }
+
+  page->free_slot = next;
+  page->n_used = 0;
+  page->bin = bin;
+  slab_link_page(page);
+  slab_empty_pages++;
+
+  return page;
+}
+
+
+//================================================================
+/*! allocate memory from slab
+
+  @param  size	request size. (<= MRBC_SLAB_MAX_SIZE)
+  @param  vm_id	owner of the object.
+  @return void * pointer to allocated memory.
+  @retval NULL	error.
+*/
+static void * slab_alloc(unsigned int size, int vm_id)
+{
+  int bin = SLAB_BIN(size);
+  SLAB_PAGE *page = slab_pages[vm_id][bin];
+  if( page == NULL ) {
+    page = slab_new_page(bin, vm_id);
+    if( page == NULL ) return NULL;	// ENOMEM
+  }
+
+  SLAB_SLOT *slot = page->free_slot;
+  page->free_slot = SLAB_SLOT_NEXT(slot);
+  if( page->n_used++ == 0 ) slab_empty_pages--;
+
+  // page is full. remove from the bin.
+  if( page->free_slot == NULL ) slab_unlink_page(page);
+
+  slot->f = FLAG_USED_BLOCK;
+  slot->vm_id = vm_id;
+
+  return SLAB_SLOT_PTR(slot);
+}
+
+
+//================================================================
+/*! return the slot to the page.
+
+  @param  page	pointer to the page.
+  @param  slot	pointer to the slot.
+*/
+static void slab_put(SLAB_PAGE *page, SLAB_SLOT *slot)
+{
+  // page was full. link to the bin again.
+  if( page->free_slot == NULL ) slab_link_page(page);
+
+  slot->f = FLAG_FREE_BLOCK;
+  SLAB_SLOT_NEXT(slot) = page->free_slot;
+  page->free_slot = slot;
+  page->n_used--;
+}
+
+
+//================================================================
+/*! release memory to slab
+
+  @param  ptr	Return value of slab_alloc()
+*/
+static void slab_free(void *ptr)
+{
+  SLAB_SLOT *slot = BLOCK_TAIL(ptr);
+  SLAB_PAGE *page = SLAB_SLOT_PAGE(slot);
+
+  slab_put(page, slot);
+  if( page->n_used != 0 ) return;
+
+  // release an empty page, but keep a few of them to avoid thrashing.
+  if( page->prev || page->next || slab_empty_pages >= SLAB_NUM_BINS ) {
+    slab_unlink_page(page);
+    tlsf_free(page);
+  } else {
+    slab_empty_pages++;
+  }
+}
+#endif
+
+
+
+//================================================================
+/*! allocate memory for the owner
+
+  @param  size	request size.
+  @param  vm_id	owner of the memory.
+  @return void * pointer to allocated memory.
+  @retval NULL	error.
+*/
+static void * alloc_block(unsigned int size, int vm_id)
+{
+  void *ptr;
+
+  int hook = 0;
+
+ RETRY:
+#if MRBC_SLAB_MAX_SIZE > 0
+  if( size <= MRBC_SLAB_MAX_SIZE ) {
+    ptr = slab_alloc(size, vm_id);
+  } else
+#endif
+  ptr = tlsf_alloc(size, vm_id,
+		   (size >= alloc_bulk_size) ? MRBC_ALLOC_SLOW : MRBC_ALLOC_FAST);
+  if( ptr ) {
+    // count in the size histogram.
+    unsigned int s = (size > 0 ? size - 1 : 0) >> 4;
+    int bin = 0;
+    while( s != 0 && bin < MRBC_ALLOC_HISTOGRAM_BINS - 1 ) {
+      s >>= 1;
+      bin++;
+    }
+    alloc_histogram[bin]++;
+
+    return ptr;
+  }
+
+  // let the hooks release memory, and try again.
+  // a hook is called once per request, and not in the hooks.
+  if( !in_low_memory_hooks ) {
+    while( hook < num_low_memory_hooks ) {
+      in_low_memory_hooks = 1;
+      int released = low_memory_hooks[hook++]( size );
+      in_low_memory_hooks = 0;
+      if( released ) goto RETRY;
+    }
+  }
+
+  // use the emergency reserve. (not for the hooks)
+  if( in_low_memory_hooks ) return NULL;
+  alloc_events |= MRBC_ALLOC_EVENT_CRITICAL;
+  if( alloc_reserve ) {
+    tlsf_free( alloc_reserve );
+    alloc_reserve = NULL;
+    goto RETRY;
+  }
+
+  // out of memory
+  console_print("Fatal error: Out of memory.\n");
+  return NULL;  // ENOMEM
+}
+
+
+
+//================================================================
+/*! allocate memory
+
+  @param  size	request size.
+  @return void * pointer to allocated memory.
+  @retval NULL	error.
+*/
+void * mrbc_raw_alloc(unsigned int size)
+{
+  void *ptr = alloc_block(size, 0);
+  TRACE(ALLOC, 0, size, NULL, ptr);
+
+  return ptr;
+}
+
+
+//================================================================
+/*! release memory, slab or TLSF.
+
+  @param  ptr	Return value of alloc_block()
+*/
+static void free_block(void *ptr)
+{
+#if MRBC_SLAB_MAX_SIZE > 0
+  if( IS_SLAB(ptr) ) {
+    slab_free(ptr);
+    return;
+  }
+#endif
+
+  tlsf_free(ptr);
+}
+
+
+//================================================================
+/*! release memory
 
   @param  ptr	Return value of mrbc_raw_alloc()
+*/
+void mrbc_raw_free(void *ptr)
+{
+  TRACE(FREE, GET_VM_ID(ptr), 0, ptr, NULL);
+  free_block(ptr);
+}
+
+
+//================================================================
+/*! re-allocate memory
+
+  @param  ptr	Return value of alloc_block()
   @param  size	request size
   @return void * pointer to allocated memory.
   @retval NULL	error.
 */
-void * mrbc_raw_realloc(void *ptr, unsigned int size)
+static void * realloc_block(void *ptr, unsigned int size)
 {
-  USED_BLOCK  *target     = (USED_BLOCK *)((uint8_t *)ptr - sizeof(USED_BLOCK));
+#if MRBC_SLAB_MAX_SIZE > 0
+  if( IS_SLAB(ptr) ) {
+    SLAB_SLOT *slot = BLOCK_TAIL(ptr);
+    unsigned int payload = SLAB_PAYLOAD(SLAB_SLOT_PAGE(slot)->bin);
+    if( size <= payload ) return ptr;
+
+    uint8_t *new_ptr = alloc_block(size, slot->vm_id);
+    if( new_ptr == NULL ) return NULL;  // ENOMEM
+
+    memcpy(new_ptr, ptr, payload);
+    slab_free(ptr);
+
+    return new_ptr;
+  }
+#endif
+
+  // use FREE_BLOCK type throughout, as merge_block() and split_block() do.
+  // (mixing the two header types breaks under strict aliasing)
+  FREE_BLOCK  *target     = (FREE_BLOCK *)((uint8_t *)ptr - sizeof(USED_BLOCK));
   unsigned int alloc_size = size + sizeof(FREE_BLOCK);
+  unsigned int old_size   = target->size;
 
   // align 4 byte
   alloc_size += ((4 - alloc_size) & 3);
@@ -443,8 +1071,8 @@ void * mrbc_raw_realloc(void *ptr, unsigned int size)
     if((target->t == FLAG_NOT_TAIL_BLOCK) &&
        (next->f == FLAG_FREE_BLOCK) &&
        ((target->size + next->size) >= alloc_size)) {
-      remove_index(next);
-      merge_block((FREE_BLOCK *)target, next);
+      remove_index(POOL_OF(target), next);
+      merge_block(target, next);
 
       // and fall through.
     }
@@ -452,34 +1080,55 @@ void * mrbc_raw_realloc(void *ptr, unsigned int size)
 
   // same size?
   if( alloc_size == target->size ) {
+    add_used(target->vm_id, (int)target->size - (int)old_size);
     return (uint8_t *)ptr;
   }
 
   // shrink?
   if( alloc_size < target->size ) {
-    FREE_BLOCK *release = split_block((FREE_BLOCK *)target, alloc_size);
+    FREE_BLOCK *release = split_block(target, alloc_size);
     if( release != NULL ) {
       // check next block, merge?
       FREE_BLOCK *next = (FREE_BLOCK *)PHYS_NEXT(release);
       if((release->t == FLAG_NOT_TAIL_BLOCK) && (next->f == FLAG_FREE_BLOCK)) {
-        remove_index(next);
+        remove_index(POOL_OF(target), next);
         merge_block(release, next);
       }
-      add_free_block(release);
+      add_free_block(POOL_OF(target), release);
     }
 
+    add_used(target->vm_id, (int)target->size - (int)old_size);
     return (uint8_t *)ptr;
   }
 
   // expand part2.
   // new alloc and copy
-  uint8_t *new_ptr = mrbc_raw_alloc(size);
+  uint8_t *new_ptr = alloc_block(size, target->vm_id);
   if( new_ptr == NULL ) return NULL;  // ENOMEM
 
-  memcpy(new_ptr, ptr, target->size - sizeof(USED_BLOCK));
-  SET_VM_ID(new_ptr, target->vm_id);
+  // new block may be a slab slot smaller than this block.
+  unsigned int copy_size = target->size - sizeof(USED_BLOCK);
+  if( copy_size > size ) copy_size = size;
+  memcpy(new_ptr, ptr, copy_size);
 
-  mrbc_raw_free(ptr);
+  free_block(ptr);
+
+  return new_ptr;
+}
+
+
+//================================================================
+/*! re-allocate memory
+
+  @param  ptr	Return value of mrbc_raw_alloc()
+  @param  size	request size
+  @return void * pointer to allocated memory.
+  @retval NULL	error.
+*/
+void * mrbc_raw_realloc(void *ptr, unsigned int size)
+{
+  void *new_ptr = realloc_block(ptr, size);
+  TRACE(REALLOC, GET_VM_ID(new_ptr ? new_ptr : ptr), size, ptr, new_ptr);
 
   return new_ptr;
 }
@@ -498,9 +1147,30 @@ void * mrbc_raw_realloc(void *ptr, unsigned int size)
 */
 void * mrbc_alloc(const mrb_vm *vm, unsigned int size)
 {
-  uint8_t *ptr = mrbc_raw_alloc(size);
-  if( ptr == NULL ) return NULL;	// ENOMEM
-  if( vm ) SET_VM_ID(ptr, vm->vm_id);
+  int vm_id = vm ? vm->vm_id : 0;
+  void *ptr = alloc_block(size, vm_id);
+  TRACE(ALLOC, vm_id, size, NULL, ptr);
+
+  return ptr;
+}
+
+
+//================================================================
+/*! allocate memory for the owner given by vm_id
+
+  Use this instead of mrbc_raw_alloc() and mrbc_set_vm_id(), if the
+  owner isn't vm_id 0. A slab object is placed in a page of the owner,
+  so it is released by mrbc_free_all() of the owner.
+
+  @param  vm_id	owner of the memory.
+  @param  size	request size.
+  @return void * pointer to allocated memory.
+  @retval NULL	error.
+*/
+void * mrbc_alloc_by_vm_id(int vm_id, unsigned int size)
+{
+  void *ptr = alloc_block(size, vm_id);
+  TRACE(ALLOC, vm_id, size, NULL, ptr);
 
   return ptr;
 }
@@ -536,27 +1206,53 @@ void mrbc_free(const mrb_vm *vm, void *ptr)
 //================================================================
 /*! release memory, vm used.
 
+  Only the blocks in the list of the VM are visited.
+
   @param  vm	pointer to VM.
 */
 void mrbc_free_all(const mrb_vm *vm)
 {
-  USED_BLOCK *ptr = (USED_BLOCK *)memory_pool;
-  void *free_target = NULL;
-  int flag_loop = 1;
   int vm_id = vm->vm_id;
+  USED_BLOCK *block = vm_blocks[vm_id];
+  TRACE(FREE_ALL, vm_id, 0, NULL, NULL);
+
+  while( block ) {
+    USED_BLOCK *next = block->next_vm;
+    uint8_t *ptr = (uint8_t *)block + sizeof(USED_BLOCK);
+
+#if MRBC_SLAB_MAX_SIZE > 0
+    if( block->s == FLAG_SLAB ) {
+      // release the slots in the page, and the page if empty.
+      SLAB_PAGE *page = (SLAB_PAGE *)ptr;
+      if( page->n_used == 0 ) slab_empty_pages--;
+      int slot_size = SLAB_SLOT_SIZE(page->bin);
+      uint8_t *p = ptr + SLAB_PAGE_TOP;
+      int n;
+      for( n = SLAB_NUM_SLOTS(page->bin); n > 0; n-- ) {
+	SLAB_SLOT *slot = (SLAB_SLOT *)p;
+	if( slot->f == FLAG_USED_BLOCK && slot->vm_id == vm_id ) {
+	  slab_put(page, slot);
+	}
+	p += slot_size;
+      }
 
-  while( flag_loop ) {
-    if( ptr->t == FLAG_TAIL_BLOCK ) flag_loop = 0;
-    if( ptr->f == FLAG_USED_BLOCK && ptr->vm_id == vm_id ) {
-      if( free_target ) {
-	mrbc_raw_free(free_target);
+      if( page->n_used == 0 ) {
+	slab_unlink_page(page);
+	tlsf_free(page);
+      } else {
+	// objects of the other VM remain. hand over the page to vm_id 0.
+	if( page->free_slot ) slab_unlink_page(page);
+	unlink_vm_block(block);
+	link_vm_block(block, 0);
+	if( page->free_slot ) slab_link_page(page);
       }
-      free_target = (char *)ptr + sizeof(USED_BLOCK);
+      block = next;
+      continue;
     }
-    ptr = (USED_BLOCK *)PHYS_NEXT(ptr);
-  }
-  if( free_target ) {
-    mrbc_raw_free(free_target);
+#endif
+
+    tlsf_free(ptr);
+    block = next;
   }
 }
 
@@ -564,12 +1260,31 @@ void mrbc_free_all(const mrb_vm *vm)
 //================================================================
 /*! set vm id
 
+  (note) A slab object stays in the page of the former owner.
+  When the former owner ends, the page is handed over to vm_id 0.
+  mrbc_free_all() visits only the pages of the VM, so a slab object
+  can't be given to the other VM. Use mrbc_alloc_by_vm_id() instead.
+
   @param  ptr	Return value of mrbc_alloc()
   @param  vm_id	vm id
 */
 void mrbc_set_vm_id(void *ptr, int vm_id)
 {
-  SET_VM_ID(ptr, vm_id);
+  TRACE(SET_VM_ID, vm_id, 0, ptr, NULL);
+
+#if MRBC_SLAB_MAX_SIZE > 0
+  if( IS_SLAB(ptr) ) {
+    assert( vm_id == 0 || vm_id == GET_VM_ID(SLAB_SLOT_PAGE(BLOCK_TAIL(ptr))) );
+    SET_VM_ID(ptr, vm_id);
+    return;
+  }
+#endif
+
+  USED_BLOCK *target = (USED_BLOCK *)((uint8_t *)ptr - sizeof(USED_BLOCK));
+  if( target->vm_id == vm_id ) return;
+
+  unlink_vm_block(target);
+  link_vm_block(target, vm_id);
 }
 
 
@@ -585,24 +1300,204 @@ int mrbc_get_vm_id(void *ptr)
 }
 
 
+//================================================================
+/*! get the size of the memory block
+
+  The header is included, as in mrbc_alloc_vm_used().
+  A slab object is counted by the size of its slot.
+
+  @param  ptr	Return value of mrbc_alloc()
+  @return int	size of the block.
+*/
+int mrbc_get_alloc_size(void *ptr)
+{
+#if MRBC_SLAB_MAX_SIZE > 0
+  if( IS_SLAB(ptr) ) {
+    return SLAB_SLOT_SIZE( SLAB_SLOT_PAGE(BLOCK_TAIL(ptr))->bin );
+  }
+#endif
+
+  USED_BLOCK *target = (USED_BLOCK *)((uint8_t *)ptr - sizeof(USED_BLOCK));
+  return target->size;
+}
+
 
-#ifdef MRBC_DEBUG
 //================================================================
 /*! statistics
 
+  Slab pages are counted as used by the owner VM.
+
+  @param  vm_id		vm_id
+  @return int		total used memory size
+*/
+int mrbc_alloc_vm_used( int vm_id )
+{
+  return vm_used[vm_id];
+}
+
+
+//================================================================
+/*! high-water mark of the used memory of the VM.
+
+  @param  vm_id		vm_id
+  @return int		peak used memory size
+*/
+int mrbc_alloc_vm_peak( int vm_id )
+{
+  return vm_peak[vm_id];
+}
+
+
+//================================================================
+/*! heap statistics
+
+  The counters are maintained on every alloc and free, so this does
+  not walk the pool.
+  largest_free is the largest request that surely succeeds. It is
+  taken from the bitmaps, and may be smaller than the largest free
+  block by up to two second level classes.
+
+  @param  stats		returns statistics.
+*/
+void mrbc_alloc_get_stats(MRBC_ALLOC_STATS *stats)
+{
+  stats->total = alloc_total;
+  stats->used = alloc_used;
+  stats->free = alloc_total - alloc_used;
+  stats->peak = alloc_peak;
+  stats->largest_free = 0;
+
+  int i;
+  for( i = 0; i < num_memory_pools; i++ ) {
+    MEMORY_POOL *pool = &memory_pools[i];
+    BITMAP_T fli_bitmap = pool->free_fli_bitmap;
+    if( fli_bitmap == 0 ) continue;
+
+    // the lowest bit is the largest list.
+    int fli = NLZ( fli_bitmap & (~fli_bitmap + 1) );
+    BITMAP_T sli_bitmap = pool->free_sli_bitmap[fli];
+    int sli = NLZ( sli_bitmap & (~sli_bitmap + 1) );
+
+    // find_free_block() finds a block in this list for the requests
+    // of the class below that of the blocks. (see add_free_block)
+    unsigned int size = (index_size((fli << MRBC_ALLOC_SLI_BIT_WIDTH) + sli + 1) - 1) & ~3;
+    if( size <= sizeof(FREE_BLOCK) ) continue;
+    size -= sizeof(FREE_BLOCK);
+    if( stats->largest_free < size ) stats->largest_free = size;
+  }
+
+  memcpy( stats->histogram, alloc_histogram, sizeof(alloc_histogram) );
+}
+
+
+//================================================================
+/*! reset the high-water marks to the current usage.
+*/
+void mrbc_alloc_reset_peak(void)
+{
+  int i;
+  for( i = 0; i <= MAX_VM_COUNT; i++ ) {
+    vm_peak[i] = vm_used[i];
+  }
+  alloc_peak = alloc_used;
+}
+
+
+//================================================================
+/*! add a low memory hook
+
+  The hooks are called in the order of addition when an allocation
+  fails, and the allocation is retried after a hook returns nonzero.
+  The emergency reserve is released after all hooks.
+  A hook must not depend on allocating memory.
+
+  @param  hook	function. returns nonzero if it may have released memory.
+  @retval 0	No error.
+  @retval -1	Too many hooks.
+*/
+int mrbc_add_low_memory_hook(mrbc_low_memory_hook hook)
+{
+  if( num_low_memory_hooks >= MRBC_LOW_MEMORY_HOOKS ) return -1;
+
+  low_memory_hooks[num_low_memory_hooks++] = hook;
+  return 0;
+}
+
+
+//================================================================
+/*! take the emergency reserve again, after it was released.
+
+  It is taken only while the used memory is under the warning level.
+  The scheduler calls this between the timeslices.
+
+  @retval 1	the reserve is held.
+  @retval 0	not held.
+*/
+int mrbc_alloc_restore_reserve(void)
+{
+  if( MRBC_ALLOC_RESERVE_SIZE == 0 ) return 0;
+  if( alloc_reserve ) return 1;
+  if( alloc_warning ) return 0;
+
+  alloc_reserve = tlsf_alloc( MRBC_ALLOC_RESERVE_SIZE, 0, MRBC_ALLOC_FAST );
+  return alloc_reserve != NULL;
+}
+
+
+//================================================================
+/*! set the watermarks of the used memory
+
+  MRBC_ALLOC_EVENT_WARNING occurs when the used memory goes above
+  warning, and MRBC_ALLOC_EVENT_RECOVERED when it goes back under
+  recover. mrbc_add_alloc_region() resets them to the default ratios.
+
+  @param  warning	warning level in bytes.
+  @param  recover	recover level in bytes. (<= warning)
+*/
+void mrbc_set_memory_watermark(unsigned int warning, unsigned int recover)
+{
+  alloc_warning_level = warning;
+  alloc_recover_level = (recover <= warning) ? recover : warning;
+  check_watermark();
+}
+
+
+//================================================================
+/*! get and clear the low memory events
+
+  @return	MRBC_ALLOC_EVENT_xxx bits occurred since the last call.
+*/
+int mrbc_alloc_get_events(void)
+{
+  int events = alloc_events;
+  alloc_events = 0;
+  return events;
+}
+
+
+
+#ifdef MRBC_DEBUG
+//================================================================
+/*! statistics of a region
+
+  @param  region	index of the region. (0: the block of mrbc_init_alloc)
   @param  *total	returns total memory.
   @param  *used		returns used memory.
   @param  *free		returns free memory.
   @param  *fragment	returns memory fragmentation
+  @retval 0		No error.
+  @retval -1		No such region.
 */
-void mrbc_alloc_statistics(int *total, int *used, int *free, int *fragmentation)
+int mrbc_alloc_region_statistics(int region, int *total, int *used, int *free, int *fragmentation)
 {
-  *total = memory_pool_size;
+  if( region < 0 || region >= num_memory_pools ) return -1;
+
+  *total = memory_pools[region].size;
   *used = 0;
   *free = 0;
   *fragmentation = 0;
 
-  USED_BLOCK *ptr = (USED_BLOCK *)memory_pool;
+  USED_BLOCK *ptr = (USED_BLOCK *)memory_pools[region].pool;
   int flag_used_free = ptr->f;
   while( 1 ) {
     if( ptr->f ) {
@@ -619,31 +1514,122 @@ void mrbc_alloc_statistics(int *total, int *used, int *free, int *fragmentation)
 
     ptr = (USED_BLOCK *)PHYS_NEXT(ptr);
   }
+
+  return 0;
 }
 
 
+//================================================================
+/*! statistics of all regions
 
+  @param  *total	returns total memory.
+  @param  *used		returns used memory.
+  @param  *free		returns free memory.
+  @param  *fragment	returns memory fragmentation
+*/
+void mrbc_alloc_statistics(int *total, int *used, int *free, int *fragmentation)
+{
+  *total = 0;
+  *used = 0;
+  *free = 0;
+  *fragmentation = 0;
+
+  int i;
+  for( i = 0; i < num_memory_pools; i++ ) {
+    int t, u, f, fr;
+    mrbc_alloc_region_statistics( i, &t, &u, &f, &fr );
+    *total += t;
+    *used += u;
+    *free += f;
+    *fragmentation += fr;
+  }
+}
+
+#endif
+
+
+
+#if MRBC_ALLOC_TRACE > 0
 //================================================================
-/*! statistics
+/*! record an allocation trace.
 
-  @param  vm_id		vm_id
-  @return int		total used memory size
+  If an allocation fails, the trace is dumped at the first time.
+
+  @param  op	MRBC_ALLOC_TRACE_xxx
+  @param  vm_id	owner VM.
+  @param  size	requested size.
+  @param  ptr	address given.
+  @param  ret	address returned.
 */
-int mrbc_alloc_vm_used( int vm_id )
+static void trace_record(int op, int vm_id, unsigned int size,
+			 const void *ptr, const void *ret)
 {
-  USED_BLOCK *ptr = (USED_BLOCK *)memory_pool;
-  int total = 0;
+  MRBC_ALLOC_TRACE_ENTRY *t = &alloc_trace[alloc_trace_pos];
 
-  while( 1 ) {
-    if( ptr->vm_id == vm_id && !ptr->f ) {
-      total += ptr->size;
-    }
-    if( ptr->t == FLAG_TAIL_BLOCK ) break;
+  t->op = op;
+  t->vm_id = vm_id;
+  t->tick = mrbc_get_tick();
+  t->size = size;
+  t->ptr = (uint32_t)(uintptr_t)ptr;
+  t->ret = (uint32_t)(uintptr_t)ret;
 
-    ptr = (USED_BLOCK *)PHYS_NEXT(ptr);
+  if( ++alloc_trace_pos >= MRBC_ALLOC_TRACE ) alloc_trace_pos = 0;
+  if( alloc_trace_count < MRBC_ALLOC_TRACE ) alloc_trace_count++;
+
+  if( ret == NULL && size != 0 && !alloc_trace_dumped ) {
+    alloc_trace_dumped = 1;
+    mrbc_alloc_trace_dump();
+  }
+}
+
+
+//================================================================
+/*! read the allocation trace, oldest first.
+
+  @param  buf	buffer.
+  @param  n	maximum number of entries to read.
+  @return	number of entries read.
+*/
+int mrbc_alloc_trace_read(MRBC_ALLOC_TRACE_ENTRY *buf, int n)
+{
+  unsigned int idx = alloc_trace_pos + MRBC_ALLOC_TRACE - alloc_trace_count;
+  int i;
+
+  for( i = 0; i < n && i < alloc_trace_count; i++ ) {
+    buf[i] = alloc_trace[(idx + i) % MRBC_ALLOC_TRACE];
   }
 
-  return total;
+  return i;
+}
+
+
+//================================================================
+/*! print the allocation trace, oldest first.
+
+  The output can be given to tools/alloc_replay.
+*/
+void mrbc_alloc_trace_dump(void)
+{
+  unsigned int idx = alloc_trace_pos + MRBC_ALLOC_TRACE - alloc_trace_count;
+  int i;
+
+  console_printf("== alloc trace %d\n", alloc_trace_count);
+  for( i = 0; i < alloc_trace_count; i++ ) {
+    const MRBC_ALLOC_TRACE_ENTRY *t = &alloc_trace[(idx + i) % MRBC_ALLOC_TRACE];
+    console_printf("%c %d %04x %x %08x %08x\n",
+		   t->op, t->vm_id, t->tick, t->size, t->ptr, t->ret);
+  }
+  console_printf("== end\n");
 }
 
+
+//================================================================
+/*! clear the allocation trace.
+*/
+void mrbc_alloc_trace_clear(void)
+{
+  alloc_trace_pos = 0;
+  alloc_trace_count = 0;
+  alloc_trace_dumped = 0;
+}
 #endif
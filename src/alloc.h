@@ -22,22 +22,77 @@
 extern "C" {
 #endif
 
+// speed class of memory region
+#define MRBC_ALLOC_FAST 0
+#define MRBC_ALLOC_SLOW 1
+
 void mrbc_init_alloc(void *ptr, unsigned int size);
+int mrbc_add_alloc_region(void *ptr, unsigned int size, int speed);
+void mrbc_set_alloc_policy(unsigned int bulk_size);
 void *mrbc_raw_alloc(unsigned int size);
 void *mrbc_raw_realloc(void *ptr, unsigned int size);
 void mrbc_raw_free(void *ptr);
 
 // for mruby/c
 void *mrbc_alloc(const mrb_vm *vm, unsigned int size);
+void *mrbc_alloc_by_vm_id(int vm_id, unsigned int size);
 void *mrbc_realloc(const mrb_vm *vm, void *ptr, unsigned int size);
 void mrbc_free(const mrb_vm *vm, void *ptr);
 void mrbc_free_all(const mrb_vm *vm);
 void mrbc_set_vm_id(void *ptr, int vm_id);
 int mrbc_get_vm_id(void *ptr);
+int mrbc_get_alloc_size(void *ptr);
+int mrbc_alloc_vm_used( int vm_id );
+int mrbc_alloc_vm_peak( int vm_id );
+
+// heap statistics. maintained on every alloc and free.
+typedef struct MRBC_ALLOC_STATS {
+  unsigned int total;		//!< total size of the regions.
+  unsigned int used;		//!< used, headers and slab pages included.
+  unsigned int free;		//!< total - used.
+  unsigned int peak;		//!< high-water mark of used.
+  unsigned int largest_free;	//!< largest free block. (see alloc.c)
+  uint32_t histogram[MRBC_ALLOC_HISTOGRAM_BINS];  //!< allocations by size.
+} MRBC_ALLOC_STATS;
+
+void mrbc_alloc_get_stats(MRBC_ALLOC_STATS *stats);
+void mrbc_alloc_reset_peak(void);
+
+// low memory handling.
+#define MRBC_ALLOC_EVENT_WARNING   0x01	// used memory is above the warning level.
+#define MRBC_ALLOC_EVENT_CRITICAL  0x02	// hooks did not help. reserve released.
+#define MRBC_ALLOC_EVENT_RECOVERED 0x04	// used memory is under the recover level.
+
+typedef int (*mrbc_low_memory_hook)(unsigned int size);
+
+int mrbc_add_low_memory_hook(mrbc_low_memory_hook hook);
+int mrbc_alloc_restore_reserve(void);
+void mrbc_set_memory_watermark(unsigned int warning, unsigned int recover);
+int mrbc_alloc_get_events(void);
+
+// allocation trace. (need MRBC_ALLOC_TRACE > 0)
+#define MRBC_ALLOC_TRACE_ALLOC   'a'	// mrbc_raw_alloc, mrbc_alloc
+#define MRBC_ALLOC_TRACE_REALLOC 'r'	// mrbc_raw_realloc, mrbc_realloc
+#define MRBC_ALLOC_TRACE_FREE    'f'	// mrbc_raw_free, mrbc_free
+#define MRBC_ALLOC_TRACE_FREE_ALL 'F'	// mrbc_free_all
+#define MRBC_ALLOC_TRACE_SET_VM_ID 'v'	// mrbc_set_vm_id
+
+typedef struct MRBC_ALLOC_TRACE_ENTRY {
+  uint8_t  op;		//!< MRBC_ALLOC_TRACE_xxx
+  uint8_t  vm_id;	//!< owner VM. (new owner for set_vm_id)
+  uint16_t tick;	//!< lower 16 bits of the tick counter.
+  uint32_t size;	//!< requested size.
+  uint32_t ptr;		//!< address given. (realloc, free, set_vm_id)
+  uint32_t ret;		//!< address returned. (alloc, realloc) 0 if failed.
+} MRBC_ALLOC_TRACE_ENTRY;
+
+int mrbc_alloc_trace_read(MRBC_ALLOC_TRACE_ENTRY *buf, int n);
+void mrbc_alloc_trace_dump(void);
+void mrbc_alloc_trace_clear(void);
 
 // for statistics or debug. (need #define MRBC_DEBUG)
 void mrbc_alloc_statistics(int *total, int *used, int *free, int *fragmentation);
-int mrbc_alloc_vm_used( int vm_id );
+int mrbc_alloc_region_statistics(int region, int *total, int *used, int *free, int *fragmentation);
 
 #ifdef __cplusplus
 }
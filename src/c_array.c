@@ -22,7 +22,6 @@
 #include "class.h"
 #include "c_array.h"
 #include "console.h"
-#include "opcode.h"
 
 /*
   function summary
@@ -49,6 +48,8 @@
 
  (others)
     mrbc_array_resize
+    mrbc_array_reserve
+    mrbc_array_shrink_to_fit
     mrbc_array_clear
     mrbc_array_compare
     mrbc_array_minmax
@@ -64,7 +65,7 @@
 */
 mrb_value mrbc_array_new(struct VM *vm, int size)
 {
-  mrb_value value = {.tt = MRB_TT_ARRAY};
+  mrb_value value = MRBC_VALUE_INIT(MRB_TT_ARRAY);
 
   /*
     Allocate handle and data buffer.
@@ -80,6 +81,7 @@ mrb_value mrbc_array_new(struct VM *vm, int size)
 
   h->ref_count = 1;
   h->tt = MRB_TT_ARRAY;
+  h->gc_flag = 0;
   h->data_size = size;
   h->n_stored = 0;
   h->data = data;
@@ -139,6 +141,8 @@ int mrbc_array_resize(mrb_value *ary, int size)
 {
   mrb_array *h = ary->array;
 
+  if( size > 0xffff ) return E_NOMEMORY_ERROR;	// over the data_size.
+
   mrb_value *data2 = mrbc_raw_realloc(h->data, sizeof(mrb_value) * size);
   if( !data2 ) return E_NOMEMORY_ERROR;	// ENOMEM
 
@@ -149,6 +153,35 @@ int mrbc_array_resize(mrb_value *ary, int size)
 }
 
 
+//================================================================
+/*! reserve buffer
+
+  @param  ary	pointer to target value
+  @param  size	number of elements to be stored without resize.
+  @return	mrb_error_code
+*/
+int mrbc_array_reserve(mrb_value *ary, int size)
+{
+  if( size <= ary->array->data_size ) return 0;
+
+  return mrbc_array_resize(ary, size);
+}
+
+
+//================================================================
+/*! shrink buffer to the number of stored data
+
+  @param  ary	pointer to target value
+  @return	mrb_error_code
+*/
+int mrbc_array_shrink_to_fit(mrb_value *ary)
+{
+  if( ary->array->n_stored == ary->array->data_size ) return 0;
+
+  return mrbc_array_resize(ary, ary->array->n_stored);
+}
+
+
 //================================================================
 /*! setter
 
@@ -167,8 +200,11 @@ int mrbc_array_set(mrb_value *ary, int idx, mrb_value *set_val)
   }
 
   // need resize?
-  if( idx >= h->data_size && mrbc_array_resize(ary, idx + 1) != 0 ) {
-    return E_NOMEMORY_ERROR;			// ENOMEM
+  if( idx >= h->data_size ) {
+    int size = mrbc_grow_size(h->data_size);
+    if( size <= idx ) size = idx + 1;
+    if( mrbc_array_resize(ary, size) != 0 )
+      return E_NOMEMORY_ERROR;			// ENOMEM
   }
 
   if( idx < h->n_stored ) {
@@ -219,7 +255,7 @@ int mrbc_array_push(mrb_value *ary, mrb_value *set_val)
   mrb_array *h = ary->array;
 
   if( h->n_stored >= h->data_size ) {
-    int size = h->data_size + 6;
+    int size = mrbc_grow_size(h->data_size);
     if( mrbc_array_resize(ary, size) != 0 )
       return E_NOMEMORY_ERROR;		// ENOMEM
   }
@@ -299,7 +335,7 @@ int mrbc_array_insert(mrb_value *ary, int idx, mrb_value *set_val)
   if( idx >= h->data_size ) {
     size = idx + 1;
   } else if( h->n_stored >= h->data_size ) {
-    size = h->data_size + 1;
+    size = mrbc_grow_size(h->data_size);
   }
   if( size && mrbc_array_resize(ary, size) != 0 ) {
     return E_NOMEMORY_ERROR;			// ENOMEM
@@ -449,13 +485,13 @@ static void c_array_new(mrb_vm *vm, mrb_value v[], int argc)
   /*
     in case of new(num)
   */
-  if( argc == 1 && v[1].tt == MRB_TT_FIXNUM && v[1].i >= 0 ) {
-    mrb_value ret = mrbc_array_new(vm, v[1].i);
+  if( argc == 1 && mrbc_type(v[1]) == MRB_TT_FIXNUM && mrbc_integer(v[1]) >= 0 ) {
+    mrb_value ret = mrbc_array_new(vm, mrbc_integer(v[1]));
     if( ret.array == NULL ) return;		// ENOMEM
 
     mrb_value nil = mrb_nil_value();
-    if( v[1].i > 0 ) {
-      mrbc_array_set(&ret, v[1].i - 1, &nil);
+    if( mrbc_integer(v[1]) > 0 ) {
+      mrbc_array_set(&ret, mrbc_integer(v[1]) - 1, &nil);
     }
     SET_RETURN(ret);
     return;
@@ -464,12 +500,12 @@ static void c_array_new(mrb_vm *vm, mrb_value v[], int argc)
   /*
     in case of new(num, value)
   */
-  if( argc == 2 && v[1].tt == MRB_TT_FIXNUM && v[1].i >= 0 ) {
-    mrb_value ret = mrbc_array_new(vm, v[1].i);
+  if( argc == 2 && mrbc_type(v[1]) == MRB_TT_FIXNUM && mrbc_integer(v[1]) >= 0 ) {
+    mrb_value ret = mrbc_array_new(vm, mrbc_integer(v[1]));
     if( ret.array == NULL ) return;		// ENOMEM
 
     int i;
-    for( i = 0; i < v[1].i; i++ ) {
+    for( i = 0; i < mrbc_integer(v[1]); i++ ) {
       mrbc_dup(&v[2]);
       mrbc_array_set(&ret, i, &v[2]);
     }
@@ -525,8 +561,8 @@ static void c_array_get(mrb_vm *vm, mrb_value v[], int argc)
   /*
     in case of self[nth] -> object | nil
   */
-  if( argc == 1 && v[1].tt == MRB_TT_FIXNUM ) {
-    mrb_value ret = mrbc_array_get(v, v[1].i);
+  if( argc == 1 && mrbc_type(v[1]) == MRB_TT_FIXNUM ) {
+    mrb_value ret = mrbc_array_get(v, mrbc_integer(v[1]));
     mrbc_dup(&ret);
     SET_RETURN(ret);
     return;
@@ -535,13 +571,13 @@ static void c_array_get(mrb_vm *vm, mrb_value v[], int argc)
   /*
     in case of self[start, length] -> Array | nil
   */
-  if( argc == 2 && v[1].tt == MRB_TT_FIXNUM && v[2].tt == MRB_TT_FIXNUM ) {
+  if( argc == 2 && mrbc_type(v[1]) == MRB_TT_FIXNUM && mrbc_type(v[2]) == MRB_TT_FIXNUM ) {
     int len = mrbc_array_size(&v[0]);
-    int idx = v[1].i;
+    int idx = mrbc_integer(v[1]);
     if( idx < 0 ) idx += len;
     if( idx < 0 ) goto RETURN_NIL;
 
-    int size = (v[2].i < (len - idx)) ? v[2].i : (len - idx);
+    int size = (mrbc_integer(v[2]) < (len - idx)) ? mrbc_integer(v[2]) : (len - idx);
 					// min( v[2].i, (len - idx) )
     if( size < 0 ) goto RETURN_NIL;
 
@@ -550,7 +586,7 @@ static void c_array_get(mrb_vm *vm, mrb_value v[], int argc)
 
     int i;
     for( i = 0; i < size; i++ ) {
-      mrb_value val = mrbc_array_get(v, v[1].i + i);
+      mrb_value val = mrbc_array_get(v, mrbc_integer(v[1]) + i);
       mrbc_dup(&val);
       mrbc_array_push(&ret, &val);
     }
@@ -578,16 +614,16 @@ static void c_array_set(mrb_vm *vm, mrb_value v[], int argc)
   /*
     in case of self[nth] = val
   */
-  if( argc == 2 && v[1].tt == MRB_TT_FIXNUM ) {
-    mrbc_array_set(v, v[1].i, &v[2]);	// raise? IndexError or ENOMEM
-    v[2].tt = MRB_TT_EMPTY;
+  if( argc == 2 && mrbc_type(v[1]) == MRB_TT_FIXNUM ) {
+    mrbc_array_set(v, mrbc_integer(v[1]), &v[2]);	// raise? IndexError or ENOMEM
+    mrbc_set_tt(&v[2], MRB_TT_EMPTY);
     return;
   }
 
   /*
     in case of self[start, length] = val
   */
-  if( argc == 3 && v[1].tt == MRB_TT_FIXNUM && v[2].tt == MRB_TT_FIXNUM ) {
+  if( argc == 3 && mrbc_type(v[1]) == MRB_TT_FIXNUM && mrbc_type(v[2]) == MRB_TT_FIXNUM ) {
     // TODO: not implement yet.
   }
 
@@ -607,6 +643,29 @@ static void c_array_clear(mrb_vm *vm, mrb_value v[], int argc)
 }
 
 
+//================================================================
+/*! (method) reserve
+*/
+static void c_array_reserve(mrb_vm *vm, mrb_value v[], int argc)
+{
+  if( argc != 1 || GET_TT_ARG(1) != MRB_TT_FIXNUM || GET_INT_ARG(1) < 0 ) {
+    console_print( "ArgumentError\n" );	// raise?
+    return;
+  }
+
+  mrbc_array_reserve(v, GET_INT_ARG(1));
+}
+
+
+//================================================================
+/*! (method) shrink_to_fit
+*/
+static void c_array_shrink_to_fit(mrb_vm *vm, mrb_value v[], int argc)
+{
+  mrbc_array_shrink_to_fit(v);
+}
+
+
 //================================================================
 /*! (method) delete_at
 */
@@ -693,7 +752,7 @@ static void c_array_last(mrb_vm *vm, mrb_value v[], int argc)
 static void c_array_push(mrb_vm *vm, mrb_value v[], int argc)
 {
   mrbc_array_push(&v[0], &v[1]);	// raise? ENOMEM
-  v[1].tt = MRB_TT_EMPTY;
+  mrbc_set_tt(&v[1], MRB_TT_EMPTY);
 }
 
 
@@ -714,7 +773,7 @@ static void c_array_pop(mrb_vm *vm, mrb_value v[], int argc)
   /*
     in case of pop(n) -> Array
   */
-  if( argc == 1 && v[1].tt == MRB_TT_FIXNUM ) {
+  if( argc == 1 && mrbc_type(v[1]) == MRB_TT_FIXNUM ) {
     // TODO: not implement yet.
   }
 
@@ -731,7 +790,7 @@ static void c_array_pop(mrb_vm *vm, mrb_value v[], int argc)
 static void c_array_unshift(mrb_vm *vm, mrb_value v[], int argc)
 {
   mrbc_array_unshift(&v[0], &v[1]);	// raise? IndexError or ENOMEM
-  v[1].tt = MRB_TT_EMPTY;
+  mrbc_set_tt(&v[1], MRB_TT_EMPTY);
 }
 
 
@@ -752,7 +811,7 @@ static void c_array_shift(mrb_vm *vm, mrb_value v[], int argc)
   /*
     in case of pop(n) -> Array
   */
-  if( argc == 1 && v[1].tt == MRB_TT_FIXNUM ) {
+  if( argc == 1 && mrbc_type(v[1]) == MRB_TT_FIXNUM ) {
     // TODO: not implement yet.
   }
 
@@ -792,46 +851,17 @@ static void c_array_dup(mrb_vm *vm, mrb_value v[], int argc)
 */
 static void c_array_each(mrb_vm *vm, mrb_value v[], int argc)
 {
-  uint32_t code[2] = {
-    MKOPCODE(OP_CALL) | MKARG_A(argc),
-    MKOPCODE(OP_ABORT)
-  };
-  mrb_irep irep = {
-    0,     // nlocals
-    0,     // nregs
-    0,     // rlen
-    2,     // ilen
-    0,     // plen
-    (uint8_t *)code,   // iseq
-    NULL,  // pools
-    NULL,  // ptr_to_sym
-    NULL,  // reps
-  };
-
-  // array size
-  int n = v[0].array->n_stored;
-
-  mrbc_push_callinfo(vm, 0);
-
-  // adjust reg_top for reg[0]==Proc
-  vm->current_regs += v - vm->regs + 1;
+  // v[argc+1]: block, v[argc+2]: index of the next element.
+  mrb_value *block = &v[argc+1];
+  int i = vm->flag_resume ? mrbc_integer(block[1]) : 0;
 
-  int i;
-  for( i=0 ; i<n ; i++ ){
-    // set index
-    mrbc_release( &v[2] );
-    v[2] = mrbc_array_get(v, i);
-    mrbc_dup( &v[2] );
+  if( i >= v[0].array->n_stored ) return;	// returns self
 
-    // set OP_CALL irep
-    vm->pc = 0;
-    vm->pc_irep = &irep;
-
-    // execute OP_CALL
-    mrbc_vm_run(vm);
-  }
+  mrbc_release( &block[1] );
+  mrbc_set_integer( &block[1], i+1 );
 
-  mrbc_pop_callinfo(vm);
+  mrb_value value = mrbc_array_get(v, i);
+  mrbc_yield(vm, block, &value, 1);
 }
 
 
@@ -914,6 +944,8 @@ void mrbc_init_class_array(struct VM *vm)
   mrbc_define_method(vm, mrbc_class_array, "[]=", c_array_set);
   mrbc_define_method(vm, mrbc_class_array, "<<", c_array_push);
   mrbc_define_method(vm, mrbc_class_array, "clear", c_array_clear);
+  mrbc_define_method(vm, mrbc_class_array, "reserve", c_array_reserve);
+  mrbc_define_method(vm, mrbc_class_array, "shrink_to_fit", c_array_shrink_to_fit);
   mrbc_define_method(vm, mrbc_class_array, "delete_at", c_array_delete_at);
   mrbc_define_method(vm, mrbc_class_array, "empty?", c_array_empty);
   mrbc_define_method(vm, mrbc_class_array, "size", c_array_size);
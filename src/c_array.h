@@ -40,6 +40,8 @@ mrb_value mrbc_array_new(struct VM *vm, int size);
 void mrbc_array_delete(mrb_value *ary);
 void mrbc_array_clear_vm_id(mrb_value *ary);
 int mrbc_array_resize(mrb_value *ary, int size);
+int mrbc_array_reserve(mrb_value *ary, int size);
+int mrbc_array_shrink_to_fit(mrb_value *ary);
 int mrbc_array_set(mrb_value *ary, int idx, mrb_value *set_val);
 mrb_value mrbc_array_get(mrb_value *ary, int idx);
 int mrbc_array_push(mrb_value *ary, mrb_value *set_val);
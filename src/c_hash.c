@@ -22,6 +22,7 @@
 #include "class.h"
 #include "c_array.h"
 #include "c_hash.h"
+#include "console.h"
 
 /*
   function summary
@@ -54,7 +55,7 @@
 */
 mrb_value mrbc_hash_new(struct VM *vm, int size)
 {
-  mrb_value value = {.tt = MRB_TT_HASH};
+  mrb_value value = MRBC_VALUE_INIT(MRB_TT_HASH);
 
   /*
     Allocate handle and data buffer.
@@ -70,6 +71,7 @@ mrb_value mrbc_hash_new(struct VM *vm, int size)
 
   h->ref_count = 1;
   h->tt = MRB_TT_HASH;
+  h->gc_flag = 0;
   h->data_size = size * 2;
   h->n_stored = 0;
   h->data = data;
@@ -300,8 +302,8 @@ static void c_hash_set(mrb_vm *vm, mrb_value v[], int argc)
   mrb_value *v1 = &GET_ARG(1);
   mrb_value *v2 = &GET_ARG(2);
   mrbc_hash_set(v, v1, v2);
-  v1->tt = MRB_TT_EMPTY;
-  v2->tt = MRB_TT_EMPTY;
+  mrbc_set_tt(v1, MRB_TT_EMPTY);
+  mrbc_set_tt(v2, MRB_TT_EMPTY);
 }
 
 
@@ -314,6 +316,29 @@ static void c_hash_clear(mrb_vm *vm, mrb_value v[], int argc)
 }
 
 
+//================================================================
+/*! (method) reserve
+*/
+static void c_hash_reserve(mrb_vm *vm, mrb_value v[], int argc)
+{
+  if( argc != 1 || GET_TT_ARG(1) != MRB_TT_FIXNUM || GET_INT_ARG(1) < 0 ) {
+    console_print( "ArgumentError\n" );	// raise?
+    return;
+  }
+
+  mrbc_hash_reserve(v, GET_INT_ARG(1));
+}
+
+
+//================================================================
+/*! (method) shrink_to_fit
+*/
+static void c_hash_shrink_to_fit(mrb_vm *vm, mrb_value v[], int argc)
+{
+  mrbc_hash_shrink_to_fit(v);
+}
+
+
 //================================================================
 /*! (method) dup
 */
@@ -510,6 +535,8 @@ void mrbc_init_class_hash(struct VM *vm)
   mrbc_define_method(vm, mrbc_class_hash, "[]",		c_hash_get);
   mrbc_define_method(vm, mrbc_class_hash, "[]=",	c_hash_set);
   mrbc_define_method(vm, mrbc_class_hash, "clear",	c_hash_clear);
+  mrbc_define_method(vm, mrbc_class_hash, "reserve",	c_hash_reserve);
+  mrbc_define_method(vm, mrbc_class_hash, "shrink_to_fit", c_hash_shrink_to_fit);
   mrbc_define_method(vm, mrbc_class_hash, "dup",	c_hash_dup);
   mrbc_define_method(vm, mrbc_class_hash, "delete",	c_hash_delete);
   mrbc_define_method(vm, mrbc_class_hash, "empty?",	c_hash_empty);
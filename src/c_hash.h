@@ -84,6 +84,22 @@ inline static int mrbc_hash_resize(mrb_value *hash, int size)
   return mrbc_array_resize(hash, size * 2);
 }
 
+//================================================================
+/*! reserve buffer
+*/
+inline static int mrbc_hash_reserve(mrb_value *hash, int size)
+{
+  return mrbc_array_reserve(hash, size * 2);
+}
+
+//================================================================
+/*! shrink buffer to the number of stored data
+*/
+inline static int mrbc_hash_shrink_to_fit(mrb_value *hash)
+{
+  return mrbc_array_shrink_to_fit(hash);
+}
+
 
 //================================================================
 /*! iterator constructor
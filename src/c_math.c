@@ -22,13 +22,13 @@
 #if MRBC_USE_FLOAT && MRBC_USE_MATH
 
 //================================================================
-/*! convert mrb_value to c double
+/*! convert mrb_value to c float (double or float)
 */
-static double to_double( const mrb_value *v )
+static mrbc_float_t to_float( const mrb_value *v )
 {
-  switch( v->tt ) {
-  case MRB_TT_FIXNUM:	return (double)v->i;
-  case MRB_TT_FLOAT:	return v->d;
+  switch( mrbc_type(*v) ) {
+  case MRB_TT_FIXNUM:	return (mrbc_float_t)mrbc_integer(*v);
+  case MRB_TT_FLOAT:	return mrbc_float(*v);
   default:		return 0;	// TypeError. raise?
   }
 }
@@ -40,7 +40,7 @@ static double to_double( const mrb_value *v )
 */
 static void c_math_acos(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( acos( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(acos)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -48,7 +48,7 @@ static void c_math_acos(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_acosh(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( acosh( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(acosh)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -56,7 +56,7 @@ static void c_math_acosh(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_asin(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( asin( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(asin)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -64,7 +64,7 @@ static void c_math_asin(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_asinh(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( asinh( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(asinh)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -72,7 +72,7 @@ static void c_math_asinh(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_atan(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( atan( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(atan)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -80,7 +80,7 @@ static void c_math_atan(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_atan2(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( atan2( to_double(&v[1]), to_double(&v[2]) ));
+  v[0] = mrb_float_value( MRBC_MATH(atan2)( to_float(&v[1]), to_float(&v[2]) ));
 }
 
 //================================================================
@@ -88,7 +88,7 @@ static void c_math_atan2(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_atanh(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( atanh( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(atanh)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -96,7 +96,7 @@ static void c_math_atanh(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_cbrt(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( cbrt( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(cbrt)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -104,7 +104,7 @@ static void c_math_cbrt(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_cos(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( cos( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(cos)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -112,7 +112,7 @@ static void c_math_cos(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_cosh(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( cosh( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(cosh)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -120,7 +120,7 @@ static void c_math_cosh(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_erf(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( erf( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(erf)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -128,7 +128,7 @@ static void c_math_erf(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_erfc(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( erfc( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(erfc)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -136,7 +136,7 @@ static void c_math_erfc(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_exp(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( exp( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(exp)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -144,7 +144,7 @@ static void c_math_exp(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_hypot(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( hypot( to_double(&v[1]), to_double(&v[2]) ));
+  v[0] = mrb_float_value( MRBC_MATH(hypot)( to_float(&v[1]), to_float(&v[2]) ));
 }
 
 //================================================================
@@ -153,13 +153,13 @@ static void c_math_hypot(struct VM *vm, mrb_value v[], int argc)
 static void c_math_ldexp(struct VM *vm, mrb_value v[], int argc)
 {
   int exp;
-  switch( v[2].tt ) {
-  case MRB_TT_FIXNUM:	exp = v[2].i;		break;
-  case MRB_TT_FLOAT:	exp = (int)v[2].d;	break;
+  switch( mrbc_type(v[2]) ) {
+  case MRB_TT_FIXNUM:	exp = mrbc_integer(v[2]);		break;
+  case MRB_TT_FLOAT:	exp = (int)mrbc_float(v[2]);	break;
   default:		exp = 0;	// TypeError. raise?
   }
 
-  v[0] = mrb_float_value( ldexp( to_double(&v[1]), exp ));
+  v[0] = mrb_float_value( MRBC_MATH(ldexp)( to_float(&v[1]), exp ));
 }
 
 //================================================================
@@ -167,7 +167,7 @@ static void c_math_ldexp(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_log(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( log( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(log)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -175,7 +175,7 @@ static void c_math_log(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_log10(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( log10( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(log10)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -183,7 +183,7 @@ static void c_math_log10(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_log2(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( log2( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(log2)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -191,7 +191,7 @@ static void c_math_log2(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_sin(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( sin( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(sin)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -199,7 +199,7 @@ static void c_math_sin(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_sinh(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( sinh( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(sinh)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -207,7 +207,7 @@ static void c_math_sinh(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_sqrt(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( sqrt( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(sqrt)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -215,7 +215,7 @@ static void c_math_sqrt(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_tan(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( tan( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(tan)( to_float(&v[1]) ));
 }
 
 //================================================================
@@ -223,7 +223,7 @@ static void c_math_tan(struct VM *vm, mrb_value v[], int argc)
 */
 static void c_math_tanh(struct VM *vm, mrb_value v[], int argc)
 {
-  v[0] = mrb_float_value( tanh( to_double(&v[1]) ));
+  v[0] = mrb_float_value( MRBC_MATH(tanh)( to_float(&v[1]) ));
 }
 
 
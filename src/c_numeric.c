@@ -13,7 +13,6 @@
 
 
 #include "vm_config.h"
-#include "opcode.h"
 #include <stdio.h>
 #if MRBC_USE_FLOAT
 #include <math.h>
@@ -32,8 +31,8 @@
  */
 static void c_fixnum_bitref(mrb_vm *vm, mrb_value v[], int argc)
 {
-  if( 0 <= v[1].i && v[1].i < 32 ) {
-    SET_INT_RETURN( (v[0].i & (1 << v[1].i)) ? 1 : 0 );
+  if( 0 <= mrbc_integer(v[1]) && mrbc_integer(v[1]) < 32 ) {
+    SET_INT_RETURN( (mrbc_integer(v[0]) & (1 << mrbc_integer(v[1]))) ? 1 : 0 );
   } else {
     SET_INT_RETURN( 0 );
   }
@@ -55,20 +54,20 @@ static void c_fixnum_negative(mrb_vm *vm, mrb_value v[], int argc)
  */
 static void c_fixnum_power(mrb_vm *vm, mrb_value v[], int argc)
 {
-  if( v[1].tt == MRB_TT_FIXNUM ) {
+  if( mrbc_type(v[1]) == MRB_TT_FIXNUM ) {
     int32_t x = 1;
     int i;
 
-    if( v[1].i < 0 ) x = 0;
-    for( i = 0; i < v[1].i; i++ ) {
-      x *= v[0].i;;
+    if( mrbc_integer(v[1]) < 0 ) x = 0;
+    for( i = 0; i < mrbc_integer(v[1]); i++ ) {
+      x *= mrbc_integer(v[0]);;
     }
     SET_INT_RETURN( x );
   }
 
 #if MRBC_USE_FLOAT && MRBC_USE_MATH
-  else if( v[1].tt == MRB_TT_FLOAT ) {
-    SET_FLOAT_RETURN( pow( v[0].i, v[1].d ) );
+  else if( mrbc_type(v[1]) == MRB_TT_FLOAT ) {
+    SET_FLOAT_RETURN( MRBC_MATH(pow)( mrbc_integer(v[0]), mrbc_float(v[1]) ) );
   }
 #endif
 }
@@ -80,7 +79,7 @@ static void c_fixnum_power(mrb_vm *vm, mrb_value v[], int argc)
 static void c_fixnum_mod(mrb_vm *vm, mrb_value v[], int argc)
 {
   int32_t num = GET_INT_ARG(1);
-  SET_INT_RETURN( v->i % num );
+  SET_INT_RETURN( mrbc_integer(*v) % num );
 }
 
 
@@ -90,7 +89,7 @@ static void c_fixnum_mod(mrb_vm *vm, mrb_value v[], int argc)
 static void c_fixnum_and(mrb_vm *vm, mrb_value v[], int argc)
 {
   int32_t num = GET_INT_ARG(1);
-  SET_INT_RETURN(v->i & num);
+  SET_INT_RETURN(mrbc_integer(*v) & num);
 }
 
 
@@ -100,7 +99,7 @@ static void c_fixnum_and(mrb_vm *vm, mrb_value v[], int argc)
 static void c_fixnum_or(mrb_vm *vm, mrb_value v[], int argc)
 {
   int32_t num = GET_INT_ARG(1);
-  SET_INT_RETURN(v->i | num);
+  SET_INT_RETURN(mrbc_integer(*v) | num);
 }
 
 
@@ -110,7 +109,7 @@ static void c_fixnum_or(mrb_vm *vm, mrb_value v[], int argc)
 static void c_fixnum_xor(mrb_vm *vm, mrb_value v[], int argc)
 {
   int32_t num = GET_INT_ARG(1);
-  SET_INT_RETURN( v->i ^ num );
+  SET_INT_RETURN( mrbc_integer(*v) ^ num );
 }
 
 
@@ -148,7 +147,7 @@ static int32_t shift(int32_t x, int32_t y)
 static void c_fixnum_lshift(mrb_vm *vm, mrb_value v[], int argc)
 {
   int num = GET_INT_ARG(1);
-  SET_INT_RETURN( shift(v->i, num) );
+  SET_INT_RETURN( shift(mrbc_integer(*v), num) );
 }
 
 
@@ -158,7 +157,7 @@ static void c_fixnum_lshift(mrb_vm *vm, mrb_value v[], int argc)
 static void c_fixnum_rshift(mrb_vm *vm, mrb_value v[], int argc)
 {
   int num = GET_INT_ARG(1);
-  SET_INT_RETURN( shift(v->i, -num) );
+  SET_INT_RETURN( shift(mrbc_integer(*v), -num) );
 }
 
 
@@ -167,8 +166,8 @@ static void c_fixnum_rshift(mrb_vm *vm, mrb_value v[], int argc)
 */
 static void c_fixnum_abs(mrb_vm *vm, mrb_value v[], int argc)
 {
-  if( v[0].i < 0 ) {
-    v[0].i = -v[0].i;
+  if( mrbc_integer(v[0]) < 0 ) {
+    mrbc_integer(v[0]) = -mrbc_integer(v[0]);
   }
 }
 
@@ -179,7 +178,7 @@ static void c_fixnum_abs(mrb_vm *vm, mrb_value v[], int argc)
 */
 static void c_fixnum_to_f(mrb_vm *vm, mrb_value v[], int argc)
 {
-  double f = GET_INT_ARG(0);
+  mrbc_float_t f = GET_INT_ARG(0);
   SET_FLOAT_RETURN( f );
 }
 #endif
@@ -190,52 +189,17 @@ static void c_fixnum_to_f(mrb_vm *vm, mrb_value v[], int argc)
 */
 static void c_fixnum_times(mrb_vm *vm, mrb_value v[], int argc)
 {
-  uint32_t code[2] = {
-    MKOPCODE(OP_CALL) | MKARG_A(argc),
-    MKOPCODE(OP_ABORT)
-  };
-  mrb_irep irep = {
-    0,     // nlocals
-    0,     // nregs
-    0,     // rlen
-    2,     // ilen
-    0,     // plen
-    (uint8_t *)code,   // iseq
-    NULL,  // pools
-    NULL,  // ptr_to_sym
-    NULL,  // reps
-  };
-
-  // count of times
-  int cnt = v[0].i;
-
-  mrb_value block = v[1];
-  mrbc_dup(&block);
-
-  mrbc_push_callinfo(vm, 0);
-
-  // adjust reg_top for reg[0]==Proc
-  vm->current_regs += v - vm->regs + 1;
-
-  int i;
-  for( i=0 ; i<cnt ; i++ ){
-    if(v[1].tt!=MRB_TT_PROC){//TODO:in normal case, ref is increased. Need to be checked
-      v[1]=block;
-      if(block.proc->ref_count < 2) mrbc_dup(&block);
-    }
-    // set index
-    mrbc_release( &v[2] );
-    v[2].tt = MRB_TT_FIXNUM;
-    v[2].i = i;
+  // v[argc+1]: block, v[argc+2]: count.
+  mrb_value *block = &v[argc+1];
+  int i = vm->flag_resume ? mrbc_integer(block[1]) : 0;
 
-    // set OP_CALL irep
-    vm->pc = 0;
-    vm->pc_irep = &irep;
+  if( i >= mrbc_integer(v[0]) ) return;	// returns self
 
-    // execute OP_CALL
-    mrbc_vm_run(vm);
-  }
-  mrbc_pop_callinfo(vm);
+  mrbc_release( &block[1] );
+  mrbc_set_integer( &block[1], i+1 );
+
+  mrb_value value = mrb_fixnum_value(i);
+  mrbc_yield(vm, block, &value, 1);
 }
 
 
@@ -270,7 +234,7 @@ static void c_fixnum_to_s(mrb_vm *vm, mrb_value v[], int argc)
   char buf[16];
   mrbc_printf_init( &pf, buf, sizeof(buf), NULL );
   pf.fmt.type = 'd';
-  mrbc_printf_int( &pf, v->i, base );
+  mrbc_printf_int( &pf, mrbc_integer(*v), base );
   mrbc_printf_end( &pf );
 
   mrb_value value = mrbc_string_new_cstr(vm, buf);
@@ -316,7 +280,7 @@ void mrbc_init_class_fixnum(mrb_vm *vm)
 */
 static void c_float_negative(mrb_vm *vm, mrb_value v[], int argc)
 {
-  double num = GET_FLOAT_ARG(0);
+  mrbc_float_t num = GET_FLOAT_ARG(0);
   SET_FLOAT_RETURN( -num );
 }
 
@@ -327,14 +291,14 @@ static void c_float_negative(mrb_vm *vm, mrb_value v[], int argc)
  */
 static void c_float_power(mrb_vm *vm, mrb_value v[], int argc)
 {
-  double n = 0;
-  switch( v[1].tt ) {
-  case MRB_TT_FIXNUM:	n = v[1].i;	break;
-  case MRB_TT_FLOAT:	n = v[1].d;	break;
+  mrbc_float_t n = 0;
+  switch( mrbc_type(v[1]) ) {
+  case MRB_TT_FIXNUM:	n = mrbc_integer(v[1]);	break;
+  case MRB_TT_FLOAT:	n = mrbc_float(v[1]);	break;
   default:				break;
   }
 
-  SET_FLOAT_RETURN( pow( v[0].d, n ));
+  SET_FLOAT_RETURN( MRBC_MATH(pow)( mrbc_float(v[0]), n ));
 }
 #endif
 
@@ -344,8 +308,8 @@ static void c_float_power(mrb_vm *vm, mrb_value v[], int argc)
 */
 static void c_float_abs(mrb_vm *vm, mrb_value v[], int argc)
 {
-  if( v[0].d < 0 ) {
-    v[0].d = -v[0].d;
+  if( mrbc_float(v[0]) < 0 ) {
+    mrbc_set_float(&v[0], -mrbc_float(v[0]));
   }
 }
 
@@ -368,7 +332,7 @@ static void c_float_to_s(mrb_vm *vm, mrb_value v[], int argc)
 {
   char buf[16];
 
-  snprintf( buf, sizeof(buf), "%g", v->d );
+  snprintf( buf, sizeof(buf), "%g", mrbc_float(*v) );
   mrb_value value = mrbc_string_new_cstr(vm, buf);
   SET_RETURN(value);
 }
@@ -18,7 +18,6 @@
 #include "class.h"
 #include "c_range.h"
 #include "console.h"
-#include "opcode.h"
 
 
 //================================================================
@@ -32,13 +31,14 @@
 */
 mrb_value mrbc_range_new( struct VM *vm, mrb_value *first, mrb_value *last, int flag_exclude)
 {
-  mrb_value value = {.tt = MRB_TT_RANGE};
+  mrb_value value = MRBC_VALUE_INIT(MRB_TT_RANGE);
 
   value.range = mrbc_alloc(vm, sizeof(mrb_range));
   if( !value.range ) return value;		// ENOMEM
 
   value.range->ref_count = 1;
   value.range->tt = MRB_TT_STRING;	// TODO: for DEBUG
+  value.range->gc_flag = 0;
   value.range->flag_exclude = flag_exclude;
   value.range->first = *first;
   value.range->last = *last;
@@ -101,11 +101,11 @@ static void c_range_equal3(mrb_vm *vm, mrb_value v[], int argc)
   mrb_value *v_last =&v[0].range->last;
   mrb_value *v1 = &v[1];
 
-  if( v_first->tt == MRB_TT_FIXNUM && v1->tt == MRB_TT_FIXNUM ) {
+  if( mrbc_type(*v_first) == MRB_TT_FIXNUM && mrbc_type(*v1) == MRB_TT_FIXNUM ) {
     if( v->range->flag_exclude ) {
-      result = (v_first->i <= v1->i) && (v1->i < v_last->i);
+      result = (mrbc_integer(*v_first) <= mrbc_integer(*v1)) && (mrbc_integer(*v1) < mrbc_integer(*v_last));
     } else {
-      result = (v_first->i <= v1->i) && (v1->i <= v_last->i);
+      result = (mrbc_integer(*v_first) <= mrbc_integer(*v1)) && (mrbc_integer(*v1) <= mrbc_integer(*v_last));
     }
     goto DONE;
   }
@@ -147,48 +147,27 @@ static void c_range_last(mrb_vm *vm, mrb_value v[], int argc)
 */
 static void c_range_each(mrb_vm *vm, mrb_value v[], int argc)
 {
-  uint32_t code[2] = {
-    MKOPCODE(OP_CALL) | MKARG_A(argc),
-    MKOPCODE(OP_ABORT)
-  };
-  mrb_irep irep = {
-    0,     // nlocals
-    0,     // nregs
-    0,     // rlen
-    2,     // ilen
-    0,     // plen
-    (uint8_t *)code,   // iseq
-    NULL,  // pools
-    NULL,  // ptr_to_sym
-    NULL,  // reps
-  };
-
-  // get range
   mrb_range *range = v[0].range;
 
-  mrbc_push_callinfo(vm, 0);
-
-  // adjust reg_top for reg[0]==Proc
-  vm->current_regs += v - vm->regs + 1;
-
-  if( range->first.tt == MRB_TT_FIXNUM && range->last.tt == MRB_TT_FIXNUM ){
-    int i, i_last = range->last.i;
-    if( range->flag_exclude ) i_last--;
-    for( i=range->first.i ; i<=i_last ; i++ ){
-      v[2].tt = MRB_TT_FIXNUM;
-      v[2].i = i;
-      // set OP_CALL irep
-      vm->pc = 0;
-      vm->pc_irep = &irep;
-      
-      // execute OP_CALL
-      mrbc_vm_run(vm);
-    }
-  } else {
+  if( mrbc_type(range->first) != MRB_TT_FIXNUM ||
+      mrbc_type(range->last) != MRB_TT_FIXNUM ) {
     console_printf( "Not supported\n" );
+    return;
   }
-  
-  mrbc_pop_callinfo(vm);
+
+  // v[argc+1]: block, v[argc+2]: next value.
+  mrb_value *block = &v[argc+1];
+  int i = vm->flag_resume ? mrbc_integer(block[1]) : mrbc_integer(range->first);
+  int i_last = mrbc_integer(range->last);
+  if( range->flag_exclude ) i_last--;
+
+  if( i > i_last ) return;	// returns self
+
+  mrbc_release( &block[1] );
+  mrbc_set_integer( &block[1], i+1 );
+
+  mrb_value value = mrb_fixnum_value(i);
+  mrbc_yield(vm, block, &value, 1);
 }
 
 
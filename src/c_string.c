@@ -37,7 +37,7 @@
 */
 mrb_value mrbc_string_new(struct VM *vm, const void *src, int len)
 {
-  mrb_value value = {.tt = MRB_TT_STRING};
+  mrb_value value = MRBC_VALUE_INIT(MRB_TT_STRING);
 
   /*
     Allocate handle and string buffer.
@@ -54,6 +54,7 @@ mrb_value mrbc_string_new(struct VM *vm, const void *src, int len)
 
   h->ref_count = 1;
   h->tt = MRB_TT_STRING;	// TODO: for DEBUG
+  h->gc_flag = 0;
   h->size = len;
   h->data = str;
 
@@ -95,7 +96,7 @@ mrb_value mrbc_string_new_cstr(struct VM *vm, const char *src)
 */
 mrb_value mrbc_string_new_alloc(struct VM *vm, void *buf, int len)
 {
-  mrb_value value = {.tt = MRB_TT_STRING};
+  mrb_value value = MRBC_VALUE_INIT(MRB_TT_STRING);
 
   /*
     Allocate handle
@@ -106,6 +107,7 @@ mrb_value mrbc_string_new_alloc(struct VM *vm, void *buf, int len)
 
   h->ref_count = 1;
   h->tt = MRB_TT_STRING;	// TODO: for DEBUG
+  h->gc_flag = 0;
   h->size = len;
   h->data = buf;
 
@@ -191,15 +193,15 @@ mrb_value mrbc_string_add(struct VM *vm, mrb_value *s1, mrb_value *s2)
 int mrbc_string_append(mrb_value *s1, mrb_value *s2)
 {
   int len1 = s1->string->size;
-  int len2 = (s2->tt == MRB_TT_STRING) ? s2->string->size : 1;
+  int len2 = (mrbc_type(*s2) == MRB_TT_STRING) ? s2->string->size : 1;
 
   uint8_t *str = mrbc_raw_realloc(s1->string->data, len1+len2+1);
   if( !str ) return E_NOMEMORY_ERROR;
 
-  if( s2->tt == MRB_TT_STRING ) {
+  if( mrbc_type(*s2) == MRB_TT_STRING ) {
     memcpy(str + len1, s2->string->data, len2 + 1);
-  } else if( s2->tt == MRB_TT_FIXNUM ) {
-    str[len1] = s2->i;
+  } else if( mrbc_type(*s2) == MRB_TT_FIXNUM ) {
+    str[len1] = mrbc_integer(*s2);
     str[len1+1] = '\0';
   }
 
@@ -318,7 +320,7 @@ int mrbc_string_chomp(mrb_value *src)
 */
 static void c_string_add(mrb_vm *vm, mrb_value v[], int argc)
 {
-  if( v[1].tt != MRB_TT_STRING ) {
+  if( mrbc_type(v[1]) != MRB_TT_STRING ) {
     console_print( "Not support STRING + Other\n" );
     return;
   }
@@ -335,7 +337,7 @@ static void c_string_add(mrb_vm *vm, mrb_value v[], int argc)
 static void c_string_eql(mrb_vm *vm, mrb_value v[], int argc)
 {
   int result = 0;
-  if( v[1].tt != MRB_TT_STRING ) goto DONE;
+  if( mrbc_type(v[1]) != MRB_TT_STRING ) goto DONE;
 
   mrb_string *h1 = v[0].string;
   mrb_string *h2 = v[1].string;
@@ -372,7 +374,7 @@ static void c_string_to_i(mrb_vm *vm, mrb_value v[], int argc)
 {
   int base = 10;
   if( argc ) {
-    base = v[1].i;
+    base = mrbc_integer(v[1]);
     if( base < 2 || base > 36 ) {
       return;	// raise ? ArgumentError
     }
@@ -390,7 +392,7 @@ static void c_string_to_i(mrb_vm *vm, mrb_value v[], int argc)
 */
 static void c_string_to_f(mrb_vm *vm, mrb_value v[], int argc)
 {
-  double d = atof(mrbc_string_cstr(v));
+  mrbc_float_t d = mrbc_atof(mrbc_string_cstr(v));
 
   SET_FLOAT_RETURN( d );
 }
@@ -419,9 +421,9 @@ static void c_string_slice(mrb_vm *vm, mrb_value v[], int argc)
   /*
     in case of slice(nth) -> String | nil
   */
-  if( argc == 1 && v1->tt == MRB_TT_FIXNUM ) {
+  if( argc == 1 && mrbc_type(*v1) == MRB_TT_FIXNUM ) {
     int len = v->string->size;
-    int idx = v1->i;
+    int idx = mrbc_integer(*v1);
     int ch = -1;
     if( idx >= 0 ) {
       if( idx < len ) {
@@ -447,13 +449,13 @@ static void c_string_slice(mrb_vm *vm, mrb_value v[], int argc)
   /*
     in case of slice(nth, len) -> String | nil
   */
-  if( argc == 2 && v1->tt == MRB_TT_FIXNUM && v2->tt == MRB_TT_FIXNUM ) {
+  if( argc == 2 && mrbc_type(*v1) == MRB_TT_FIXNUM && mrbc_type(*v2) == MRB_TT_FIXNUM ) {
     int len = v->string->size;
-    int idx = v1->i;
+    int idx = mrbc_integer(*v1);
     if( idx < 0 ) idx += len;
     if( idx < 0 ) goto RETURN_NIL;
 
-    int rlen = (v2->i < (len - idx)) ? v2->i : (len - idx);
+    int rlen = (mrbc_integer(*v2) < (len - idx)) ? mrbc_integer(*v2) : (len - idx);
 						// min( v2->i, (len-idx) )
     if( rlen < 0 ) goto RETURN_NIL;
 
@@ -489,9 +491,9 @@ static void c_string_insert(mrb_vm *vm, mrb_value v[], int argc)
     in case of self[nth] = val
   */
   if( argc == 2 &&
-      v[1].tt == MRB_TT_FIXNUM &&
-      v[2].tt == MRB_TT_STRING ) {
-    nth = v[1].i;
+      mrbc_type(v[1]) == MRB_TT_FIXNUM &&
+      mrbc_type(v[2]) == MRB_TT_STRING ) {
+    nth = mrbc_integer(v[1]);
     len = 1;
     val = &v[2];
   }
@@ -499,11 +501,11 @@ static void c_string_insert(mrb_vm *vm, mrb_value v[], int argc)
     in case of self[nth, len] = val
   */
   else if( argc == 3 &&
-	   v[1].tt == MRB_TT_FIXNUM &&
-	   v[2].tt == MRB_TT_FIXNUM &&
-	   v[3].tt == MRB_TT_STRING ) {
-    nth = v[1].i;
-    len = v[2].i;
+	   mrbc_type(v[1]) == MRB_TT_FIXNUM &&
+	   mrbc_type(v[2]) == MRB_TT_FIXNUM &&
+	   mrbc_type(v[3]) == MRB_TT_STRING ) {
+    nth = mrbc_integer(v[1]);
+    len = mrbc_integer(v[2]);
     val = &v[3];
   }
   /*
@@ -580,8 +582,8 @@ static void c_string_index(mrb_vm *vm, mrb_value v[], int argc)
   if( argc == 1 ) {
     offset = 0;
 
-  } else if( argc == 2 && v[2].tt == MRB_TT_FIXNUM ) {
-    offset = v[2].i;
+  } else if( argc == 2 && mrbc_type(v[2]) == MRB_TT_FIXNUM ) {
+    offset = mrbc_integer(v[2]);
     if( offset < 0 ) offset += mrbc_string_size(&v[0]);
     if( offset < 0 ) goto NIL_RETURN;
 
@@ -619,7 +621,7 @@ static void c_object_sprintf(mrb_vm *vm, mrb_value v[], int argc)
   static const int BUF_INC_STEP = 32;	// bytes.
 
   mrb_value *format = &v[1];
-  if( format->tt != MRB_TT_STRING ) {
+  if( mrbc_type(*format) != MRB_TT_STRING ) {
     console_printf( "TypeError\n" );	// raise?
     return;
   }
@@ -644,15 +646,15 @@ static void c_object_sprintf(mrb_vm *vm, mrb_value v[], int argc)
     // maybe ret == 1
     switch(pf.fmt.type) {
     case 'c':
-      if( v[i].tt == MRB_TT_FIXNUM ) {
-	ret = mrbc_printf_char( &pf, v[i].i );
+      if( mrbc_type(v[i]) == MRB_TT_FIXNUM ) {
+	ret = mrbc_printf_char( &pf, mrbc_integer(v[i]) );
       }
       break;
 
     case 's':
-      if( v[i].tt == MRB_TT_STRING ) {
+      if( mrbc_type(v[i]) == MRB_TT_STRING ) {
 	ret = mrbc_printf_str( &pf, mrbc_string_cstr( &v[i] ), ' ');
-      } else if( v[i].tt == MRB_TT_SYMBOL ) {
+      } else if( mrbc_type(v[i]) == MRB_TT_SYMBOL ) {
 	ret = mrbc_printf_str( &pf, mrbc_symbol_cstr( &v[i] ), ' ');
       }
       break;
@@ -660,13 +662,13 @@ static void c_object_sprintf(mrb_vm *vm, mrb_value v[], int argc)
     case 'd':
     case 'i':
     case 'u':
-      if( v[i].tt == MRB_TT_FIXNUM ) {
-	ret = mrbc_printf_int( &pf, v[i].i, 10);
+      if( mrbc_type(v[i]) == MRB_TT_FIXNUM ) {
+	ret = mrbc_printf_int( &pf, mrbc_integer(v[i]), 10);
 #if MRBC_USE_FLOAT
-      } else if( v[i].tt == MRB_TT_FLOAT ) {
-	ret = mrbc_printf_int( &pf, (int32_t)v[i].d, 10);
+      } else if( mrbc_type(v[i]) == MRB_TT_FLOAT ) {
+	ret = mrbc_printf_int( &pf, (int32_t)mrbc_float(v[i]), 10);
 #endif
-      } else if( v[i].tt == MRB_TT_STRING ) {
+      } else if( mrbc_type(v[i]) == MRB_TT_STRING ) {
 	int32_t ival = atol(mrbc_string_cstr(&v[i]));
 	ret = mrbc_printf_int( &pf, ival, 10 );
       }
@@ -674,15 +676,15 @@ static void c_object_sprintf(mrb_vm *vm, mrb_value v[], int argc)
 
     case 'b':
     case 'B':
-      if( v[i].tt == MRB_TT_FIXNUM ) {
-	ret = mrbc_printf_int( &pf, v[i].i, 2);
+      if( mrbc_type(v[i]) == MRB_TT_FIXNUM ) {
+	ret = mrbc_printf_int( &pf, mrbc_integer(v[i]), 2);
       }
       break;
 
     case 'x':
     case 'X':
-      if( v[i].tt == MRB_TT_FIXNUM ) {
-	ret = mrbc_printf_int( &pf, v[i].i, 16);
+      if( mrbc_type(v[i]) == MRB_TT_FIXNUM ) {
+	ret = mrbc_printf_int( &pf, mrbc_integer(v[i]), 16);
       }
       break;
 
@@ -692,11 +694,11 @@ static void c_object_sprintf(mrb_vm *vm, mrb_value v[], int argc)
     case 'E':
     case 'g':
     case 'G':
-      if( v[i].tt == MRB_TT_FLOAT ) {
-	ret = mrbc_printf_float( &pf, v[i].d );
+      if( mrbc_type(v[i]) == MRB_TT_FLOAT ) {
+	ret = mrbc_printf_float( &pf, mrbc_float(v[i]) );
       } else
-	if( v[i].tt == MRB_TT_FIXNUM ) {
-	  ret = mrbc_printf_float( &pf, (double)v[i].i );
+	if( mrbc_type(v[i]) == MRB_TT_FIXNUM ) {
+	  ret = mrbc_printf_float( &pf, (double)mrbc_integer(v[i]) );
 	}
       break;
 #endif
@@ -33,6 +33,28 @@
 #include "c_range.h"
 
 
+#if MRBC_METHOD_CACHE_SIZE > 0
+//================================================================
+/*!@brief
+  Method cache entry.
+
+  Keyed by call site (IREP and pc) and validated by the receiver's
+  class, the method name and the method cache epoch.
+*/
+typedef struct METHOD_CACHE {
+  const struct IREP *irep;	//!< call site IREP.
+  uint16_t pc;			//!< call site pc.
+  mrb_sym sym_id;		//!< method name.
+  uint16_t epoch;		//!< method_cache_epoch at the time of caching.
+  mrb_class *cls;		//!< class of receiver.
+  mrb_proc *proc;		//!< resolved method.
+} mrb_method_cache;
+
+static mrb_method_cache method_cache[MRBC_METHOD_CACHE_SIZE];
+static uint16_t method_cache_epoch = 1;
+#endif
+
+
 #ifdef MRBC_DEBUG
 int mrbc_puts_sub(mrb_value *v);
 
@@ -41,7 +63,7 @@ int mrbc_puts_sub(mrb_value *v);
  */
 void mrbc_p_sub(mrb_value *v)
 {
-  switch( v->tt ){
+  switch( mrbc_type(*v) ){
   case MRB_TT_EMPTY:	console_print("(empty)");	break;
   case MRB_TT_NIL:	console_print("nil");		break;
 
@@ -110,7 +132,7 @@ void mrbc_p_sub(mrb_value *v)
   } break;
 
   default:
-    console_printf("MRB_TT_XX(%d)", v->tt);
+    console_printf("MRB_TT_XX(%d)", mrbc_type(*v));
     break;
   }
 }
@@ -128,13 +150,13 @@ int mrbc_puts_sub(mrb_value *v)
 {
   int ret = 0;
 
-  switch( v->tt ){
+  switch( mrbc_type(*v) ){
   case MRB_TT_NIL:					break;
   case MRB_TT_FALSE:	console_print("false");		break;
   case MRB_TT_TRUE:	console_print("true");		break;
-  case MRB_TT_FIXNUM:	console_printf("%d", v->i);	break;
+  case MRB_TT_FIXNUM:	console_printf("%d", mrbc_integer(*v));	break;
 #if MRBC_USE_FLOAT
-  case MRB_TT_FLOAT:    console_printf("%g", v->d);	break;
+  case MRB_TT_FLOAT:    console_printf("%g", mrbc_float(*v));	break;
 #endif
   case MRB_TT_SYMBOL:
     console_print( mrbc_symbol_cstr( v ) );
@@ -187,7 +209,7 @@ int mrbc_puts_sub(mrb_value *v)
     break;
 
   default:
-    console_printf("MRB_TT_XX(%d)", v->tt);
+    console_printf("MRB_TT_XX(%d)", mrbc_type(*v));
     break;
   }
 
@@ -207,7 +229,7 @@ mrb_class *find_class_by_object(struct VM *vm, mrb_object *obj)
 {
   mrb_class *cls;
 
-  switch( obj->tt ) {
+  switch( mrbc_type(*obj) ) {
   case MRB_TT_TRUE:	cls = mrbc_class_true;		break;
   case MRB_TT_FALSE:	cls = mrbc_class_false; 	break;
   case MRB_TT_NIL:	cls = mrbc_class_nil;		break;
@@ -259,6 +281,69 @@ mrb_proc *find_method(mrb_vm *vm, mrb_value recv, mrb_sym sym_id)
 
 
 
+//================================================================
+/*!@brief
+  find method, using the method cache.
+
+  The current call site (vm->pc_irep, vm->pc) is used as a cache key,
+  so this is intended to be called from OP_SEND.
+
+  @param  vm
+  @param  recv
+  @param  sym_id
+  @return
+*/
+mrb_proc *find_method_cached(mrb_vm *vm, mrb_value recv, mrb_sym sym_id)
+{
+#if MRBC_METHOD_CACHE_SIZE > 0
+  mrb_class *cls = find_class_by_object(vm, &recv);
+  int idx = (((uintptr_t)vm->pc_irep >> 2) ^ vm->pc)
+    & (MRBC_METHOD_CACHE_SIZE - 1);
+  mrb_method_cache *mc = &method_cache[idx];
+
+  if( mc->irep == vm->pc_irep && mc->pc == vm->pc &&
+      mc->sym_id == sym_id && mc->cls == cls &&
+      mc->epoch == method_cache_epoch ) {
+    return mc->proc;
+  }
+
+  mrb_proc *proc = find_method(vm, recv, sym_id);
+  if( proc ) {
+    mc->irep = vm->pc_irep;
+    mc->pc = vm->pc;
+    mc->sym_id = sym_id;
+    mc->epoch = method_cache_epoch;
+    mc->cls = cls;
+    mc->proc = proc;
+  }
+  return proc;
+
+#else
+  return find_method(vm, recv, sym_id);
+#endif
+}
+
+
+
+//================================================================
+/*!@brief
+  invalidate all method cache entries.
+
+  Must be called whenever a method is added or replaced.
+*/
+void mrbc_clear_method_cache(void)
+{
+#if MRBC_METHOD_CACHE_SIZE > 0
+  if( ++method_cache_epoch == 0 ) {
+    // wrap around. clear all entries, and skip zero.
+    memset( method_cache, 0, sizeof(method_cache) );
+    method_cache_epoch = 1;
+  }
+#endif
+}
+
+
+
 //================================================================
 /*!@brief
   define class
@@ -274,7 +359,7 @@ mrb_class * mrbc_define_class(mrb_vm *vm, const char *name, mrb_class *super)
   mrb_object obj = const_object_get(sym_id);
 
   // create a new class?
-  if( obj.tt == MRB_TT_NIL ) {
+  if( mrbc_type(obj) == MRB_TT_NIL ) {
     cls = mrbc_alloc( 0, sizeof(mrb_class) );
     if( !cls ) return cls;	// ENOMEM
 
@@ -284,9 +369,11 @@ mrb_class * mrbc_define_class(mrb_vm *vm, const char *name, mrb_class *super)
 #endif
     cls->super = super;
     cls->procs = 0;
+    cls->n_ivar = 0;
+    cls->ivar_syms = 0;
 
     // register to global constant.
-    mrb_value v = {.tt = MRB_TT_CLASS};
+    mrb_value v = MRBC_VALUE_INIT(MRB_TT_CLASS);
     v.cls = cls;
     const_object_add(sym_id, &v);
 
@@ -294,7 +381,7 @@ mrb_class * mrbc_define_class(mrb_vm *vm, const char *name, mrb_class *super)
   }
 
   // already?
-  if( obj.tt == MRB_TT_CLASS ) {
+  if( mrbc_type(obj) == MRB_TT_CLASS ) {
     return obj.cls;
   }
 
@@ -321,6 +408,8 @@ void mrbc_define_method(mrb_vm *vm, mrb_class *cls, const char *name, mrb_func_t
   rproc->next = cls->procs;
   cls->procs = rproc;
   rproc->func = cfunc;
+
+  mrbc_clear_method_cache();
 }
 
 
@@ -343,13 +432,7 @@ void mrbc_funcall(mrb_vm *vm, const char *name, mrb_value *v, int argc)
 
   if( m==0 ) return;   // no method
 
-  mrb_callinfo *callinfo = vm->callinfo + vm->callinfo_top;
-  callinfo->current_regs = vm->current_regs;
-  callinfo->pc_irep = vm->pc_irep;
-  callinfo->pc = vm->pc;
-  callinfo->n_args = 0;
-  callinfo->target_class = vm->target_class;
-  vm->callinfo_top++;
+  if( mrbc_push_callinfo(vm, 0) != 0 ) return;
 
   // target irep
   vm->pc = 0;
@@ -357,7 +440,9 @@ void mrbc_funcall(mrb_vm *vm, const char *name, mrb_value *v, int argc)
 
   // new regs
   vm->current_regs += 2;   // recv and symbol
-
+  if( mrbc_extend_regs(vm, m->irep->nregs) != 0 ) {
+    mrbc_pop_callinfo(vm);	// vm->error_code is set.
+  }
 }
 
 
@@ -440,19 +525,16 @@ static void c_object_new(mrb_vm *vm, mrb_value v[], int argc)
 {
   mrb_value new_obj = mrbc_instance_new(vm, v->cls, 0);
 
-  char syms[]="______initialize";
-  mrb_sym sym_id = str_to_symid(&syms[6]);
+  mrb_sym sym_id = MRBC_SYM_initialize;
   mrb_proc *m = find_method(vm, v[0], sym_id);
   if( m==0 ){
     SET_RETURN(new_obj);
     return;
   }
-  uint32_to_bin( 1,(uint8_t*)&syms[0]);
-  uint16_to_bin(10,(uint8_t*)&syms[4]);
 
-  uint32_t code[2] = {
-    MKOPCODE(OP_SEND) | MKARG_A(0) | MKARG_B(0) | MKARG_C(argc),
-    MKOPCODE(OP_ABORT)
+  mrbc_iseq_t code[2] = {
+    MKCODE(OP_SEND, 0, 0, argc),
+    MKCODE(OP_ABORT, 0, 0, 0)
     };
    mrb_irep irep = {
     0,     // nlocals
@@ -460,28 +542,42 @@ static void c_object_new(mrb_vm *vm, mrb_value v[], int argc)
     0,     // rlen
     2,     // ilen
     0,     // plen
+    1,     // slen
     (uint8_t *)code,   // iseq
     NULL,  // pools
-    (uint8_t *)syms,  // ptr_to_sym
+    NULL,  // ptr_to_sym
+    &sym_id,  // syms
     NULL,  // reps
+#if MRBC_USE_CONST_CACHE
+    NULL,  // const_cache (no OP_GETCONST)
+#endif
   };
 
   mrbc_release(&v[0]);
   v[0] = new_obj;
   mrbc_dup(&new_obj);
 
+  // (note) the register stack may be moved, so hold offsets.
   mrb_irep *org_pc_irep = vm->pc_irep;
   uint16_t  org_pc = vm->pc;
-  mrb_value* org_regs = vm->current_regs;
+  int org_regs_ofs = vm->current_regs - vm->regs;
+  int v_ofs = v - vm->regs;
   vm->pc = 0;
   vm->pc_irep = &irep;
   vm->current_regs = v;
 
-  mrbc_vm_run(vm);
+  // run until OP_ABORT. a preemption request is held until it ends.
+  int flag_preemption = vm->flag_preemption;
+  vm->flag_preemption = 0;
+  while( mrbc_vm_run(vm) == 0 ) {
+    flag_preemption = 1;
+  }
+  vm->flag_preemption = flag_preemption;
 
   vm->pc = org_pc;
   vm->pc_irep = org_pc_irep;
-  vm->current_regs = org_regs;
+  vm->current_regs = vm->regs + org_regs_ofs;
+  v = vm->regs + v_ofs;
 
   SET_RETURN(new_obj);
 }
@@ -491,9 +587,8 @@ static void c_object_new(mrb_vm *vm, mrb_value v[], int argc)
  */
 static void c_object_getiv(mrb_vm *vm, mrb_value v[], int argc)
 {
-  const char *name = mrbc_get_callee_name(vm);
-  mrb_sym sym_id = str_to_symid( name );
-  mrb_value ret = mrbc_instance_getiv(&v[0], sym_id);
+  mrb_proc *m = find_method_cached(vm, v[0], mrbc_get_callee_symid(vm));
+  mrb_value ret = mrbc_instance_getiv(&v[0], m->ivar_sym_id);
 
   SET_RETURN(ret);
 }
@@ -504,20 +599,47 @@ static void c_object_getiv(mrb_vm *vm, mrb_value v[], int argc)
  */
 static void c_object_setiv(mrb_vm *vm, mrb_value v[], int argc)
 {
-  const char *name = mrbc_get_callee_name(vm);
+  mrb_proc *m = find_method_cached(vm, v[0], mrbc_get_callee_symid(vm));
+  mrbc_instance_setiv(&v[0], m->ivar_sym_id, &v[1]);
+}
+
+
+//================================================================
+/*! define an accessor method of the instance variable.
+
+  The symbol "@name" is made here and held in the method,
+  so the accessor doesn't make it at each call.
 
-  char *namebuf = mrbc_alloc(vm, strlen(name));
+  @param  vm		pointer to vm.
+  @param  cls		target class.
+  @param  name		ivar name without '@'.
+  @param  flag_writer	define the writer "name=", instead of the reader.
+*/
+static void define_attr_method(mrb_vm *vm, mrb_class *cls, const char *name, int flag_writer)
+{
+  int len = strlen(name);
+  char *namebuf = mrbc_alloc(vm, len+2);
   if( !namebuf ) return;
-  strcpy(namebuf, name);
-  namebuf[strlen(name)-1] = '\0';	// delete '='
-  mrb_sym sym_id = str_to_symid(namebuf);
 
-  mrbc_instance_setiv(&v[0], sym_id, &v[1]);
+  // make string "@...." as instance variable name.
+  namebuf[0] = '@';
+  strcpy(namebuf+1, name);
+  mrb_sym ivar_sym_id = mrbc_symbol(mrbc_symbol_new(vm, namebuf));
+
+  // make string "....=" as writer method name.
+  if( flag_writer ) {
+    strcpy(namebuf, name);
+    strcat(namebuf, "=");
+    mrbc_symbol_new(vm, namebuf);
+    name = namebuf;
+  }
+
+  mrbc_define_method(vm, cls, name, flag_writer ? c_object_setiv : c_object_getiv);
+  cls->procs->ivar_sym_id = ivar_sym_id;	// the method just defined.
   mrbc_raw_free(namebuf);
 }
 
 
-
 //================================================================
 /*! (class method) access method 'attr_reader'
  */
@@ -525,11 +647,11 @@ static void c_object_attr_reader(mrb_vm *vm, mrb_value v[], int argc)
 {
   int i;
   for( i = 1; i <= argc; i++ ) {
-    if( v[i].tt != MRB_TT_SYMBOL ) continue;	// TypeError raise?
+    if( mrbc_type(v[i]) != MRB_TT_SYMBOL ) continue;	// TypeError raise?
 
     // define reader method
     const char *name = mrbc_symbol_cstr(&v[i]);
-    mrbc_define_method(vm, v[0].cls, name, c_object_getiv);
+    define_attr_method(vm, v[0].cls, name, 0);
   }
 }
 
@@ -541,20 +663,12 @@ static void c_object_attr_accessor(mrb_vm *vm, mrb_value v[], int argc)
 {
   int i;
   for( i = 1; i <= argc; i++ ) {
-    if( v[i].tt != MRB_TT_SYMBOL ) continue;	// TypeError raise?
+    if( mrbc_type(v[i]) != MRB_TT_SYMBOL ) continue;	// TypeError raise?
 
-    // define reader method
+    // define reader and writer method
     const char *name = mrbc_symbol_cstr(&v[i]);
-    mrbc_define_method(vm, v[0].cls, name, c_object_getiv);
-
-    // make string "....=" and define writer method.
-    char *namebuf = mrbc_alloc(vm, strlen(name)+2);
-    if( !namebuf ) return;
-    strcpy(namebuf, name);
-    strcat(namebuf, "=");
-    mrbc_symbol_new(vm, namebuf);
-    mrbc_define_method(vm, v[0].cls, namebuf, c_object_setiv);
-    mrbc_raw_free(namebuf);
+    define_attr_method(vm, v[0].cls, name, 0);
+    define_attr_method(vm, v[0].cls, name, 1);
   }
 }
 
@@ -642,13 +756,16 @@ static void mrbc_init_class_object(mrb_vm *vm)
 static void c_proc_call(mrb_vm *vm, mrb_value v[], int argc)
 {
   // push callinfo, but not release regs
-  mrbc_push_callinfo(vm, argc);
+  if( mrbc_push_callinfo(vm, argc) != 0 ) return;
 
   // target irep
   vm->pc = 0;
   vm->pc_irep = v[0].proc->irep;
 
   vm->current_regs = v;
+  if( mrbc_extend_regs(vm, vm->pc_irep->nregs) != 0 ) {
+    mrbc_pop_callinfo(vm);	// vm->error_code is set.
+  }
 }
 
 
@@ -689,7 +806,7 @@ static void mrbc_init_class_proc(mrb_vm *vm)
 */
 static void c_nil_false_not(mrb_vm *vm, mrb_value v[], int argc)
 {
-  v[0].tt = MRB_TT_TRUE;
+  mrbc_set_true(&v[0]);
 }
 
 
@@ -25,6 +25,8 @@ extern "C" {
 
 mrb_class *find_class_by_object(struct VM *vm, mrb_object *obj);
 mrb_proc *find_method(struct VM *vm, mrb_value recv, mrb_sym sym_id);
+mrb_proc *find_method_cached(struct VM *vm, mrb_value recv, mrb_sym sym_id);
+void mrbc_clear_method_cache(void);
 
 void mrbc_init_class(void);
 mrb_class * mrbc_define_class(struct VM *vm, const char *name, mrb_class *super);
@@ -22,11 +22,11 @@ static void class_arduino_delay(mrb_vm *vm, mrb_value *v, int argc )
 static uint8_t sym_to_pinmode(mrb_sym sym_in){
 	uint8_t mode = INPUT;
 
-	if(sym_in == str_to_symid("INPUT")){
+	if(sym_in == MRBC_SYM_INPUT){
 		mode = INPUT;
-	}else if(sym_in == str_to_symid("OUTPUT")){
+	}else if(sym_in == MRBC_SYM_OUTPUT){
 		mode = OUTPUT;
-	}else if(sym_in == str_to_symid("INPUT_PULLUP")){
+	}else if(sym_in == MRBC_SYM_INPUT_PULLUP){
 		mode = INPUT_PULLUP;
 	}
 	return mode;
@@ -35,7 +35,7 @@ static uint8_t sym_to_pinmode(mrb_sym sym_in){
 static uint8_t sym_to_siglevel(mrb_sym sym_in){
 	uint8_t sig = LOW;
 
-	if(sym_in == str_to_symid("HIGH")){
+	if(sym_in == MRBC_SYM_HIGH){
 		sig = HIGH;
 	}else{
 		sig = LOW;
@@ -59,7 +59,7 @@ static void class_arduino_pin_mode(mrb_vm *vm, mrb_value *v, int argc )
 	if(GET_TT_ARG(2) == MRB_TT_SYMBOL){
 		sym_in = GET_INT_ARG(2);
 	}else if(GET_TT_ARG(2) == MRB_TT_STRING){
-		sym_in = str_to_symid((const char *)GET_STRING_ARG(2));
+		sym_in = mrbc_search_symid((const char *)GET_STRING_ARG(2));
 	}else{
 		SET_FALSE_RETURN();
 		return;
@@ -85,7 +85,7 @@ static void class_arduino_digital_wirte(mrb_vm *vm, mrb_value *v, int argc )
 	if(GET_TT_ARG(2) == MRB_TT_SYMBOL){
 		sym_in = GET_INT_ARG(2);
 	}else if(GET_TT_ARG(2) == MRB_TT_STRING){
-		sym_in = str_to_symid((const char *)GET_STRING_ARG(2));
+		sym_in = mrbc_search_symid((const char *)GET_STRING_ARG(2));
 	}else{
 		SET_FALSE_RETURN();
 		return;
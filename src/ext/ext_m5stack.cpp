@@ -17,17 +17,17 @@
 static uint16_t sym_to_colorcode(mrb_sym sym_in){
 	uint16_t col = BLACK;
 
-	if(sym_in == str_to_symid("WHITE")){
+	if(sym_in == MRBC_SYM_WHITE){
 		col = WHITE;
-	}else if(sym_in == str_to_symid("RED")){
+	}else if(sym_in == MRBC_SYM_RED){
 		col = RED;
-	}else if(sym_in == str_to_symid("GREEN")){
+	}else if(sym_in == MRBC_SYM_GREEN){
 		col = GREEN;
-	}else if(sym_in == str_to_symid("BLUE")){
+	}else if(sym_in == MRBC_SYM_BLUE){
 		col = BLUE;
-	}else if(sym_in == str_to_symid("YELLOW")){
+	}else if(sym_in == MRBC_SYM_YELLOW){
 		col = YELLOW;
-	}else if(sym_in == str_to_symid("BLACK")){
+	}else if(sym_in == MRBC_SYM_BLACK){
 		col = BLACK;
 	}
 	return col;
@@ -37,7 +37,7 @@ static int arg_to_colorcode(mrb_value *v, int no, uint16_t* col){
 	if(GET_TT_ARG(no) == MRB_TT_SYMBOL){
 		sym_in = GET_INT_ARG(no);
 	}else if(GET_TT_ARG(no) == MRB_TT_STRING){
-		sym_in = str_to_symid((const char *)GET_STRING_ARG(no));
+		sym_in = mrbc_search_symid((const char *)GET_STRING_ARG(no));
 	}else if(GET_TT_ARG(no) == MRB_TT_FIXNUM){
 		*col = GET_INT_ARG(no);
 		return true;
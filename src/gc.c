@@ -0,0 +1,762 @@
+/*! @file
+  @brief
+  mruby/c cycle collector and deferred release for reference counted
+  objects.
+
+  <pre>
+  Copyright (C) 2015-2018 Kyushu Institute of Technology.
+  Copyright (C) 2015-2018 Shimane IT Open-Innovation Center.
+
+  This file is distributed under BSD 3-Clause License.
+
+  </pre>
+*/
+
+#include "vm_config.h"
+#include <stdint.h>
+#include <assert.h>
+
+#include "value.h"
+#include "alloc.h"
+#include "gc.h"
+#include "c_string.h"
+#include "c_range.h"
+#include "c_array.h"
+#include "c_hash.h"
+
+/*
+
+  Objects are released by reference counting, so a cycle such as
+  an instance whose ivar holds an array that contains the instance
+  is never released. This collects such cycles by trial deletion.
+  (D.F.Bacon and V.T.Rajan, "Concurrent Cycle Collection in
+   Reference Counted Systems", ECOOP 2001)
+
+  When a reference counter of a container object (Object, Array,
+  Hash or Range) is decremented but not to zero, the object may be
+  the last external entry of a garbage cycle. It is registered to
+  the candidate buffer. The releases of the temporary registers of
+  the VM are not registered, except for the objects found live by
+  the collector before. (see mrbc_release_temp)
+
+  A collection step takes the candidates as the roots. The objects
+  reachable from the roots are listed in a work buffer, and the
+  references from inside of the list are subtracted (mark gray).
+  The objects still counted are referenced from outside, that is,
+  from VM registers, global objects, constants or other live objects.
+  They and their descendants are restored (scan black), and the rest
+  are garbage (white) and freed.
+
+  A step lists MRBC_GC_STEP_SIZE objects at most, so a candidate that
+  points into a large live structure doesn't stall the tasks. The
+  candidates that don't fit are left for the next step. If the first
+  candidate alone doesn't fit, its list is cut off, and the objects
+  whose children aren't listed are treated as live. So a garbage cycle
+  larger than the step is not found by the steps. mrbc_gc_collect()
+  has no limit, and the scheduler uses it when the memory runs short.
+
+  Each phase is a loop over the list, without recursion, so a deep
+  object graph doesn't overflow the C stack. The garbage is freed
+  after all the phases, so no freed object is visited.
+  If the work buffer can't be allocated, the step is given up before
+  any counter is changed, and the candidates are kept.
+
+*/
+
+#if MRBC_GC_CANDIDATES > 0 || MRBC_FREE_QUEUE_SIZE > 0
+//================================================================
+/*! free the memory block.
+
+  @param  ptr	pointer to the memory block.
+  @return	freed bytes.
+*/
+static int gc_free_block(void *ptr)
+{
+  int size = mrbc_get_alloc_size(ptr);
+  mrbc_raw_free(ptr);
+  return size;
+}
+
+
+//================================================================
+/*! free the memory of the object.
+
+  The references held by the object must be released beforehand.
+
+  @param  v	pointer to target value.
+  @return	freed bytes.
+*/
+static int gc_free_object(mrb_value *v)
+{
+  int size = 0;
+
+  switch( mrbc_type(*v) ) {
+  case MRB_TT_OBJECT:
+    if( v->instance->flag_ivar_ext ) size += gc_free_block( v->instance->ivar );
+    break;
+
+  case MRB_TT_ARRAY:
+    size += gc_free_block( v->array->data );
+    break;
+
+  case MRB_TT_HASH:
+    size += gc_free_block( v->hash->data );
+    break;
+
+#if MRBC_USE_STRING
+  case MRB_TT_STRING:
+    size += gc_free_block( v->string->data );
+    break;
+#endif
+
+  default:
+    break;
+  }
+  size += gc_free_block( v->handle );
+
+  return size;
+}
+#endif
+
+
+#if MRBC_GC_CANDIDATES > 0
+
+static mrb_value gc_candidates[MRBC_GC_CANDIDATES];
+static int gc_n_candidates;
+static int gc_lost;		// candidates dropped by the full buffer.
+static int gc_reclaimed;	// total reclaimed bytes.
+static int gc_requested;	// by the low memory hook.
+static int gc_n_taken;		// candidates taken by gc_list_objects().
+
+// work buffer of a collection.
+static mrb_value *gc_list;
+static int gc_list_size;
+
+#define GC_COLOR(v)	((v)->instance->gc_flag & MRBC_GC_COLOR_MASK)
+#define GC_SET_COLOR(v,c) \
+  ((v)->instance->gc_flag = ((v)->instance->gc_flag & ~MRBC_GC_COLOR_MASK) | (c))
+
+
+//================================================================
+/*! is the value reference counted?
+*/
+static int gc_is_object(const mrb_value *v)
+{
+  switch( mrbc_type(*v) ) {
+  case MRB_TT_OBJECT:
+  case MRB_TT_PROC:
+  case MRB_TT_ARRAY:
+  case MRB_TT_STRING:
+  case MRB_TT_RANGE:
+  case MRB_TT_HASH:
+    return 1;
+
+  default:
+    return 0;
+  }
+}
+
+
+//================================================================
+/*! get the references held by the object.
+
+  @param  v	pointer to target value.
+  @param  p2	returns the end of the references.
+  @return	pointer to the first reference.
+*/
+static mrb_value * gc_children(mrb_value *v, mrb_value **p2)
+{
+  mrb_value *p1;
+
+  switch( mrbc_type(*v) ) {
+  case MRB_TT_OBJECT:
+    p1 = v->instance->ivar;
+    *p2 = p1 + v->instance->n_ivar;
+    break;
+
+  case MRB_TT_ARRAY:
+    p1 = v->array->data;
+    *p2 = p1 + v->array->n_stored;
+    break;
+
+  case MRB_TT_HASH:
+    p1 = v->hash->data;
+    *p2 = p1 + v->hash->n_stored;
+    break;
+
+  case MRB_TT_RANGE:
+    // first and last are adjacent members.
+    p1 = &v->range->first;
+    *p2 = p1 + 2;
+    break;
+
+  default:
+    p1 = *p2 = NULL;
+    break;
+  }
+
+  return p1;
+}
+
+
+//================================================================
+/*! make sure that the work buffer has n entries.
+
+  @param  n	num of entries.
+  @return	0 if no error.
+*/
+static int gc_reserve_list(int n)
+{
+  if( n <= gc_list_size ) return 0;
+
+  int size = gc_list_size ? gc_list_size * 2 : MRBC_GC_CANDIDATES * 2;
+  if( size < n ) size = n;
+
+  mrb_value *list = gc_list ?
+    mrbc_raw_realloc( gc_list, sizeof(mrb_value) * size ) :
+    mrbc_raw_alloc( sizeof(mrb_value) * size );
+  if( list == NULL ) return -1;		// ENOMEM
+
+  gc_list = list;
+  gc_list_size = size;
+  return 0;
+}
+
+
+//================================================================
+/*! release the work buffer.
+*/
+static void gc_free_list(void)
+{
+  if( gc_list ) mrbc_raw_free( gc_list );
+  gc_list = NULL;
+  gc_list_size = 0;
+}
+
+
+//================================================================
+/*! list the objects reachable from the candidates. (colored gray)
+
+  The candidates are taken from the end of the buffer, while the list
+  has room. The first one is always taken, and if its objects don't
+  fit, the list is cut off. The children of the objects after
+  *n_expanded are not listed.
+  The taken candidates are counted in gc_n_taken, and removed from the
+  buffer by the caller.
+
+  @param  max_objects	maximum number of the listed objects. 0: no limit.
+  @param  n_expanded	returns num of the objects whose children are listed.
+  @return		num of the listed objects, or -1 if no memory.
+*/
+static int gc_list_objects(int max_objects, int *n_expanded)
+{
+  int n = 0;
+  int i = 0;		// next object to expand.
+  int j;
+
+  gc_n_taken = 0;
+  while( gc_n_taken < gc_n_candidates ) {
+    mrb_value *v = &gc_candidates[gc_n_candidates - gc_n_taken - 1];
+    int n0 = n;
+
+    if( GC_COLOR(v) != MRBC_GC_GRAY ) {
+      if( max_objects > 0 && n >= max_objects ) break;
+      if( gc_reserve_list(n + 1) != 0 ) goto NOMEMORY;
+      GC_SET_COLOR(v, MRBC_GC_GRAY);
+      gc_list[n++] = *v;
+    }
+
+    // breadth first. the list itself is the queue.
+    for( ; i < n; i++ ) {
+      mrb_value *p2;
+      mrb_value *p1 = gc_children(&gc_list[i], &p2);
+
+      for( ; p1 < p2; p1++ ) {
+	if( !gc_is_object(p1) ) continue;
+	if( GC_COLOR(p1) == MRBC_GC_GRAY ) continue;
+
+	if( max_objects > 0 && n >= max_objects ) goto FULL;
+	if( gc_reserve_list(n + 1) != 0 ) goto NOMEMORY;
+	GC_SET_COLOR(p1, MRBC_GC_GRAY);
+	gc_list[n++] = *p1;
+      }
+    }
+    gc_n_taken++;
+    continue;
+
+  FULL:
+    if( n0 == 0 ) {
+      gc_n_taken++;		// the first one. check the cut off list.
+    } else {
+      // leave the candidate for the next step.
+      for( j = n0; j < n; j++ ) {
+	GC_SET_COLOR(&gc_list[j], MRBC_GC_BLACK);
+      }
+      n = i = n0;
+    }
+    break;
+  }
+
+  *n_expanded = i;
+  return n;
+
+ NOMEMORY:
+  for( j = 0; j < n; j++ ) {
+    GC_SET_COLOR(&gc_list[j], MRBC_GC_BLACK);
+  }
+  gc_free_list();
+  return -1;
+}
+
+
+//================================================================
+/*! mark gray; subtract the references from inside of the list.
+
+  @param  n	num of the listed objects.
+*/
+static void gc_mark_gray(int n)
+{
+  int i;
+  for( i = 0; i < n; i++ ) {
+    mrb_value *p2;
+    mrb_value *p1 = gc_children(&gc_list[i], &p2);
+
+    for( ; p1 < p2; p1++ ) {
+      if( !gc_is_object(p1) ) continue;
+      if( GC_COLOR(p1) != MRBC_GC_GRAY ) continue;	// not listed.
+      assert( p1->instance->ref_count != 0 );
+      p1->instance->ref_count--;
+    }
+  }
+}
+
+
+//================================================================
+/*! scan black; restore the references from the live objects.
+
+  The live objects are colored MRBC_GC_SCANNED, to tell them from
+  the objects not listed. The entries after n are used as the stack
+  of the live objects to be scanned. An object is pushed only once,
+  when it turns live.
+
+  @param  n		num of the listed objects.
+  @param  n_expanded	num of the objects whose children are listed.
+*/
+static void gc_scan_black(int n, int n_expanded)
+{
+  int top = n;
+  int i;
+
+  for( i = 0; i < n; i++ ) {
+    // the objects not expanded may be referenced from the objects not
+    // listed. treat them as live.
+    if( i < n_expanded && gc_list[i].instance->ref_count == 0 ) continue;
+    GC_SET_COLOR(&gc_list[i], MRBC_GC_SCANNED);
+    gc_list[top++] = gc_list[i];
+  }
+
+  while( top > n ) {
+    mrb_value *p2;
+    mrb_value *p1 = gc_children(&gc_list[--top], &p2);
+
+    for( ; p1 < p2; p1++ ) {
+      if( !gc_is_object(p1) ) continue;
+      switch( GC_COLOR(p1) ) {
+      case MRBC_GC_GRAY:
+	GC_SET_COLOR(p1, MRBC_GC_SCANNED);
+	gc_list[top++] = *p1;
+	// fall through.
+      case MRBC_GC_SCANNED:
+	p1->instance->ref_count++;
+	break;
+
+      default:
+	break;			// not listed.
+      }
+    }
+  }
+}
+
+
+//================================================================
+/*! collect white; free the garbage objects.
+
+  The objects still gray are garbage. Their children are all listed,
+  and the references to the live children are already subtracted,
+  so the objects are freed without decrementing the counters.
+  The live objects turn black again.
+
+  @param  n	num of the listed objects.
+  @return	reclaimed bytes.
+*/
+static int gc_collect_white(int n)
+{
+  int reclaimed = 0;
+  int i;
+
+  // decide first. the children of a freed object can't be read.
+  for( i = 0; i < n; i++ ) {
+    mrb_value *v = &gc_list[i];
+    if( GC_COLOR(v) == MRBC_GC_GRAY ) {
+      GC_SET_COLOR(v, MRBC_GC_WHITE);
+    } else {
+      // the live objects may be held only by the temporary registers.
+      // (see mrbc_release_temp)
+      GC_SET_COLOR(v, MRBC_GC_BLACK);
+      v->instance->gc_flag |= MRBC_GC_SURVIVED;
+    }
+  }
+  for( i = 0; i < n; i++ ) {
+    mrb_value *v = &gc_list[i];
+    if( GC_COLOR(v) != MRBC_GC_WHITE ) continue;
+
+    // a candidate left for the next step.
+    if( v->instance->gc_flag & MRBC_GC_BUFFERED ) mrbc_gc_remove_candidate(v);
+    reclaimed += gc_free_object(v);
+  }
+
+  return reclaimed;
+}
+
+
+//================================================================
+/*! register the object as a candidate of a garbage cycle.
+
+  Called when the reference counter is decremented but not to zero.
+  Only container objects can make a cycle.
+
+  @param  v	pointer to target value.
+*/
+void mrbc_gc_add_candidate(const mrb_value *v)
+{
+  switch( mrbc_type(*v) ) {
+  case MRB_TT_OBJECT:
+  case MRB_TT_ARRAY:
+  case MRB_TT_RANGE:
+  case MRB_TT_HASH:
+    break;
+
+  default:
+    return;
+  }
+
+  if( v->instance->gc_flag & MRBC_GC_BUFFERED ) return;
+  if( gc_n_candidates >= MRBC_GC_CANDIDATES ) {
+    gc_lost++;
+    return;
+  }
+
+  v->instance->gc_flag |= MRBC_GC_BUFFERED;
+  v->instance->gc_flag &= ~MRBC_GC_SURVIVED;
+  gc_candidates[gc_n_candidates++] = *v;
+}
+
+
+//================================================================
+/*! remove the object from the candidates.
+
+  Called before the candidate object is freed.
+
+  @param  v	pointer to target value.
+*/
+void mrbc_gc_remove_candidate(const mrb_value *v)
+{
+  int i;
+  for( i = 0; i < gc_n_candidates; i++ ) {
+    if( gc_candidates[i].handle == v->handle ) {
+      gc_candidates[i] = gc_candidates[--gc_n_candidates];
+      break;
+    }
+  }
+  v->instance->gc_flag &= ~MRBC_GC_BUFFERED;
+}
+
+
+//================================================================
+/*! remove the candidates owned by the VM.
+
+  Called before the memory of the VM is freed at once.
+
+  @param  vm_id	VM ID.
+*/
+void mrbc_gc_clear_candidates(int vm_id)
+{
+  int i = 0;
+  while( i < gc_n_candidates ) {
+    if( mrbc_get_vm_id(gc_candidates[i].handle) == vm_id ) {
+      gc_candidates[i] = gc_candidates[--gc_n_candidates];
+    } else {
+      i++;
+    }
+  }
+}
+
+
+//================================================================
+/*! number of the candidates.
+*/
+int mrbc_gc_num_candidates(void)
+{
+  return gc_n_candidates;
+}
+
+
+//================================================================
+/*! is a collection requested by the low memory hook?
+*/
+int mrbc_gc_is_requested(void)
+{
+  return gc_requested;
+}
+
+
+//================================================================
+/*! collect garbage cycles in a bounded step.
+
+  Call this only between the instructions of the VMs.
+  (e.g. the scheduler idle time)
+
+  @param  max_objects	maximum number of the objects to trace. 0: no limit.
+  @return		reclaimed bytes.
+*/
+int mrbc_gc_step(int max_objects)
+{
+  if( gc_n_candidates == 0 ) return 0;
+
+  int n_expanded;
+  int n = gc_list_objects(max_objects, &n_expanded);
+  if( n < 0 ) return 0;			// no memory. try again later.
+
+  // the stack of gc_scan_black() needs n more entries.
+  if( gc_reserve_list(n * 2) != 0 ) {
+    int i;
+    for( i = 0; i < n; i++ ) {
+      GC_SET_COLOR(&gc_list[i], MRBC_GC_BLACK);
+    }
+    gc_free_list();
+    return 0;
+  }
+
+  // remove the taken candidates from the buffer.
+  while( gc_n_taken-- > 0 ) {
+    gc_candidates[--gc_n_candidates].instance->gc_flag &= ~MRBC_GC_BUFFERED;
+  }
+
+  gc_mark_gray(n);
+  gc_scan_black(n, n_expanded);
+  int reclaimed = gc_collect_white(n);
+  gc_free_list();
+
+  gc_reclaimed += reclaimed;
+  return reclaimed;
+}
+
+
+//================================================================
+/*! collect garbage cycles from all the candidates.
+
+  The number of the traced objects is not limited.
+
+  @return	reclaimed bytes.
+*/
+int mrbc_gc_collect(void)
+{
+  gc_requested = 0;
+  return mrbc_gc_step( 0 );
+}
+
+
+//================================================================
+/*! statistics
+
+  @param  *candidates	returns number of the candidates.
+  @param  *lost		returns number of the dropped candidates.
+  @param  *reclaimed	returns total reclaimed bytes.
+*/
+void mrbc_gc_statistics(int *candidates, int *lost, int *reclaimed)
+{
+  *candidates = gc_n_candidates;
+  *lost = gc_lost;
+  *reclaimed = gc_reclaimed;
+}
+
+#endif  // MRBC_GC_CANDIDATES > 0
+
+
+
+/*
+
+  Deferred release.
+
+  Releasing the last reference to a large Array or Hash frees the whole
+  graph at once, and it may take a long time. If enabled, such container
+  objects are pushed to the free queue instead, and released a few
+  references per step between the timeslices.
+
+  The queue is a LIFO, so the children dropped to zero are processed
+  before their parent, and the queue needs only the depth of the graph.
+  If the queue is full, the object is released at once as before.
+
+*/
+
+#if MRBC_FREE_QUEUE_SIZE > 0
+
+static mrb_value free_queue[MRBC_FREE_QUEUE_SIZE];
+static int free_queue_top;
+static int flag_deferred_free;
+
+
+//================================================================
+/*! enable or disable deferred release.
+
+  @param  flag	1: enable, 0: disable (default)
+*/
+void mrbc_set_deferred_free(int flag)
+{
+  flag_deferred_free = flag;
+}
+
+
+//================================================================
+/*! push the object to the free queue.
+
+  Called when the reference counter becomes zero.
+
+  @param  v	pointer to target value.
+  @retval 0	pushed.
+  @retval -1	not pushed. release it now.
+*/
+int mrbc_deferred_free(const mrb_value *v)
+{
+  if( !flag_deferred_free ) return -1;
+
+  switch( mrbc_type(*v) ) {
+  case MRB_TT_OBJECT:
+  case MRB_TT_ARRAY:
+  case MRB_TT_RANGE:
+  case MRB_TT_HASH:
+    break;
+
+  default:
+    return -1;		// no reference in it.
+  }
+
+  if( free_queue_top >= MRBC_FREE_QUEUE_SIZE ) return -1;
+
+  free_queue[free_queue_top++] = *v;
+  return 0;
+}
+
+
+//================================================================
+/*! number of the objects in the free queue.
+*/
+int mrbc_deferred_free_pending(void)
+{
+  return free_queue_top;
+}
+
+
+//================================================================
+/*! release references of the queued objects.
+
+  Call this only between the instructions of the VMs.
+
+  @param  n	maximum number of the references to release.
+  @return	number of the objects still in the queue.
+*/
+int mrbc_deferred_free_step(int n)
+{
+  while( free_queue_top > 0 && n > 0 ) {
+    mrb_value *v = &free_queue[free_queue_top - 1];
+
+    // release the last reference held by the object.
+    // (note) it may push the child to the queue.
+    switch( mrbc_type(*v) ) {
+    case MRB_TT_OBJECT:
+      if( v->instance->n_ivar == 0 ) break;
+      v->instance->n_ivar--;
+      mrbc_dec_ref_counter( &v->instance->ivar[v->instance->n_ivar] );
+      n--;
+      continue;
+
+    case MRB_TT_ARRAY:
+      if( v->array->n_stored == 0 ) break;
+      mrbc_dec_ref_counter( &v->array->data[--v->array->n_stored] );
+      n--;
+      continue;
+
+    case MRB_TT_HASH:
+      if( v->hash->n_stored == 0 ) break;
+      mrbc_dec_ref_counter( &v->hash->data[--v->hash->n_stored] );
+      n--;
+      continue;
+
+    case MRB_TT_RANGE:
+      if( mrbc_type(v->range->first) != MRB_TT_EMPTY ) {
+	mrbc_release( &v->range->first );
+	n--;
+	continue;
+      }
+      if( mrbc_type(v->range->last) != MRB_TT_EMPTY ) {
+	mrbc_release( &v->range->last );
+	n--;
+	continue;
+      }
+      break;
+
+    default:
+      break;
+    }
+
+    // no more references. free it.
+    free_queue_top--;
+    gc_free_object(v);
+  }
+
+  return free_queue_top;
+}
+
+
+//================================================================
+/*! release all the queued objects.
+*/
+void mrbc_deferred_free_all(void)
+{
+  while( mrbc_deferred_free_step( MRBC_FREE_STEP_SIZE ) > 0 )
+    ;
+}
+
+#endif  // MRBC_FREE_QUEUE_SIZE > 0
+
+
+
+#if MRBC_GC_CANDIDATES > 0 || MRBC_FREE_QUEUE_SIZE > 0
+//================================================================
+/*! low memory hook. (see mrbc_add_low_memory_hook)
+
+  Releases the deferred objects. The hook is called in the middle of
+  an instruction, so the garbage cycles are not collected here; a
+  collection is requested to the scheduler instead.
+  (see mrbc_gc_is_requested)
+
+  @param  size	request size. (not used)
+  @return	nonzero if something was released.
+*/
+int mrbc_gc_low_memory_hook(unsigned int size)
+{
+  int released = 0;
+
+#if MRBC_FREE_QUEUE_SIZE > 0
+  if( mrbc_deferred_free_pending() > 0 ) {
+    mrbc_deferred_free_all();
+    released = 1;
+  }
+#endif
+#if MRBC_GC_CANDIDATES > 0
+  if( gc_n_candidates > 0 ) gc_requested = 1;
+#endif
+
+  return released;
+}
+#endif
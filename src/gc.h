@@ -0,0 +1,61 @@
+/*! @file
+  @brief
+  mruby/c cycle collector and deferred release for reference counted
+  objects.
+
+  <pre>
+  Copyright (C) 2015-2018 Kyushu Institute of Technology.
+  Copyright (C) 2015-2018 Shimane IT Open-Innovation Center.
+
+  This file is distributed under BSD 3-Clause License.
+
+  </pre>
+*/
+
+#ifndef MRBC_SRC_GC_H_
+#define MRBC_SRC_GC_H_
+
+#include "value.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// bits of gc_flag in MRBC_OBJECT_HEADER
+#define MRBC_GC_BLACK		0x00	// in use or not checked.
+#define MRBC_GC_GRAY		0x01	// possible member of a garbage cycle.
+#define MRBC_GC_WHITE		0x02	// garbage.
+#define MRBC_GC_SCANNED		0x03	// live, in the list of the collector.
+#define MRBC_GC_COLOR_MASK	0x03
+#define MRBC_GC_BUFFERED	0x04	// registered as a candidate.
+#define MRBC_GC_SURVIVED	0x08	// found live by the collector.
+
+
+#if MRBC_GC_CANDIDATES > 0
+void mrbc_gc_add_candidate(const mrb_value *v);
+void mrbc_gc_remove_candidate(const mrb_value *v);
+void mrbc_gc_clear_candidates(int vm_id);
+int mrbc_gc_num_candidates(void);
+int mrbc_gc_is_requested(void);
+int mrbc_gc_step(int max_objects);
+int mrbc_gc_collect(void);
+void mrbc_gc_statistics(int *candidates, int *lost, int *reclaimed);
+#endif
+
+#if MRBC_FREE_QUEUE_SIZE > 0
+void mrbc_set_deferred_free(int flag);
+int mrbc_deferred_free(const mrb_value *v);
+int mrbc_deferred_free_pending(void);
+int mrbc_deferred_free_step(int n);
+void mrbc_deferred_free_all(void);
+#endif
+
+#if MRBC_GC_CANDIDATES > 0 || MRBC_FREE_QUEUE_SIZE > 0
+int mrbc_gc_low_memory_hook(unsigned int size);
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif
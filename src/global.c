@@ -1,115 +1,147 @@
 
 #include "vm_config.h"
-#include <assert.h>
 #include "value.h"
 #include "static.h"
 #include "global.h"
 #include "mrubyc.h"
+#include "console.h"
 
 /*
 
-  GLobal objects are stored in 'mrbc_global' array.
-  'mrbc_global' array is decending order by sym_id.
-  In case of searching a global object, binary search is used.
-  In case of adding a global object, insertion sort is used.
+  Global objects and constants are stored in separate hash tables,
+  indexed by sym_id. The tables use open addressing, and are allocated
+  from the heap. They grow on demand. Entries are never removed.
 
 */
 
-typedef enum {
-  MRBC_GLOBAL_OBJECT = 1,
-  MRBC_CONST_OBJECT,
-} mrbc_globaltype;
-
 typedef struct GLOBAL_OBJECT {
-  mrbc_globaltype gtype : 8;
-  mrb_sym sym_id;
+  mrb_sym sym_id;		// -1: empty
   mrb_object obj;
 } mrb_globalobject;
 
-// max of global object in mrbc_global[]
-static int global_end;
-static mrb_globalobject mrbc_global[MAX_GLOBAL_OBJECT_SIZE];
+typedef struct GLOBAL_TABLE {
+  mrb_globalobject *data;
+  uint16_t size;		// power of 2.
+  uint16_t n_stored;
+} mrb_globaltable;
+
+static mrb_globaltable mrbc_global;
+static mrb_globaltable mrbc_const;
+
+// bumped by every const_object_add(), to invalidate the constant caches.
+uint32_t mrbc_const_epoch = 1;
 
 //
 void  mrbc_init_global(void)
 {
-  global_end = 0;
+  mrbc_global.data = NULL;
+  mrbc_global.size = 0;
+  mrbc_global.n_stored = 0;
+  mrbc_const = mrbc_global;
+  mrbc_const_epoch = 1;
 }
 
 /* search */
-/* linear search is not efficient! */
-/* TODO: Use binary search */
-static int search_global_object(mrb_sym sym_id, mrbc_globaltype gtype)
+/* returns the slot of sym_id, or the empty slot to add it. */
+static mrb_globalobject * search_global_object(const mrb_globaltable *table, mrb_sym sym_id)
 {
+  if( table->size == 0 ) return NULL;
+
+  // sym_id is dense, so it is a good hash value as it is.
+  int mask = table->size - 1;
+  int i = sym_id & mask;
+  while( 1 ) {
+    mrb_globalobject *obj = &table->data[i];
+    if( obj->sym_id == sym_id || obj->sym_id < 0 ) return obj;
+    i = (i + 1) & mask;
+  }
+}
+
+/* resize */
+/* doubles the size, and rehashes. */
+static int resize_global_table(mrb_globaltable *table, int init_size)
+{
+  int size = table->size ? table->size * 2 : init_size;
+  if( size > 0x8000 ) return -1;
+
+  mrb_globalobject *data = mrbc_raw_alloc( sizeof(mrb_globalobject) * size );
+  if( data == NULL ) return -1;		// ENOMEM
+
+  mrb_globaltable new_table = { data, size, table->n_stored };
   int i;
-  for( i=0 ; i<global_end ; i++ ){
-    mrb_globalobject *obj = &mrbc_global[i];
-    if( obj->sym_id == sym_id && obj->gtype == gtype ) return i;
+  for( i = 0; i < size; i++ ) {
+    data[i].sym_id = -1;
   }
-  return -1;
+  for( i = 0; i < table->size; i++ ) {
+    if( table->data[i].sym_id < 0 ) continue;
+    *search_global_object( &new_table, table->data[i].sym_id ) = table->data[i];
+  }
+
+  if( table->data ) mrbc_raw_free( table->data );
+  *table = new_table;
+  return 0;
 }
 
-/* add */
-/* TODO: Check reference count */
-void global_object_add(mrb_sym sym_id, mrb_value v)
+/* set */
+/* keeps the load factor under 3/4. */
+static void set_global_object(mrb_globaltable *table, int init_size, mrb_sym sym_id, mrb_value *v)
 {
-  int index = search_global_object(sym_id, MRBC_GLOBAL_OBJECT);
-  if( index == -1 ) {
-    index = global_end++;
-    assert( index < MAX_GLOBAL_OBJECT_SIZE );	// maybe raise ex
+  mrb_globalobject *obj = search_global_object(table, sym_id);
+  if( obj && obj->sym_id == sym_id ) {
+    // warning: already initialized constant.
+    mrbc_release( &obj->obj );
   } else {
-    mrbc_release( &(mrbc_global[index].obj) );
+    if( (table->n_stored + 1) * 4 > table->size * 3 ) {
+      if( resize_global_table(table, init_size) != 0 ) {
+	console_printf( "Overflow global objects for '%s'\n",
+			symid_to_str(sym_id) );	// maybe raise ex
+	return;
+      }
+      obj = search_global_object(table, sym_id);
+    }
+    obj->sym_id = sym_id;
+    table->n_stored++;
   }
 
-  mrbc_global[index].gtype = MRBC_GLOBAL_OBJECT;
-  mrbc_global[index].sym_id = sym_id;
-  mrbc_global[index].obj = v;
-  mrbc_dup( &v );
+  obj->obj = *v;
+  mrbc_dup( v );
+}
+
+/* get */
+static mrb_value get_global_object(const mrb_globaltable *table, mrb_sym sym_id)
+{
+  mrb_globalobject *obj = search_global_object(table, sym_id);
+  if( obj == NULL || obj->sym_id < 0 ) return mrb_nil_value();
+
+  mrbc_dup( &obj->obj );
+  return obj->obj;
+}
+
+/* add */
+/* TODO: Check reference count */
+void global_object_add(mrb_sym sym_id, mrb_value v)
+{
+  set_global_object( &mrbc_global, MAX_GLOBAL_OBJECT_SIZE, sym_id, &v );
 }
 
 /* add const */
 /* TODO: Check reference count */
-/* TODO: Integrate with global_add */
 void const_object_add(mrb_sym sym_id, mrb_object *obj)
 {
-  int index = search_global_object(sym_id, MRBC_CONST_OBJECT);
-  if( index == -1 ){
-    index = global_end;
-    global_end++;
-    assert( index < MAX_GLOBAL_OBJECT_SIZE );	// maybe raise ex
-  } else {
-    // warning: already initialized constant.
-    mrbc_release( &(mrbc_global[index].obj) );
-  }
-  mrbc_global[index].gtype = MRBC_CONST_OBJECT;
-  mrbc_global[index].sym_id = sym_id;
-  mrbc_global[index].obj = *obj;
-  mrbc_dup( obj );
+  set_global_object( &mrbc_const, MAX_CONST_COUNT, sym_id, obj );
+  if( ++mrbc_const_epoch == 0 ) mrbc_const_epoch = 1;	// 0 is not cached.
 }
 
 /* get */
 mrb_value global_object_get(mrb_sym sym_id)
 {
-  int index = search_global_object(sym_id, MRBC_GLOBAL_OBJECT);
-  if( index >= 0 ){
-    mrbc_dup( &mrbc_global[index].obj );
-    return mrbc_global[index].obj;
-  } else {
-    return mrb_nil_value();
-  }
+  return get_global_object( &mrbc_global, sym_id );
 }
 
 /* get const */
-/* TODO: Integrate with get_global_object */
 mrb_object const_object_get(mrb_sym sym_id)
 {
-  int index = search_global_object(sym_id, MRBC_CONST_OBJECT);
-  if( index >= 0 ){
-    mrbc_dup( &mrbc_global[index].obj );
-    return mrbc_global[index].obj;
-  } else {
-    return mrb_nil_value();
-  }
+  return get_global_object( &mrbc_const, sym_id );
 }
 
 
@@ -117,7 +149,12 @@ mrb_object const_object_get(mrb_sym sym_id)
 void mrbc_global_clear_vm_id(void)
 {
   int i;
-  for( i = 0; i < global_end; i++ ) {
-    mrbc_clear_vm_id( &mrbc_global[i].obj );
+  for( i = 0; i < mrbc_global.size; i++ ) {
+    if( mrbc_global.data[i].sym_id < 0 ) continue;
+    mrbc_clear_vm_id( &mrbc_global.data[i].obj );
+  }
+  for( i = 0; i < mrbc_const.size; i++ ) {
+    if( mrbc_const.data[i].sym_id < 0 ) continue;
+    mrbc_clear_vm_id( &mrbc_const.data[i].obj );
   }
 }
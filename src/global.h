@@ -21,6 +21,8 @@ extern "C" {
 #endif
 
 
+extern uint32_t mrbc_const_epoch;
+
 void  mrbc_init_global(void);
 
 void global_object_add(mrb_sym sym_id, mrb_value v);
@@ -115,6 +115,8 @@ void mrbc_kv_clear_vm_id(mrb_kv_handle *kvh)
 */
 int mrbc_kv_resize(mrb_kv_handle *kvh, int size)
 {
+  if( size > 0xffff ) return E_NOMEMORY_ERROR;	// over the data_size.
+
   mrb_kv *data2 = mrbc_raw_realloc(kvh->data, sizeof(mrb_kv) * size);
   if( !data2 ) return E_NOMEMORY_ERROR;		// ENOMEM
 
@@ -125,6 +127,35 @@ int mrbc_kv_resize(mrb_kv_handle *kvh, int size)
 }
 
 
+//================================================================
+/*! reserve buffer
+
+  @param  kvh	pointer to key-value handle.
+  @param  size	number of elements to be stored without resize.
+  @return	mrb_error_code.
+*/
+int mrbc_kv_reserve(mrb_kv_handle *kvh, int size)
+{
+  if( size <= kvh->data_size ) return 0;
+
+  return mrbc_kv_resize(kvh, size);
+}
+
+
+//================================================================
+/*! shrink buffer to the number of stored data
+
+  @param  kvh	pointer to key-value handle.
+  @return	mrb_error_code.
+*/
+int mrbc_kv_shrink_to_fit(mrb_kv_handle *kvh)
+{
+  if( kvh->n_stored == kvh->data_size ) return 0;
+
+  return mrbc_kv_resize(kvh, kvh->n_stored);
+}
+
+
 
 //================================================================
 /*! setter
@@ -156,7 +187,7 @@ int mrbc_kv_set(mrb_kv_handle *kvh, mrb_sym sym_id, mrb_value *set_val)
  INSERT_VALUE:
   // need resize?
   if( kvh->n_stored >= kvh->data_size ) {
-    if( mrbc_kv_resize(kvh, kvh->data_size + 5) != 0 )
+    if( mrbc_kv_resize(kvh, mrbc_grow_size(kvh->data_size)) != 0 )
       return E_NOMEMORY_ERROR;		// ENOMEM
   }
 
@@ -205,7 +236,7 @@ int mrbc_kv_append(mrb_kv_handle *kvh, mrb_sym sym_id, mrb_value *set_val)
 {
   // need resize?
   if( kvh->n_stored >= kvh->data_size ) {
-    if( mrbc_kv_resize(kvh, kvh->data_size + 5) != 0 )
+    if( mrbc_kv_resize(kvh, mrbc_grow_size(kvh->data_size)) != 0 )
       return E_NOMEMORY_ERROR;		// ENOMEM
   }
 
@@ -45,6 +45,8 @@ mrb_kv_handle *mrbc_kv_new(struct VM *vm, int size);
 void mrbc_kv_delete(mrb_kv_handle *kvh);
 void mrbc_kv_clear_vm_id(mrb_kv_handle *kvh);
 int mrbc_kv_resize(mrb_kv_handle *kvh, int size);
+int mrbc_kv_reserve(mrb_kv_handle *kvh, int size);
+int mrbc_kv_shrink_to_fit(mrb_kv_handle *kvh);
 int mrbc_kv_set(mrb_kv_handle *kvh, mrb_sym sym_id, mrb_value *set_val);
 mrb_value *mrbc_kv_get(mrb_kv_handle *kvh, mrb_sym sym_id);
 int mrbc_kv_append(mrb_kv_handle *kvh, mrb_sym sym_id, mrb_value *set_val);
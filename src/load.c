@@ -20,6 +20,8 @@
 #include "errorcode.h"
 #include "value.h"
 #include "alloc.h"
+#include "symbol.h"
+#include "opcode.h"
 
 
 //================================================================
@@ -68,6 +70,124 @@ static int load_header(mrb_vm *vm, const uint8_t **pos)
 
 
 
+#if MRBC_USE_DECODED_ISEQ
+//================================================================
+/*!@brief
+  convert ISEQ to pre-decoded instructions.
+
+  @param  p	A pointer of ISEQ (big endian byte codes).
+  @param  ilen	n of byte code.
+  @return	Pointer of allocated instructions or NULL
+*/
+static mrbc_insn * load_iseq(const uint8_t *p, int ilen)
+{
+  mrbc_insn *iseq = (mrbc_insn *)mrbc_alloc(0, sizeof(mrbc_insn) * ilen);
+  if( iseq == NULL ) return NULL;
+
+  int i;
+  for( i = 0; i < ilen; i++ ) {
+    uint32_t code = bin_to_uint32(p);	p += 4;
+    iseq[i].op = code & 0x7f;
+    iseq[i].a  = (code >> 23) & 0x1ff;
+    iseq[i].b  = (code >> 14) & 0x1ff;
+    iseq[i].c  = (code >>  7) & 0x7f;
+    iseq[i].bx = (code >>  7) & 0xffff;
+  }
+
+  return iseq;
+}
+#endif
+
+
+#if MRBC_USE_SUPERINSTRUCTION
+#if !MRBC_USE_DECODED_ISEQ
+#error "MRBC_USE_SUPERINSTRUCTION needs MRBC_USE_DECODED_ISEQ."
+#endif
+//================================================================
+/*!@brief
+  rewrite common opcode pairs into fused opcodes.
+
+  Only the first instruction of a pair is rewritten. The second one
+  is left as is, so it can still be a jump target.
+
+  @param  iseq	A pointer of pre-decoded instructions.
+  @param  ilen	n of instructions.
+*/
+static void fuse_iseq(mrbc_insn *iseq, int ilen)
+{
+  static const struct {
+    uint8_t op1, op2, fused;
+  } pairs[] = {
+    { OP_EQ,       OP_JMPIF,  OP_X_EQ_JMPIF },
+    { OP_EQ,       OP_JMPNOT, OP_X_EQ_JMPNOT },
+    { OP_LT,       OP_JMPIF,  OP_X_LT_JMPIF },
+    { OP_LT,       OP_JMPNOT, OP_X_LT_JMPNOT },
+    { OP_LE,       OP_JMPIF,  OP_X_LE_JMPIF },
+    { OP_LE,       OP_JMPNOT, OP_X_LE_JMPNOT },
+    { OP_GT,       OP_JMPIF,  OP_X_GT_JMPIF },
+    { OP_GT,       OP_JMPNOT, OP_X_GT_JMPNOT },
+    { OP_GE,       OP_JMPIF,  OP_X_GE_JMPIF },
+    { OP_GE,       OP_JMPNOT, OP_X_GE_JMPNOT },
+    { OP_LOADI,    OP_ADD,    OP_X_LOADI_ADD },
+    { OP_LOADI,    OP_SUB,    OP_X_LOADI_SUB },
+    { OP_LOADI,    OP_LT,     OP_X_LOADI_LT },
+    { OP_MOVE,     OP_SEND,   OP_X_MOVE_SEND },
+    { OP_LOADSELF, OP_SEND,   OP_X_LOADSELF_SEND },
+    { OP_GETIV,    OP_SEND,   OP_X_GETIV_SEND },
+  };
+  int i, j;
+
+  // iseq[i+1].op is not rewritten yet, when iseq[i] is checked.
+  for( i = 0; i < ilen - 1; i++ ) {
+    for( j = 0; j < sizeof(pairs) / sizeof(pairs[0]); j++ ) {
+      if( iseq[i].op == pairs[j].op1 && iseq[i+1].op == pairs[j].op2 ) {
+        iseq[i].op = pairs[j].fused;
+        break;
+      }
+    }
+  }
+}
+#endif
+
+
+#if MRBC_USE_CONST_CACHE
+//================================================================
+/*!@brief
+  allocate the constant caches of OP_GETCONST.
+
+  Constants are global and searched by symbol, so the sites which have
+  the same symbol index share one cache. It is indexed by the symbol
+  index, up to the largest one used by OP_GETCONST.
+
+  @param  irep	A pointer of irep. code and syms must be loaded.
+  @return	0 if no error.
+*/
+static int alloc_const_cache(mrb_irep *irep)
+{
+  int n = 0;
+  int i;
+  for( i = 0; i < irep->ilen; i++ ) {
+#if MRBC_USE_DECODED_ISEQ
+    mrbc_code_t code = (mrbc_insn *)irep->code + i;
+#else
+    mrbc_code_t code = bin_to_uint32(irep->code + i * 4);
+#endif
+    if( GET_OPCODE(code) == OP_GETCONST && GETARG_Bx(code) >= n ) {
+      n = GETARG_Bx(code) + 1;
+    }
+  }
+  if( n == 0 ) return 0;
+
+  irep->const_cache = (mrbc_const_cache *)mrbc_alloc(0, sizeof(mrbc_const_cache) * n);
+  if( irep->const_cache == NULL ) return -1;
+  for( i = 0; i < n; i++ ) {
+    irep->const_cache[i].epoch = 0;
+  }
+  return 0;
+}
+#endif
+
+
 //================================================================
 /*!@brief
   read one irep section.
@@ -128,7 +248,18 @@ static mrb_irep * load_irep_1(mrb_vm *vm, const uint8_t **pos)
   }
 
   // ISEQ (code) BLOCK
+#if MRBC_USE_DECODED_ISEQ
+  irep->code = (uint8_t *)load_iseq(p, irep->ilen);
+  if( irep->code == NULL ) {
+    vm->error_code = LOAD_FILE_IREP_ERROR_ALLOCATION;
+    return NULL;
+  }
+#if MRBC_USE_SUPERINSTRUCTION
+  fuse_iseq((mrbc_insn *)irep->code, irep->ilen);
+#endif
+#else
   irep->code = (uint8_t *)p;
+#endif
   p += irep->ilen * 4;
 
   // POOL BLOCK
@@ -153,7 +284,7 @@ static mrb_irep * load_irep_1(mrb_vm *vm, const uint8_t **pos)
     switch( tt ) {
 #if MRBC_USE_STRING
     case 0: { // IREP_TT_STRING
-      obj->tt = MRB_TT_STRING;
+      mrbc_set_tt(obj, MRB_TT_STRING);
       obj->str = (char*)p;
     } break;
 #endif
@@ -161,16 +292,14 @@ static mrb_irep * load_irep_1(mrb_vm *vm, const uint8_t **pos)
       char buf[obj_size+1];
       memcpy(buf, p, obj_size);
       buf[obj_size] = '\0';
-      obj->tt = MRB_TT_FIXNUM;
-      obj->i = atol(buf);
+      mrbc_set_integer(obj, atol(buf));
     } break;
 #if MRBC_USE_FLOAT
     case 2: { // IREP_TT_FLOAT
       char buf[obj_size+1];
       memcpy(buf, p, obj_size);
       buf[obj_size] = '\0';
-      obj->tt = MRB_TT_FLOAT;
-      obj->d = atof(buf);
+      mrbc_set_float(obj, mrbc_atof(buf));
     } break;
 #endif
     default:
@@ -183,12 +312,29 @@ static mrb_irep * load_irep_1(mrb_vm *vm, const uint8_t **pos)
 
   // SYMS BLOCK
   irep->ptr_to_sym = (uint8_t*)p;
-  int slen = bin_to_uint32(p);		p += 4;
-  while( --slen >= 0 ) {
+  irep->slen = bin_to_uint32(p);	p += 4;
+  if( irep->slen ) {
+    irep->syms = (mrb_sym *)mrbc_alloc(0, sizeof(mrb_sym) * irep->slen);
+    if( irep->syms == NULL ) {
+      vm->error_code = LOAD_FILE_IREP_ERROR_ALLOCATION;
+      return NULL;
+    }
+  }
+
+  // resolve symbols once, so that the VM doesn't need to search by name.
+  for( i = 0; i < irep->slen; i++ ) {
     int s = bin_to_uint16(p);		p += 2;
+    irep->syms[i] = str_to_symid((const char *)p);
     p += s+1;
   }
 
+#if MRBC_USE_CONST_CACHE
+  if( alloc_const_cache(irep) != 0 ) {
+    vm->error_code = LOAD_FILE_IREP_ERROR_ALLOCATION;
+    return NULL;
+  }
+#endif
+
   *pos = p;
   return irep;
 }
@@ -22,6 +22,7 @@
 #include "static.h"
 #include "alloc.h"
 #include "global.h"
+#include "gc.h"
 #include "symbol.h"
 #include "class.h"
 #include "c_array.h"
@@ -15,16 +15,56 @@
 #ifndef MRBC_SRC_OPCODE_H_
 #define MRBC_SRC_OPCODE_H_
 
+#include <stdint.h>
+#include "vm_config.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 
+#define MAXARG_Bx                   (0xffff)
+#define MAXARG_sBx                  (MAXARG_Bx>>1)
+
+#if MRBC_USE_DECODED_ISEQ
+//================================================================
+/*!@brief
+  Pre-decoded instruction.
+
+  ISEQ is converted to an array of this structure at load time,
+  so the VM can fetch operands without byte swapping and shifting.
+*/
+typedef struct MRBC_INSN {
+  uint8_t  op;		//!< opcode
+  uint8_t  c;		//!< C
+  uint16_t a;		//!< A
+  uint16_t b;		//!< B
+  uint16_t bx;		//!< Bx (B<<7|C)
+} mrbc_insn;
+
+typedef mrbc_insn mrbc_iseq_t;		//!< element type of ISEQ
+typedef const mrbc_insn *mrbc_code_t;	//!< instruction passed to op_xxx
+
+#define GET_OPCODE(code)            ((code)->op)
+#define GETARG_A(code)              ((code)->a)
+#define GETARG_B(code)              ((code)->b)
+#define GETARG_C(code)              ((code)->c)
+#define GETARG_Ax(code)             (((uint32_t)(code)->a << 16) | (code)->bx)
+#define GETARG_Bx(code)             ((code)->bx)
+#define GETARG_Bz(code)             ((code)->bx >> 2)
+
+#define MKCODE(op,a,b,c)            { (op), (c), (a), (b), ((b)<<7)|(c) }
+
+#else
+typedef uint32_t mrbc_iseq_t;		//!< element type of ISEQ
+typedef uint32_t mrbc_code_t;		//!< instruction passed to op_xxx
+
 #define GET_OPCODE(code)            ((code) & 0x7f)
 #define GETARG_A(code)              (((code) >> 23) & 0x1ff)
 #define GETARG_B(code)              (((code) >> 14) & 0x1ff)
 #define GETARG_C(code)              (((code) >>  7) & 0x7f)
 #define GETARG_Ax(code)             (((code) >>  7) & 0x1ffffff)
+#define GETARG_Bx(code)             (((code) >>  7) & 0xffff)
 
 #define GETARG_Bz(code)              GETARG_UNPACK_b(code,14,2)
 
@@ -35,12 +75,10 @@ extern "C" {
 #define MKARG_B(c)                  ((c & 0x1fc)<<6 | (c & 0x03)<<22)
 #define MKARG_C(c)                  ((c & 0x7e)<<15 | (c & 0x01)<<31)
 
+#define MKCODE(op,a,b,c)            (MKOPCODE(op) | MKARG_A(a) | MKARG_B(b) | MKARG_C(c))
+#endif
 
-#define MAXARG_Bx                   (0xffff)
-#define MAXARG_sBx                  (MAXARG_Bx>>1)
-#define GETARG_Bx(code)             (((code) >>  7) & 0xffff)
 #define GETARG_sBx(code)            (GETARG_Bx(code)-MAXARG_sBx)
-#define GETARG_C(code)              (((code) >>  7) & 0x7f)
 
 
 //================================================================
@@ -110,6 +148,24 @@ enum OPCODE {
   OP_STOP      = 0x4a,
 
   OP_ABORT     = 0x50,  // using OP_ABORT inside mruby/c only
+
+  // fused opcodes (superinstructions), made by the loader.
+  OP_X_EQ_JMPIF     = 0x51,
+  OP_X_EQ_JMPNOT    = 0x52,
+  OP_X_LT_JMPIF     = 0x53,
+  OP_X_LT_JMPNOT    = 0x54,
+  OP_X_LE_JMPIF     = 0x55,
+  OP_X_LE_JMPNOT    = 0x56,
+  OP_X_GT_JMPIF     = 0x57,
+  OP_X_GT_JMPNOT    = 0x58,
+  OP_X_GE_JMPIF     = 0x59,
+  OP_X_GE_JMPNOT    = 0x5a,
+  OP_X_LOADI_ADD    = 0x5b,
+  OP_X_LOADI_SUB    = 0x5c,
+  OP_X_LOADI_LT     = 0x5d,
+  OP_X_MOVE_SEND    = 0x5e,
+  OP_X_LOADSELF_SEND= 0x5f,
+  OP_X_GETIV_SEND   = 0x60,
 };
 
 #ifdef __cplusplus
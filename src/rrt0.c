@@ -25,8 +25,12 @@
 #include "load.h"
 #include "class.h"
 #include "vm.h"
+#include "symbol.h"
+#include "c_array.h"
+#include "c_hash.h"
 #include "console.h"
 #include "rrt0.h"
+#include "gc.h"
 #include "hal/hal.h"
 
 
@@ -164,7 +168,7 @@ static void c_sleep(mrb_vm *vm, mrb_value v[], int argc)
     return;
   }
 
-  switch( v[1].tt ) {
+  switch( mrbc_type(v[1]) ) {
   case MRB_TT_FIXNUM:
     mrbc_sleep_ms(tcb, GET_INT_ARG(1) * 1000);
     break;
@@ -229,7 +233,7 @@ static void c_suspend_task(mrb_vm *vm, mrb_value v[], int argc)
     return;
   }
 
-  if( v[1].tt != MRB_TT_HANDLE ) return;	// error.
+  if( mrbc_type(v[1]) != MRB_TT_HANDLE ) return;	// error.
   mrbc_suspend_task( (mrb_tcb *)(v[1].handle) );
 }
 
@@ -240,7 +244,7 @@ static void c_suspend_task(mrb_vm *vm, mrb_value v[], int argc)
 */
 static void c_resume_task(mrb_vm *vm, mrb_value v[], int argc)
 {
-  if( v[1].tt != MRB_TT_HANDLE ) return;	// error.
+  if( mrbc_type(v[1]) != MRB_TT_HANDLE ) return;	// error.
   mrbc_resume_task( (mrb_tcb *)(v[1].handle) );
 }
 
@@ -253,7 +257,7 @@ static void c_get_tcb(mrb_vm *vm, mrb_value v[], int argc)
 {
   mrb_tcb *tcb = VM2TCB(vm);
 
-  mrb_value value = {.tt = MRB_TT_HANDLE};
+  mrb_value value = MRBC_VALUE_INIT(MRB_TT_HANDLE);
   value.handle = (void*)tcb;
 
   SET_RETURN( value );
@@ -325,6 +329,98 @@ static void c_vm_tick(mrb_vm *vm, mrb_value v[], int argc)
 }
 
 
+//================================================================
+/*! VM.memory_stats
+
+  Returns a Hash of the heap statistics. vm_used and vm_peak are of
+  the calling VM. histogram is the number of allocations by size.
+*/
+static void c_vm_memory_stats(mrb_vm *vm, mrb_value v[], int argc)
+{
+  static const mrb_sym names[] = {
+    MRBC_SYM_total, MRBC_SYM_used, MRBC_SYM_free, MRBC_SYM_peak,
+    MRBC_SYM_largest_free, MRBC_SYM_vm_used, MRBC_SYM_vm_peak,
+  };
+  MRBC_ALLOC_STATS stats;
+  mrbc_alloc_get_stats( &stats );
+  int values[] = {
+    stats.total, stats.used, stats.free, stats.peak, stats.largest_free,
+    mrbc_alloc_vm_used(vm->vm_id), mrbc_alloc_vm_peak(vm->vm_id),
+  };
+
+  mrb_value ret = mrbc_hash_new(vm, sizeof(values) / sizeof(int) + 1);
+  if( ret.hash == NULL ) return;	// ENOMEM
+
+  int i;
+  for( i = 0; i < sizeof(values) / sizeof(int); i++ ) {
+    mrb_value key;
+    mrbc_set_symbol( &key, names[i] );
+    mrb_value val = mrb_fixnum_value(values[i]);
+    mrbc_hash_set(&ret, &key, &val);
+  }
+
+  mrb_value hist = mrbc_array_new(vm, MRBC_ALLOC_HISTOGRAM_BINS);
+  if( hist.array != NULL ) {
+    for( i = 0; i < MRBC_ALLOC_HISTOGRAM_BINS; i++ ) {
+      mrb_value val = mrb_fixnum_value(stats.histogram[i]);
+      mrbc_array_set(&hist, i, &val);
+    }
+    mrb_value key;
+    mrbc_set_symbol( &key, MRBC_SYM_histogram );
+    mrbc_hash_set(&ret, &key, &hist);
+  }
+
+  SET_RETURN(ret);
+}
+
+
+//================================================================
+/*! VM.memory_event
+
+  Returns a pending low memory event, :critical, :warning or
+  :recovered in this order, or nil. Call repeatedly until nil.
+  Each VM receives all the events.
+*/
+static void c_vm_memory_event(mrb_vm *vm, mrb_value v[], int argc)
+{
+  mrb_sym sym_id;
+
+  int events = mrbc_alloc_get_events();
+  if( events ) {
+    // deliver to the other tasks too.
+    mrb_tcb *queues[] = { q_dormant_, q_ready_, q_waiting_, q_suspended_ };
+    int i;
+    hal_disable_irq();
+    for( i = 0; i < sizeof(queues) / sizeof(queues[0]); i++ ) {
+      mrb_tcb *tcb;
+      for( tcb = queues[i]; tcb != NULL; tcb = tcb->next ) {
+	tcb->vm.memory_events |= events;
+      }
+    }
+    hal_enable_irq();
+    vm->memory_events |= events;
+  }
+
+  if( vm->memory_events & MRBC_ALLOC_EVENT_CRITICAL ) {
+    vm->memory_events &= ~MRBC_ALLOC_EVENT_CRITICAL;
+    sym_id = MRBC_SYM_critical;
+  } else if( vm->memory_events & MRBC_ALLOC_EVENT_WARNING ) {
+    vm->memory_events &= ~MRBC_ALLOC_EVENT_WARNING;
+    sym_id = MRBC_SYM_warning;
+  } else if( vm->memory_events & MRBC_ALLOC_EVENT_RECOVERED ) {
+    vm->memory_events &= ~MRBC_ALLOC_EVENT_RECOVERED;
+    sym_id = MRBC_SYM_recovered;
+  } else {
+    SET_NIL_RETURN();
+    return;
+  }
+
+  mrb_value ret;
+  mrbc_set_symbol( &ret, sym_id );
+  SET_RETURN(ret);
+}
+
+
 
 /***** Global functions *****************************************************/
 
@@ -373,6 +469,17 @@ void mrbc_tick(void)
 }
 
 
+//================================================================
+/*! get the tick counter.
+
+  @return	ticks since start.
+*/
+uint32_t mrbc_get_tick(void)
+{
+  return tick_;
+}
+
+
 
 //================================================================
 /*! initialize
@@ -381,6 +488,9 @@ void mrbc_tick(void)
 void mrbc_init(uint8_t *ptr, unsigned int size )
 {
   mrbc_init_alloc(ptr, size);
+#if MRBC_GC_CANDIDATES > 0 || MRBC_FREE_QUEUE_SIZE > 0
+  mrbc_add_low_memory_hook( mrbc_gc_low_memory_hook );
+#endif
   init_static();
   hal_init();
 
@@ -406,6 +516,8 @@ void mrbc_init(uint8_t *ptr, unsigned int size )
   mrb_class *c_vm;
   c_vm = mrbc_define_class(0, "VM", mrbc_class_object);
   mrbc_define_method(0, c_vm, "tick", c_vm_tick);
+  mrbc_define_method(0, c_vm, "memory_stats", c_vm_memory_stats);
+  mrbc_define_method(0, c_vm, "memory_event", c_vm_memory_event);
 }
 
 
@@ -455,7 +567,11 @@ mrb_tcb* mrbc_create_task(const uint8_t *vm_code, mrb_tcb *tcb)
     return NULL;
   }
   if( tcb->state != TASKSTATE_DORMANT ) {
-    mrbc_vm_begin( &tcb->vm );
+    if( mrbc_vm_begin( &tcb->vm ) != 0 ) {
+      console_printf("Error: Can't allocate registers.\n");
+      mrbc_vm_close( &tcb->vm );
+      return NULL;
+    }
   }
 
   hal_disable_irq();
@@ -477,7 +593,7 @@ int mrbc_start_task(mrb_tcb *tcb)
   if( tcb->state != TASKSTATE_DORMANT ) return -1;
   tcb->timeslice           = TIMESLICE_TICK;
   tcb->priority_preemption = tcb->priority;
-  mrbc_vm_begin(&tcb->vm);
+  if( mrbc_vm_begin(&tcb->vm) != 0 ) return -1;
 
   hal_disable_irq();
 
@@ -506,6 +622,17 @@ int mrbc_run(void)
     mrb_tcb *tcb = q_ready_;
     if( tcb == NULL ) {
       // 実行すべきタスクなし
+#if MRBC_FREE_QUEUE_SIZE > 0
+      if( mrbc_deferred_free_step( MRBC_FREE_STEP_SIZE ) > 0 ) continue;
+#endif
+#if MRBC_GC_CANDIDATES > 0
+      // collect garbage cycles in idle time.
+      if( mrbc_gc_num_candidates() > 0 ) {
+        mrbc_gc_step( MRBC_GC_STEP_SIZE );
+        continue;
+      }
+#endif
+      mrbc_alloc_restore_reserve();
       hal_idle_cpu();
       continue;
     }
@@ -559,6 +686,22 @@ int mrbc_run(void)
     }
     hal_enable_irq();
 
+#if MRBC_FREE_QUEUE_SIZE > 0
+    // release the large objects step by step between the timeslices.
+    mrbc_deferred_free_step( MRBC_FREE_STEP_SIZE );
+#endif
+#if MRBC_GC_CANDIDATES > 0
+    // collect all if the memory ran short in the timeslice, or step
+    // before the candidate buffer overflows, if no idle time.
+    if( mrbc_gc_is_requested() ) {
+      mrbc_gc_collect();
+    } else if( mrbc_gc_num_candidates() >= MRBC_GC_CANDIDATES / 2 ) {
+      mrbc_gc_step( MRBC_GC_STEP_SIZE );
+    }
+#endif
+    // take the emergency reserve again, if it was used.
+    mrbc_alloc_restore_reserve();
+
   } // eternal loop
 }
 
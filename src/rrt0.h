@@ -85,6 +85,7 @@ typedef struct RMutex {
 /***** Global variables *****************************************************/
 /***** Function prototypes **************************************************/
 void mrbc_tick(void);
+uint32_t mrbc_get_tick(void);
 void mrbc_init(uint8_t *ptr, unsigned int size);
 void mrbc_init_tcb(mrb_tcb *tcb);
 mrb_tcb *mrbc_create_task(const uint8_t *vm_code, mrb_tcb *tcb);
@@ -36,6 +36,7 @@ mrb_class *mrbc_class_hash;
 
 void init_static(void)
 {
+  mrbc_init_symbol();
   mrbc_init_global();
 
   mrbc_init_class();
@@ -27,8 +27,8 @@
 #include "console.h"
 
 
-#if !defined(MRBC_SYMBOL_SEARCH_LINER) && !defined(MRBC_SYMBOL_SEARCH_BTREE)
-#define MRBC_SYMBOL_SEARCH_BTREE
+#if !defined(MRBC_SYMBOL_SEARCH_LINER) && !defined(MRBC_SYMBOL_SEARCH_HASH)
+#define MRBC_SYMBOL_SEARCH_HASH
 #endif
 
 #ifndef MRBC_SYMBOL_TABLE_INDEX_TYPE
@@ -36,90 +36,176 @@
 #endif
 
 struct SYM_INDEX {
-  uint16_t hash;	//!< hash value, returned by calc_hash().
-#ifdef MRBC_SYMBOL_SEARCH_BTREE
-  MRBC_SYMBOL_TABLE_INDEX_TYPE left;
-  MRBC_SYMBOL_TABLE_INDEX_TYPE right;
-#endif
+  uint32_t hash;	//!< hash value, returned by calc_hash().
   const char *cstr;	//!< point to the symbol string.
 };
 
 
-static struct SYM_INDEX sym_index[MAX_SYMBOLS_COUNT];
+// built-in symbols in ROM. (generated by tools/sym_gen/sym_gen.rb)
+#define MRBC_SYMBOL_BUILTIN_TABLE
+#include "symbol_builtin.h"
+
+#if MAX_SYMBOLS_COUNT + MRBC_SYM_BUILTIN_COUNT > 32767
+#error "MAX_SYMBOLS_COUNT is too large."
+#endif
+
+// symbols added at runtime. sym_id is MRBC_SYM_BUILTIN_COUNT + index.
+// the tables are allocated from the heap, and grow on demand.
+static struct SYM_INDEX *sym_index;
 static int sym_index_pos;	// point to the last(free) sym_index array.
+static int sym_index_size;	// allocated size of sym_index.
+
+#ifdef MRBC_SYMBOL_SEARCH_HASH
+// open addressing hash table. keeps the load factor under 1/2.
+// index + 1 of each slot. 0 is empty.
+static MRBC_SYMBOL_TABLE_INDEX_TYPE *sym_table;
+static int sym_table_size;	// power of 2.
+#endif
+
+// arena of the symbol names. names are never released.
+static char *sym_arena;
+static int sym_arena_left;
+
+
+//================================================================
+/*! search built-in symbols
+ */
+static int search_builtin( uint32_t hash, const char *str )
+{
+  int i = hash & (BUILTIN_SYM_TABLE_SIZE - 1);
+  while( builtin_sym_table[i] != 0 ) {
+    int sym_id = builtin_sym_table[i] - 1;
+    if( builtin_sym_index[sym_id].hash == hash &&
+	strcmp(str, builtin_sym_index[sym_id].cstr) == 0 ) {
+      return sym_id;
+    }
+    i = (i + 1) & (BUILTIN_SYM_TABLE_SIZE - 1);
+  }
+  return -1;
+}
 
 
 //================================================================
 /*! search index table
  */
-static int search_index( uint16_t hash, const char *str )
+static int search_index( uint32_t hash, const char *str )
 {
+  int sym_id = search_builtin( hash, str );
+  if( sym_id >= 0 ) return sym_id;
+
 #ifdef MRBC_SYMBOL_SEARCH_LINER
   int i;
   for( i = 0; i < sym_index_pos; i++ ) {
     if( sym_index[i].hash == hash && strcmp(str, sym_index[i].cstr) == 0 ) {
-      return i;
+      return MRBC_SYM_BUILTIN_COUNT + i;
     }
   }
   return -1;
 #endif
 
-#ifdef MRBC_SYMBOL_SEARCH_BTREE
-  int i = 0;
-  do {
-    if( sym_index[i].hash == hash && strcmp(str, sym_index[i].cstr) == 0 ) {
-      return i;
-    }
-    if( hash < sym_index[i].hash ) {
-      i = sym_index[i].left;
-    } else {
-      i = sym_index[i].right;
+#ifdef MRBC_SYMBOL_SEARCH_HASH
+  if( sym_table == NULL ) return -1;
+
+  int i = hash & (sym_table_size - 1);
+  while( sym_table[i] != 0 ) {
+    int idx = sym_table[i] - 1;
+    if( sym_index[idx].hash == hash &&
+	strcmp(str, sym_index[idx].cstr) == 0 ) {
+      return MRBC_SYM_BUILTIN_COUNT + idx;
     }
-  } while( i != 0 );
+    i = (i + 1) & (sym_table_size - 1);
+  }
   return -1;
 #endif
 }
 
 
+//================================================================
+/*! extend sym_index.
+
+  @retval 0	No error.
+  @retval -1	Out of memory.
+*/
+static int resize_index(void)
+{
+  int size = sym_index_size ?
+    sym_index_size + sym_index_size / 2 : MRBC_SYMBOL_TABLE_INIT_SIZE;
+
+  struct SYM_INDEX *index = sym_index ?
+    mrbc_raw_realloc( sym_index, sizeof(struct SYM_INDEX) * size ) :
+    mrbc_raw_alloc( sizeof(struct SYM_INDEX) * size );
+  if( index == NULL ) return -1;	// ENOMEM
+
+  sym_index = index;
+  sym_index_size = size;
+  return 0;
+}
+
+
+#ifdef MRBC_SYMBOL_SEARCH_HASH
+//================================================================
+/*! double the size of the hash table, and rehash.
+
+  @retval 0	No error.
+  @retval -1	Out of memory.
+*/
+static int resize_table(void)
+{
+  int size = sym_table_size ?
+    sym_table_size * 2 : MRBC_SYMBOL_TABLE_INIT_SIZE * 2;
+
+  MRBC_SYMBOL_TABLE_INDEX_TYPE *table =
+    mrbc_raw_alloc( sizeof(MRBC_SYMBOL_TABLE_INDEX_TYPE) * size );
+  if( table == NULL ) return -1;	// ENOMEM
+  memset( table, 0, sizeof(MRBC_SYMBOL_TABLE_INDEX_TYPE) * size );
+
+  int idx;
+  for( idx = 0; idx < sym_index_pos; idx++ ) {
+    int i = sym_index[idx].hash & (size - 1);
+    while( table[i] != 0 ) {
+      i = (i + 1) & (size - 1);
+    }
+    table[i] = idx + 1;
+  }
+
+  if( sym_table ) mrbc_raw_free( sym_table );
+  sym_table = table;
+  sym_table_size = size;
+  return 0;
+}
+#endif
+
+
 //================================================================
 /*! add to index table
  */
-static int add_index( uint16_t hash, const char *str )
+static int add_index( uint32_t hash, const char *str )
 {
-  // check overflow.
-  if( sym_index_pos >= MAX_SYMBOLS_COUNT ) {
+  // check overflow, and extend the tables.
+  if( sym_index_pos >= MAX_SYMBOLS_COUNT ||
+      (sym_index_pos >= sym_index_size && resize_index() != 0)
+#ifdef MRBC_SYMBOL_SEARCH_HASH
+      || ((sym_index_pos + 1) * 2 > sym_table_size && resize_table() != 0)
+#endif
+      ) {
     console_printf( "Overflow %s for '%s'\n", "MAX_SYMBOLS_COUNT", str );
     return -1;
   }
 
-  int sym_id = sym_index_pos++;
+  int idx = sym_index_pos++;
 
   // append table.
-  sym_index[sym_id].hash = hash;
-  sym_index[sym_id].cstr = str;
-
-#ifdef MRBC_SYMBOL_SEARCH_BTREE
-  int i = 0;
-
-  while( 1 ) {
-    if( hash < sym_index[i].hash ) {
-      // left side
-      if( sym_index[i].left == 0 ) {	// left is empty?
-        sym_index[i].left = sym_id;
-        break;
-      }
-      i = sym_index[i].left;
-    } else {
-      // right side
-      if( sym_index[i].right == 0 ) {	// right is empty?
-        sym_index[i].right = sym_id;
-        break;
-      }
-      i = sym_index[i].right;
-    }
+  sym_index[idx].hash = hash;
+  sym_index[idx].cstr = str;
+
+#ifdef MRBC_SYMBOL_SEARCH_HASH
+  int i = hash & (sym_table_size - 1);
+  while( sym_table[i] != 0 ) {
+    i = (i + 1) & (sym_table_size - 1);
   }
+  sym_table[i] = idx + 1;
 #endif
-  return sym_id;
+  return MRBC_SYM_BUILTIN_COUNT + idx;
 }
 
 
@@ -132,39 +218,51 @@ static int add_index( uint16_t hash, const char *str )
 */
 mrb_value mrbc_symbol_new(struct VM *vm, const char *str)
 {
-  mrb_value ret = {.tt = MRB_TT_SYMBOL};
-  uint16_t h = calc_hash(str);
+  mrb_value ret = MRBC_VALUE_INIT(MRB_TT_SYMBOL);
+  uint32_t h = calc_hash(str);
   mrb_sym sym_id = search_index(h, str);
 
   if( sym_id >= 0 ) {
-    ret.i = sym_id;
+    mrbc_symbol(ret) = sym_id;
     return ret;		// already exist.
   }
 
-  // create symbol object dynamically.
+  // copy the name to the arena.
   int size = strlen(str) + 1;
-  char *buf = mrbc_raw_alloc(size);
+  char *buf;
+  if( size > MRBC_SYMBOL_ARENA_SIZE / 4 ) {
+    buf = mrbc_raw_alloc(size);		// too large for the arena.
+  } else {
+    if( size > sym_arena_left ) {
+      sym_arena = mrbc_raw_alloc(MRBC_SYMBOL_ARENA_SIZE);
+      sym_arena_left = sym_arena ? MRBC_SYMBOL_ARENA_SIZE : 0;
+    }
+    buf = sym_arena;
+    sym_arena += size;
+    sym_arena_left -= size;
+  }
   if( buf == NULL ) return ret;		// ENOMEM raise?
 
   memcpy(buf, str, size);
-  ret.i = add_index( h, buf );
+  mrbc_symbol(ret) = add_index( h, buf );
 
   return ret;
 }
 
 
 //================================================================
-/*! Calculate hash value.
+/*! Calculate hash value. (32-bit FNV-1a)
 
   @param  str		Target string.
-  @return uint16_t	Hash value.
+  @return uint32_t	Hash value.
 */
-uint16_t calc_hash(const char *str)
+uint32_t calc_hash(const char *str)
 {
-  uint16_t h = 0;
+  uint32_t h = 2166136261U;
 
   while( *str != '\0' ) {
-    h = h * 37 + *str;
+    h ^= (uint8_t)*str;
+    h *= 16777619U;
     str++;
   }
   return h;
@@ -179,7 +277,7 @@ uint16_t calc_hash(const char *str)
 */
 mrb_sym str_to_symid(const char *str)
 {
-  uint16_t h = calc_hash(str);
+  uint32_t h = calc_hash(str);
   mrb_sym sym_id = search_index(h, str);
   if( sym_id >= 0 ) return sym_id;
 
@@ -187,6 +285,19 @@ mrb_sym str_to_symid(const char *str)
 }
 
 
+//================================================================
+/*! search a symbol, without adding it.
+
+  @param  str		Target string.
+  @return mrb_sym	Symbol value.
+  @retval -1		Not found.
+*/
+mrb_sym mrbc_search_symid(const char *str)
+{
+  return search_index( calc_hash(str), str );
+}
+
+
 //================================================================
 /*! Convert symbol value to string.
 
@@ -197,6 +308,10 @@ mrb_sym str_to_symid(const char *str)
 const char * symid_to_str(mrb_sym sym_id)
 {
   if( sym_id < 0 ) return NULL;
+  if( sym_id < MRBC_SYM_BUILTIN_COUNT ) {
+    return builtin_sym_index[sym_id].cstr;
+  }
+  sym_id -= MRBC_SYM_BUILTIN_COUNT;
   if( sym_id >= sym_index_pos ) return NULL;
 
   return sym_index[sym_id].cstr;
@@ -209,12 +324,13 @@ const char * symid_to_str(mrb_sym sym_id)
 */
 static void c_all_symbols(mrb_vm *vm, mrb_value v[], int argc)
 {
-  mrb_value ret = mrbc_array_new(vm, sym_index_pos);
+  int n = MRBC_SYM_BUILTIN_COUNT + sym_index_pos;
+  mrb_value ret = mrbc_array_new(vm, n);
 
   int i;
-  for( i = 0; i < sym_index_pos; i++ ) {
-    mrb_value sym1 = {.tt = MRB_TT_SYMBOL};
-    sym1.i = i;
+  for( i = 0; i < n; i++ ) {
+    mrb_value sym1 = MRBC_VALUE_INIT(MRB_TT_SYMBOL);
+    mrbc_symbol(sym1) = i;
     mrbc_array_push(&ret, &sym1);
   }
   SET_RETURN(ret);
@@ -227,7 +343,7 @@ static void c_all_symbols(mrb_vm *vm, mrb_value v[], int argc)
 */
 static void c_to_s(mrb_vm *vm, mrb_value v[], int argc)
 {
-  v[0] = mrbc_string_new_cstr(vm, symid_to_str(v[0].i));
+  v[0] = mrbc_string_new_cstr(vm, symid_to_str(mrbc_symbol(v[0])));
 }
 #endif
 
@@ -246,6 +362,25 @@ static void c_equal3(mrb_vm *vm, mrb_value v[], int argc)
 }
 
 
+//================================================================
+/*! initialize the symbol table
+
+  Drops the symbols added at runtime. The built-in symbols remain.
+*/
+void mrbc_init_symbol(void)
+{
+  sym_index = NULL;
+  sym_index_pos = 0;
+  sym_index_size = 0;
+#ifdef MRBC_SYMBOL_SEARCH_HASH
+  sym_table = NULL;
+  sym_table_size = 0;
+#endif
+  sym_arena = NULL;
+  sym_arena_left = 0;
+}
+
+
 //================================================================
 /*! initialize
 */
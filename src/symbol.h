@@ -15,6 +15,7 @@
 #define MRBC_SRC_SYMBOL_H_
 
 #include "value.h"
+#include "symbol_builtin.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,9 +24,11 @@ extern "C" {
 struct VM;
 
 mrb_value mrbc_symbol_new(struct VM *vm, const char *str);
-uint16_t calc_hash(const char *str);
+uint32_t calc_hash(const char *str);
 mrb_sym str_to_symid(const char *str);
+mrb_sym mrbc_search_symid(const char *str);
 const char *symid_to_str(mrb_sym sym_id);
+void mrbc_init_symbol(void);
 void mrbc_init_class_symbol(struct VM *vm);
 
 
@@ -34,7 +37,7 @@ void mrbc_init_class_symbol(struct VM *vm);
 */
 static inline const char * mrbc_symbol_cstr(const mrb_value *v)
 {
-  return symid_to_str(v->i);
+  return symid_to_str(mrbc_symbol(*v));
 }
 
 
@@ -0,0 +1,458 @@
+/*! @file
+  @brief
+  mruby/c built-in symbols.
+
+  <pre>
+  Copyright (C) 2015-2018 Kyushu Institute of Technology.
+  Copyright (C) 2015-2018 Shimane IT Open-Innovation Center.
+
+  This file is distributed under BSD 3-Clause License.
+
+  Generated by tools/sym_gen/sym_gen.rb. DO NOT EDIT.
+  </pre>
+*/
+
+#ifndef MRBC_SRC_SYMBOL_BUILTIN_H_
+#define MRBC_SRC_SYMBOL_BUILTIN_H_
+
+#define MRBC_SYM_BUILTIN_COUNT 191
+
+#define MRBC_SYM_Array                   0	// Array
+#define MRBC_SYM_new                     1	// new
+#define MRBC_SYM_OP_add                  2	// +
+#define MRBC_SYM_OP_aref                 3	// []
+#define MRBC_SYM_at                      4	// at
+#define MRBC_SYM_OP_aset                 5	// []=
+#define MRBC_SYM_OP_lshift               6	// <<
+#define MRBC_SYM_clear                   7	// clear
+#define MRBC_SYM_reserve                 8	// reserve
+#define MRBC_SYM_shrink_to_fit           9	// shrink_to_fit
+#define MRBC_SYM_delete_at               10	// delete_at
+#define MRBC_SYM_Q_empty                 11	// empty?
+#define MRBC_SYM_size                    12	// size
+#define MRBC_SYM_length                  13	// length
+#define MRBC_SYM_count                   14	// count
+#define MRBC_SYM_index                   15	// index
+#define MRBC_SYM_first                   16	// first
+#define MRBC_SYM_last                    17	// last
+#define MRBC_SYM_push                    18	// push
+#define MRBC_SYM_pop                     19	// pop
+#define MRBC_SYM_shift                   20	// shift
+#define MRBC_SYM_unshift                 21	// unshift
+#define MRBC_SYM_dup                     22	// dup
+#define MRBC_SYM_each                    23	// each
+#define MRBC_SYM_min                     24	// min
+#define MRBC_SYM_max                     25	// max
+#define MRBC_SYM_minmax                  26	// minmax
+#define MRBC_SYM_Hash                    27	// Hash
+#define MRBC_SYM_delete                  28	// delete
+#define MRBC_SYM_Q_has_key               29	// has_key?
+#define MRBC_SYM_Q_has_value             30	// has_value?
+#define MRBC_SYM_key                     31	// key
+#define MRBC_SYM_keys                    32	// keys
+#define MRBC_SYM_merge                   33	// merge
+#define MRBC_SYM_B_merge                 34	// merge!
+#define MRBC_SYM_to_h                    35	// to_h
+#define MRBC_SYM_values                  36	// values
+#define MRBC_SYM_Math                    37	// Math
+#define MRBC_SYM_acos                    38	// acos
+#define MRBC_SYM_acosh                   39	// acosh
+#define MRBC_SYM_asin                    40	// asin
+#define MRBC_SYM_asinh                   41	// asinh
+#define MRBC_SYM_atan                    42	// atan
+#define MRBC_SYM_atan2                   43	// atan2
+#define MRBC_SYM_atanh                   44	// atanh
+#define MRBC_SYM_cbrt                    45	// cbrt
+#define MRBC_SYM_cos                     46	// cos
+#define MRBC_SYM_cosh                    47	// cosh
+#define MRBC_SYM_erf                     48	// erf
+#define MRBC_SYM_erfc                    49	// erfc
+#define MRBC_SYM_exp                     50	// exp
+#define MRBC_SYM_hypot                   51	// hypot
+#define MRBC_SYM_ldexp                   52	// ldexp
+#define MRBC_SYM_log                     53	// log
+#define MRBC_SYM_log10                   54	// log10
+#define MRBC_SYM_log2                    55	// log2
+#define MRBC_SYM_sin                     56	// sin
+#define MRBC_SYM_sinh                    57	// sinh
+#define MRBC_SYM_sqrt                    58	// sqrt
+#define MRBC_SYM_tan                     59	// tan
+#define MRBC_SYM_tanh                    60	// tanh
+#define MRBC_SYM_Fixnum                  61	// Fixnum
+#define MRBC_SYM_Float                   62	// Float
+#define MRBC_SYM_OP_minus                63	// -@
+#define MRBC_SYM_OP_pow                  64	// **
+#define MRBC_SYM_OP_mod                  65	// %
+#define MRBC_SYM_OP_and                  66	// &
+#define MRBC_SYM_OP_or                   67	// |
+#define MRBC_SYM_OP_xor                  68	// ^
+#define MRBC_SYM_OP_neg                  69	// ~
+#define MRBC_SYM_OP_rshift               70	// >>
+#define MRBC_SYM_abs                     71	// abs
+#define MRBC_SYM_to_i                    72	// to_i
+#define MRBC_SYM_times                   73	// times
+#define MRBC_SYM_to_f                    74	// to_f
+#define MRBC_SYM_chr                     75	// chr
+#define MRBC_SYM_to_s                    76	// to_s
+#define MRBC_SYM_Range                   77	// Range
+#define MRBC_SYM_OP_eqq                  78	// ===
+#define MRBC_SYM_String                  79	// String
+#define MRBC_SYM_chomp                   80	// chomp
+#define MRBC_SYM_B_chomp                 81	// chomp!
+#define MRBC_SYM_ord                     82	// ord
+#define MRBC_SYM_lstrip                  83	// lstrip
+#define MRBC_SYM_B_lstrip                84	// lstrip!
+#define MRBC_SYM_rstrip                  85	// rstrip
+#define MRBC_SYM_B_rstrip                86	// rstrip!
+#define MRBC_SYM_strip                   87	// strip
+#define MRBC_SYM_B_strip                 88	// strip!
+#define MRBC_SYM_to_sym                  89	// to_sym
+#define MRBC_SYM_intern                  90	// intern
+#define MRBC_SYM_sprintf                 91	// sprintf
+#define MRBC_SYM_Object                  92	// Object
+#define MRBC_SYM_Proc                    93	// Proc
+#define MRBC_SYM_NilClass                94	// NilClass
+#define MRBC_SYM_FalseClass              95	// FalseClass
+#define MRBC_SYM_TrueClass               96	// TrueClass
+#define MRBC_SYM_puts                    97	// puts
+#define MRBC_SYM_OP_not                  98	// !
+#define MRBC_SYM_OP_neq                  99	// !=
+#define MRBC_SYM_OP_cmp                  100	// <=>
+#define MRBC_SYM_class                   101	// class
+#define MRBC_SYM_attr_reader             102	// attr_reader
+#define MRBC_SYM_attr_accessor           103	// attr_accessor
+#define MRBC_SYM_instance_methods        104	// instance_methods
+#define MRBC_SYM_p                       105	// p
+#define MRBC_SYM_call                    106	// call
+#define MRBC_SYM_initialize              107	// initialize
+#define MRBC_SYM_Mrubyc                  108	// Mrubyc
+#define MRBC_SYM_version                 109	// version
+#define MRBC_SYM_Arduino                 110	// Arduino
+#define MRBC_SYM_Serial                  111	// Serial
+#define MRBC_SYM_delay                   112	// delay
+#define MRBC_SYM_pin_mode                113	// pin_mode
+#define MRBC_SYM_digital_write           114	// digital_write
+#define MRBC_SYM_digital_read            115	// digital_read
+#define MRBC_SYM_random                  116	// random
+#define MRBC_SYM_begin                   117	// begin
+#define MRBC_SYM_end                     118	// end
+#define MRBC_SYM_available               119	// available
+#define MRBC_SYM_readline                120	// readline
+#define MRBC_SYM_write                   121	// write
+#define MRBC_SYM_INPUT                   122	// INPUT
+#define MRBC_SYM_OUTPUT                  123	// OUTPUT
+#define MRBC_SYM_INPUT_PULLUP            124	// INPUT_PULLUP
+#define MRBC_SYM_HIGH                    125	// HIGH
+#define MRBC_SYM_Esp                     126	// Esp
+#define MRBC_SYM_idf_version             127	// idf_version
+#define MRBC_SYM_M5Avatar                128	// M5Avatar
+#define MRBC_SYM_speech                  129	// speech
+#define MRBC_SYM_M5                      130	// M5
+#define MRBC_SYM_Lcd                     131	// Lcd
+#define MRBC_SYM_update                  132	// update
+#define MRBC_SYM_width                   133	// width
+#define MRBC_SYM_height                  134	// height
+#define MRBC_SYM_fill_screen             135	// fill_screen
+#define MRBC_SYM_set_cursor              136	// set_cursor
+#define MRBC_SYM_set_text_color          137	// set_text_color
+#define MRBC_SYM_set_text_size           138	// set_text_size
+#define MRBC_SYM_printf                  139	// printf
+#define MRBC_SYM_draw_rect               140	// draw_rect
+#define MRBC_SYM_fill_rect               141	// fill_rect
+#define MRBC_SYM_draw_circle             142	// draw_circle
+#define MRBC_SYM_fill_circle             143	// fill_circle
+#define MRBC_SYM_draw_triangle           144	// draw_triangle
+#define MRBC_SYM_fill_triangle           145	// fill_triangle
+#define MRBC_SYM_WHITE                   146	// WHITE
+#define MRBC_SYM_RED                     147	// RED
+#define MRBC_SYM_GREEN                   148	// GREEN
+#define MRBC_SYM_BLUE                    149	// BLUE
+#define MRBC_SYM_YELLOW                  150	// YELLOW
+#define MRBC_SYM_BLACK                   151	// BLACK
+#define MRBC_SYM_RGB_LCD                 152	// RGB_LCD
+#define MRBC_SYM_set_rgb                 153	// set_rgb
+#define MRBC_SYM_Mutex                   154	// Mutex
+#define MRBC_SYM_VM                      155	// VM
+#define MRBC_SYM_sleep                   156	// sleep
+#define MRBC_SYM_sleep_ms                157	// sleep_ms
+#define MRBC_SYM_relinquish              158	// relinquish
+#define MRBC_SYM_change_priority         159	// change_priority
+#define MRBC_SYM_suspend_task            160	// suspend_task
+#define MRBC_SYM_resume_task             161	// resume_task
+#define MRBC_SYM_get_tcb                 162	// get_tcb
+#define MRBC_SYM_lock                    163	// lock
+#define MRBC_SYM_unlock                  164	// unlock
+#define MRBC_SYM_try_lock                165	// try_lock
+#define MRBC_SYM_tick                    166	// tick
+#define MRBC_SYM_memory_stats            167	// memory_stats
+#define MRBC_SYM_memory_event            168	// memory_event
+#define MRBC_SYM_total                   169	// total
+#define MRBC_SYM_used                    170	// used
+#define MRBC_SYM_free                    171	// free
+#define MRBC_SYM_peak                    172	// peak
+#define MRBC_SYM_largest_free            173	// largest_free
+#define MRBC_SYM_vm_used                 174	// vm_used
+#define MRBC_SYM_vm_peak                 175	// vm_peak
+#define MRBC_SYM_histogram               176	// histogram
+#define MRBC_SYM_critical                177	// critical
+#define MRBC_SYM_warning                 178	// warning
+#define MRBC_SYM_recovered               179	// recovered
+#define MRBC_SYM_Symbol                  180	// Symbol
+#define MRBC_SYM_all_symbols             181	// all_symbols
+#define MRBC_SYM_id2name                 182	// id2name
+#define MRBC_SYM_OP_sub                  183	// -
+#define MRBC_SYM_OP_mul                  184	// *
+#define MRBC_SYM_OP_div                  185	// /
+#define MRBC_SYM_OP_eq                   186	// ==
+#define MRBC_SYM_OP_lt                   187	// <
+#define MRBC_SYM_OP_le                   188	// <=
+#define MRBC_SYM_OP_gt                   189	// >
+#define MRBC_SYM_OP_ge                   190	// >=
+
+#endif
+
+
+#ifdef MRBC_SYMBOL_BUILTIN_TABLE
+// symbol id -> hash and name.
+static const struct SYM_INDEX builtin_sym_index[MRBC_SYM_BUILTIN_COUNT] = {
+  { 0x16c8fcc6, "Array" },
+  { 0x28999611, "new" },
+  { 0x2e0c9daa, "+" },
+  { 0x741638a5, "[]" },
+  { 0x57251588, "at" },
+  { 0x56fb1748, "[]=" },
+  { 0x95f72345, "<<" },
+  { 0x5c6e1222, "clear" },
+  { 0x27291b4b, "reserve" },
+  { 0xde6fd8f8, "shrink_to_fit" },
+  { 0xcb4e5ffa, "delete_at" },
+  { 0xa1116303, "empty?" },
+  { 0x23a0d95c, "size" },
+  { 0x83d03615, "length" },
+  { 0x39b1ddf4, "count" },
+  { 0x090aa9ab, "index" },
+  { 0x4881d841, "first" },
+  { 0x63e1d819, "last" },
+  { 0x876fffdd, "push" },
+  { 0x51335fd0, "pop" },
+  { 0x54019347, "shift" },
+  { 0x77555602, "unshift" },
+  { 0xd330f226, "dup" },
+  { 0x147aa128, "each" },
+  { 0xc98f4557, "min" },
+  { 0xd7a2e319, "max" },
+  { 0x662f465f, "minmax" },
+  { 0x4ef356f1, "Hash" },
+  { 0x67c2444a, "delete" },
+  { 0x795a8644, "has_key?" },
+  { 0x4a3861d6, "has_value?" },
+  { 0x6815c86c, "key" },
+  { 0xf94a08cd, "keys" },
+  { 0xb9764627, "merge" },
+  { 0xfb303b72, "merge!" },
+  { 0x2deb976b, "to_h" },
+  { 0x34474c3b, "values" },
+  { 0x5569c3af, "Math" },
+  { 0x3c01df1f, "acos" },
+  { 0xedf2c855, "acosh" },
+  { 0xfeae7ea6, "asin" },
+  { 0xbab19e4a, "asinh" },
+  { 0x0678cabf, "atan" },
+  { 0xbd26dbf7, "atan2" },
+  { 0x07275075, "atanh" },
+  { 0x54619836, "cbrt" },
+  { 0xfb8de29c, "cos" },
+  { 0xf45c461c, "cosh" },
+  { 0x78978610, "erf" },
+  { 0x4988a709, "erfc" },
+  { 0x72a68728, "exp" },
+  { 0x18265a25, "hypot" },
+  { 0x8c63f160, "ldexp" },
+  { 0x3f515151, "log" },
+  { 0x8be20730, "log10" },
+  { 0x10031ed9, "log2" },
+  { 0xe0302a4d, "sin" },
+  { 0x10d2583f, "sinh" },
+  { 0x7dee3bcf, "sqrt" },
+  { 0x9cf73498, "tan" },
+  { 0x092855d0, "tanh" },
+  { 0x11f69be8, "Fixnum" },
+  { 0x4c816225, "Float" },
+  { 0x83cdb8e8, "-@" },
+  { 0x27de7135, "**" },
+  { 0x200c87a0, "%" },
+  { 0x230c8c59, "&" },
+  { 0xf90c4a3b, "|" },
+  { 0xdb0c1b01, "^" },
+  { 0xfb0c4d61, "~" },
+  { 0x13fc66cd, ">>" },
+  { 0x2a48023b, "abs" },
+  { 0x2ceb95d8, "to_i" },
+  { 0x5d68eeb5, "times" },
+  { 0x2beb9445, "to_f" },
+  { 0x0a85ab74, "chr" },
+  { 0x36eba596, "to_s" },
+  { 0xa311e772, "Range" },
+  { 0x2377d0f6, "===" },
+  { 0x604f4858, "String" },
+  { 0x624925fe, "chomp" },
+  { 0x98269e0d, "chomp!" },
+  { 0x991deba0, "ord" },
+  { 0x1b112c03, "lstrip" },
+  { 0xbe087986, "lstrip!" },
+  { 0x4ce61c01, "rstrip" },
+  { 0x2e3e4660, "rstrip!" },
+  { 0xfd1b18d1, "strip" },
+  { 0x61a841d0, "strip!" },
+  { 0xac9912f0, "to_sym" },
+  { 0xeaeb5605, "intern" },
+  { 0x70e2d349, "sprintf" },
+  { 0xe58e64da, "Object" },
+  { 0x531dc701, "Proc" },
+  { 0xab378634, "NilClass" },
+  { 0x3baaae50, "FalseClass" },
+  { 0xe646dddf, "TrueClass" },
+  { 0x9c67d227, "puts" },
+  { 0x240c8dec, "!" },
+  { 0x90c34003, "!=" },
+  { 0x0d09cf64, "<=>" },
+  { 0xab3e0bff, "class" },
+  { 0xefdedfd8, "attr_reader" },
+  { 0x248e8b44, "attr_accessor" },
+  { 0xafd17c77, "instance_methods" },
+  { 0xf50c43ef, "p" },
+  { 0xb3f184a9, "call" },
+  { 0xce92964b, "initialize" },
+  { 0xcfc3c0e9, "Mrubyc" },
+  { 0x4671ae97, "version" },
+  { 0xab0d5a3b, "Arduino" },
+  { 0x08949299, "Serial" },
+  { 0x4ed1f1d8, "delay" },
+  { 0xc235ed2e, "pin_mode" },
+  { 0xcccb565b, "digital_write" },
+  { 0xd5b65760, "digital_read" },
+  { 0x144f0c62, "random" },
+  { 0x68348a7e, "begin" },
+  { 0x6a8e75aa, "end" },
+  { 0x66fdf298, "available" },
+  { 0x48487c27, "readline" },
+  { 0xbe269f5c, "write" },
+  { 0x61a2485b, "INPUT" },
+  { 0x5798c504, "OUTPUT" },
+  { 0xad9fcf46, "INPUT_PULLUP" },
+  { 0x7b2feefd, "HIGH" },
+  { 0xd9a051fb, "Esp" },
+  { 0x1acf7019, "idf_version" },
+  { 0xfe97e0de, "M5Avatar" },
+  { 0x5dcc0b17, "speech" },
+  { 0x17df8dd7, "M5" },
+  { 0xbee6a3f4, "Lcd" },
+  { 0x280f9474, "update" },
+  { 0x95876e1f, "width" },
+  { 0xd5bdbb42, "height" },
+  { 0x75fb4841, "fill_screen" },
+  { 0x367ce466, "set_cursor" },
+  { 0xa5bca6bb, "set_text_color" },
+  { 0x6228824d, "set_text_size" },
+  { 0xe76fb4aa, "printf" },
+  { 0x6083a592, "draw_rect" },
+  { 0x9e9c4537, "fill_rect" },
+  { 0x8c496ab8, "draw_circle" },
+  { 0x31339219, "fill_circle" },
+  { 0x56670160, "draw_triangle" },
+  { 0x7b995b75, "fill_triangle" },
+  { 0xaa3d6206, "WHITE" },
+  { 0x83ce97fc, "RED" },
+  { 0xab62935c, "GREEN" },
+  { 0x2cb7370d, "BLUE" },
+  { 0xb0abcf49, "YELLOW" },
+  { 0x68566c44, "BLACK" },
+  { 0xf176ff40, "RGB_LCD" },
+  { 0xc97a7177, "set_rgb" },
+  { 0xd11a5fe4, "Mutex" },
+  { 0x5ffa42ac, "VM" },
+  { 0x89eabb08, "sleep" },
+  { 0x0f062ae1, "sleep_ms" },
+  { 0xdc446bfb, "relinquish" },
+  { 0xf4fed82a, "change_priority" },
+  { 0xac3ff0b1, "suspend_task" },
+  { 0x0f5465e6, "resume_task" },
+  { 0x5ffa7045, "get_tcb" },
+  { 0xef0d7842, "lock" },
+  { 0x56661f55, "unlock" },
+  { 0xacdda30c, "try_lock" },
+  { 0x5b5630a4, "tick" },
+  { 0xdb5f801e, "memory_stats" },
+  { 0xc28c7e51, "memory_event" },
+  { 0x04d092fd, "total" },
+  { 0x6a786eb0, "used" },
+  { 0x99b3eedb, "free" },
+  { 0xb71f9b12, "peak" },
+  { 0x9d98deca, "largest_free" },
+  { 0x8cc563cc, "vm_used" },
+  { 0xc1001b1e, "vm_peak" },
+  { 0x31bd46a1, "histogram" },
+  { 0x51540388, "critical" },
+  { 0x792112ef, "warning" },
+  { 0x0de2e75a, "recovered" },
+  { 0x3a105ef1, "Symbol" },
+  { 0x6d2aa0d2, "all_symbols" },
+  { 0x512e5af5, "id2name" },
+  { 0x280c9438, "-" },
+  { 0x2f0c9f3d, "*" },
+  { 0x2a0c975e, "/" },
+  { 0x90f4dccf, "==" },
+  { 0x390caefb, "<" },
+  { 0x94f721b2, "<=" },
+  { 0x3b0cb221, ">" },
+  { 0x10fc6214, ">=" },
+};
+
+// open addressing hash table. sym_id + 1 of each slot. 0 is empty.
+#define BUILTIN_SYM_TABLE_SIZE 512
+static const uint16_t builtin_sym_table[BUILTIN_SYM_TABLE_SIZE] = {
+  0, 86, 22, 84, 100, 91, 147, 0, 0, 0, 0, 0,
+  0, 82, 0, 0, 49, 2, 0, 0, 191, 14, 0, 0,
+  0, 18, 128, 144, 48, 0, 168, 134, 0, 190, 8, 0,
+  0, 52, 23, 34, 63, 98, 121, 160, 0, 0, 0, 0,
+  0, 0, 0, 0, 95, 0, 46, 0, 184, 0, 0, 37,
+  68, 72, 111, 58, 0, 17, 136, 164, 30, 75, 152, 163,
+  0, 0, 29, 42, 108, 57, 139, 0, 96, 169, 0, 0,
+  0, 40, 0, 0, 80, 67, 0, 115, 123, 0, 0, 27,
+  87, 0, 117, 0, 0, 0, 137, 0, 0, 0, 0, 0,
+  32, 0, 0, 0, 0, 0, 0, 0, 133, 45, 0, 105,
+  0, 0, 0, 0, 0, 0, 118, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 110, 60, 112, 120, 0,
+  47, 0, 0, 0, 0, 177, 0, 0, 167, 4, 41, 0,
+  0, 107, 140, 0, 156, 0, 0, 0, 171, 161, 0, 0,
+  0, 74, 0, 0, 143, 0, 0, 138, 0, 0, 0, 43,
+  0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 174, 0,
+  0, 33, 71, 187, 0, 88, 182, 0, 0, 0, 0, 0,
+  0, 56, 93, 172, 0, 0, 129, 0, 0, 158, 0, 0,
+  0, 0, 0, 0, 64, 109, 0, 0, 0, 0, 0, 179,
+  90, 28, 181, 0, 0, 183, 79, 0, 10, 0, 0, 188,
+  0, 126, 170, 0, 0, 69, 94, 12, 124, 0, 0, 0,
+  157, 50, 0, 0, 166, 150, 0, 0, 0, 0, 173, 0,
+  0, 0, 0, 130, 0, 26, 0, 0, 0, 0, 176, 39,
+  0, 0, 0, 0, 0, 0, 0, 0, 24, 51, 0, 0,
+  0, 0, 114, 0, 55, 0, 0, 0, 0, 65, 0, 142,
+  0, 0, 0, 0, 0, 185, 0, 0, 153, 0, 135, 0,
+  104, 7, 125, 21, 6, 92, 151, 9, 0, 0, 0, 0,
+  0, 54, 0, 0, 0, 165, 0, 25, 0, 0, 180, 0,
+  13, 122, 149, 186, 53, 70, 116, 145, 101, 0, 0, 0,
+  0, 0, 0, 36, 0, 0, 0, 0, 0, 0, 35, 78,
+  76, 146, 0, 154, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 85, 0, 5, 178, 0, 0,
+  0, 0, 0, 0, 0, 0, 141, 0, 0, 0, 77, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 66, 83, 0, 0,
+  0, 0, 0, 0, 0, 0, 3, 16, 119, 0, 0, 38,
+  0, 0, 189, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 175, 0, 0, 59, 20, 61, 89, 0,
+  0, 0, 31, 131, 73, 103, 113, 0, 0, 19, 0, 97,
+  0, 0, 0, 0, 155, 0, 162, 0, 62, 0, 0, 0,
+  99, 0, 0, 106, 0, 0, 0, 0, 15, 132, 0, 44,
+  0, 0, 11, 127, 148, 159, 81, 102,
+};
+#endif
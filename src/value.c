@@ -27,6 +27,7 @@
 #include "c_range.h"
 #include "c_array.h"
 #include "c_hash.h"
+#include "gc.h"
 
 
 
@@ -34,7 +35,7 @@ mrb_object *mrbc_obj_alloc(struct VM *vm, mrb_vtype tt)
 {
   mrb_object *ptr = (mrb_object *)mrbc_alloc(vm, sizeof(mrb_object));
   if( ptr ){
-    ptr->tt = tt;
+    mrbc_set_tt(ptr, tt);
   }
   return ptr;
 }
@@ -45,7 +46,9 @@ mrb_proc *mrbc_rproc_alloc(struct VM *vm, const char *name)
   mrb_proc *ptr = (mrb_proc *)mrbc_alloc(vm, sizeof(mrb_proc));
   if( ptr ) {
     ptr->ref_count = 1;
+    ptr->gc_flag = 0;
     ptr->sym_id = str_to_symid(name);
+    ptr->ivar_sym_id = 0;
 #ifdef MRBC_DEBUG
     ptr->names = name;	// for debug; delete soon.
 #endif
@@ -67,34 +70,36 @@ mrb_proc *mrbc_rproc_alloc(struct VM *vm, const char *name)
 */
 int mrbc_compare(const mrb_value *v1, const mrb_value *v2)
 {
-  double d1, d2;
+#if MRBC_USE_FLOAT
+  mrbc_float_t d1, d2;
+#endif
 
   // if TT_XXX is different
-  if( v1->tt != v2->tt ) {
+  if( mrbc_type(*v1) != mrbc_type(*v2) ) {
 #if MRBC_USE_FLOAT
     // but Numeric?
-    if( v1->tt == MRB_TT_FIXNUM && v2->tt == MRB_TT_FLOAT ) {
-      d1 = v1->i;
-      d2 = v2->d;
+    if( mrbc_type(*v1) == MRB_TT_FIXNUM && mrbc_type(*v2) == MRB_TT_FLOAT ) {
+      d1 = mrbc_integer(*v1);
+      d2 = mrbc_float(*v2);
       goto CMP_FLOAT;
     }
-    if( v1->tt == MRB_TT_FLOAT && v2->tt == MRB_TT_FIXNUM ) {
-      d1 = v1->d;
-      d2 = v2->i;
+    if( mrbc_type(*v1) == MRB_TT_FLOAT && mrbc_type(*v2) == MRB_TT_FIXNUM ) {
+      d1 = mrbc_float(*v1);
+      d2 = mrbc_integer(*v2);
       goto CMP_FLOAT;
     }
 #endif
 
     // leak Empty?
-    if((v1->tt == MRB_TT_EMPTY && v2->tt == MRB_TT_NIL) ||
-       (v1->tt == MRB_TT_NIL   && v2->tt == MRB_TT_EMPTY)) return 0;
+    if((mrbc_type(*v1) == MRB_TT_EMPTY && mrbc_type(*v2) == MRB_TT_NIL) ||
+       (mrbc_type(*v1) == MRB_TT_NIL   && mrbc_type(*v2) == MRB_TT_EMPTY)) return 0;
 
     // other case
-    return v1->tt - v2->tt;
+    return mrbc_type(*v1) - mrbc_type(*v2);
   }
 
   // check value
-  switch( v1->tt ) {
+  switch( mrbc_type(*v1) ) {
   case MRB_TT_NIL:
   case MRB_TT_FALSE:
   case MRB_TT_TRUE:
@@ -102,12 +107,12 @@ int mrbc_compare(const mrb_value *v1, const mrb_value *v2)
 
   case MRB_TT_FIXNUM:
   case MRB_TT_SYMBOL:
-    return v1->i - v2->i;
+    return mrbc_integer(*v1) - mrbc_integer(*v2);
 
 #if MRBC_USE_FLOAT
   case MRB_TT_FLOAT:
-    d1 = v1->d;
-    d2 = v2->d;
+    d1 = mrbc_float(*v1);
+    d2 = mrbc_float(*v2);
     goto CMP_FLOAT;
 #endif
 
@@ -149,7 +154,7 @@ int mrbc_compare(const mrb_value *v1, const mrb_value *v2)
 */
 void mrbc_dup(mrb_value *v)
 {
-  switch( v->tt ){
+  switch( mrbc_type(*v) ){
   case MRB_TT_OBJECT:
   case MRB_TT_PROC:
   case MRB_TT_ARRAY:
@@ -177,7 +182,48 @@ void mrbc_dup(mrb_value *v)
 void mrbc_release(mrb_value *v)
 {
   mrbc_dec_ref_counter(v);
-  v->tt = MRB_TT_EMPTY;
+  mrbc_set_tt(v, MRB_TT_EMPTY);
+}
+
+
+//================================================================
+/*!@brief
+  Release a temporary value.
+
+  Same as mrbc_release(), but the object is not registered as a
+  candidate of the cycle collector. Use this for the temporary
+  registers, which mostly hold a copy of a value held elsewhere,
+  and would fill the candidate buffer.
+  An object found live by the collector is registered again, since
+  a copy left in a temporary register may have kept it.
+
+  @param   v     Pointer to target mrb_value
+*/
+void mrbc_release_temp(mrb_value *v)
+{
+#if MRBC_GC_CANDIDATES > 0
+  switch( mrbc_type(*v) ){
+  case MRB_TT_OBJECT:
+  case MRB_TT_PROC:
+  case MRB_TT_ARRAY:
+  case MRB_TT_STRING:
+  case MRB_TT_RANGE:
+  case MRB_TT_HASH:
+    if( v->instance->ref_count > 1 ) {
+      v->instance->ref_count--;
+      // it was live only by this copy?
+      if( v->instance->gc_flag & MRBC_GC_SURVIVED ) mrbc_gc_add_candidate(v);
+      break;
+    }
+    // fall through
+  default:
+    mrbc_dec_ref_counter(v);
+    break;
+  }
+  mrbc_set_tt(v, MRB_TT_EMPTY);
+#else
+  mrbc_release(v);
+#endif
 }
 
 
@@ -189,7 +235,7 @@ void mrbc_release(mrb_value *v)
 */
 void mrbc_dec_ref_counter(mrb_value *v)
 {
-  switch( v->tt ){
+  switch( mrbc_type(*v) ){
   case MRB_TT_OBJECT:
   case MRB_TT_PROC:
   case MRB_TT_ARRAY:
@@ -206,9 +252,22 @@ void mrbc_dec_ref_counter(mrb_value *v)
   }
 
   // release memory?
-  if( v->instance->ref_count != 0 ) return;
+  if( v->instance->ref_count != 0 ) {
+#if MRBC_GC_CANDIDATES > 0
+    // the rest of the references may be a cycle.
+    mrbc_gc_add_candidate(v);
+#endif
+    return;
+  }
+
+#if MRBC_GC_CANDIDATES > 0
+  if( v->instance->gc_flag & MRBC_GC_BUFFERED ) mrbc_gc_remove_candidate(v);
+#endif
+#if MRBC_FREE_QUEUE_SIZE > 0
+  if( mrbc_deferred_free(v) == 0 ) return;
+#endif
 
-  switch( v->tt ) {
+  switch( mrbc_type(*v) ) {
   case MRB_TT_OBJECT:	mrbc_instance_delete(v);	break;
   case MRB_TT_PROC:	mrbc_raw_free(v->handle);	break;
   case MRB_TT_ARRAY:	mrbc_array_delete(v);		break;
@@ -233,7 +292,7 @@ void mrbc_dec_ref_counter(mrb_value *v)
 */
 void mrbc_clear_vm_id(mrb_value *v)
 {
-  switch( v->tt ) {
+  switch( mrbc_type(*v) ) {
   case MRB_TT_ARRAY:	mrbc_array_clear_vm_id(v);	break;
 #if MRBC_USE_STRING
   case MRB_TT_STRING:	mrbc_string_clear_vm_id(v);	break;
@@ -333,6 +392,19 @@ void mrbc_irep_free(mrb_irep *irep)
   }
   if( irep->plen ) mrbc_raw_free( irep->pools );
 
+  // release symbol IDs table.
+  if( irep->slen ) mrbc_raw_free( irep->syms );
+
+#if MRBC_USE_CONST_CACHE
+  // release constant caches.
+  if( irep->const_cache ) mrbc_raw_free( irep->const_cache );
+#endif
+
+#if MRBC_USE_DECODED_ISEQ
+  // release pre-decoded instructions.
+  if( irep->ilen ) mrbc_raw_free( irep->code );
+#endif
+
   // release child ireps.
   for( i = 0; i < irep->rlen; i++ ) {
     mrbc_irep_free( irep->reps[i] );
@@ -343,9 +415,45 @@ void mrbc_irep_free(mrb_irep *irep)
 }
 
 
+//================================================================
+/*! get the ivar slot number from class shape
+
+  Instances of the same class share the shape, that maps ivar symbols
+  to slot numbers. The shape only grows, so slot numbers never change.
+
+  @param  cls		pointer to class.
+  @param  sym_id	ivar symbol ID.
+  @param  flag_add	add to shape if not found.
+  @return		slot number or -1.
+*/
+int mrbc_class_ivar_slot(mrb_class *cls, mrb_sym sym_id, int flag_add)
+{
+  int i;
+  for( i = 0; i < cls->n_ivar; i++ ) {
+    if( cls->ivar_syms[i] == sym_id ) return i;
+  }
+  if( !flag_add || cls->n_ivar >= MRBC_MAX_IVAR_SLOTS ) return -1;
+
+  // extend the shape. allocate by 4 slots.
+  if( (cls->n_ivar & 0x03) == 0 ) {
+    unsigned int size = sizeof(mrb_sym) * (cls->n_ivar + 4);
+    mrb_sym *syms = cls->ivar_syms ? mrbc_raw_realloc(cls->ivar_syms, size) :
+				     mrbc_raw_alloc(size);
+    if( !syms ) return -1;	// ENOMEM
+    cls->ivar_syms = syms;
+  }
+  cls->ivar_syms[cls->n_ivar] = sym_id;
+
+  return cls->n_ivar++;
+}
+
+
 //================================================================
 /*! mrb_instance constructor
 
+  Ivar slots for the current class shape are allocated together,
+  after the additional data.
+
   @param  vm    Pointer to VM.
   @param  cls	Pointer to Class (mrb_class).
   @param  size	size of additional data.
@@ -353,20 +461,25 @@ void mrbc_irep_free(mrb_irep *irep)
 */
 mrb_value mrbc_instance_new(struct VM *vm, mrb_class *cls, int size)
 {
-  mrb_value v = {.tt = MRB_TT_OBJECT};
-  v.instance = (mrb_instance *)mrbc_alloc(vm, sizeof(mrb_instance) + size);
-  if( v.instance == NULL ) return v;	// ENOMEM
+  mrb_value v = MRBC_VALUE_INIT(MRB_TT_OBJECT);
+  int ivar_ofs = (sizeof(mrb_instance) + size + 7) & ~7;
+  int n_ivar = cls->n_ivar;
 
-  v.instance->ivar = mrbc_kv_new(vm, 0);
-  if( v.instance->ivar == NULL ) {	// ENOMEM
-    mrbc_raw_free(v.instance);
-    v.instance = NULL;
-    return v;
-  }
+  v.instance = (mrb_instance *)mrbc_alloc(vm, ivar_ofs + sizeof(mrb_value) * n_ivar);
+  if( v.instance == NULL ) return v;	// ENOMEM
 
   v.instance->ref_count = 1;
   v.instance->tt = MRB_TT_OBJECT;	// for debug only.
+  v.instance->gc_flag = 0;
+  v.instance->n_ivar = n_ivar;
+  v.instance->flag_ivar_ext = 0;
   v.instance->cls = cls;
+  v.instance->ivar = (mrb_value *)((uint8_t *)v.instance + ivar_ofs);
+
+  int i;
+  for( i = 0; i < n_ivar; i++ ) {
+    mrbc_set_nil(&v.instance->ivar[i]);
+  }
 
   return v;
 }
@@ -380,8 +493,56 @@ mrb_value mrbc_instance_new(struct VM *vm, mrb_class *cls, int size)
 */
 void mrbc_instance_delete(mrb_value *v)
 {
-  mrbc_kv_delete( v->instance->ivar );
-  mrbc_raw_free( v->instance );
+  mrb_instance *instance = v->instance;
+  int i;
+
+  for( i = 0; i < instance->n_ivar; i++ ) {
+    mrbc_release( &instance->ivar[i] );
+  }
+  if( instance->flag_ivar_ext ) mrbc_raw_free( instance->ivar );
+  mrbc_raw_free( instance );
+}
+
+
+//================================================================
+/*! instance variable setter (by slot number)
+
+  @param  obj		pointer to target.
+  @param  slot		slot number. see mrbc_class_ivar_slot()
+  @param  v		pointer to value.
+*/
+void mrbc_instance_setiv_slot(mrb_object *obj, int slot, mrb_value *v)
+{
+  mrb_instance *instance = obj->instance;
+
+  // the shape has grown after this object was made.
+  // grow geometrically, since the shape grows one by one while the
+  // first instance of the class is initialized.
+  if( slot >= instance->n_ivar ) {
+    int n = mrbc_grow_size( instance->n_ivar );
+    if( n < instance->cls->n_ivar ) n = instance->cls->n_ivar;
+    if( n > MRBC_MAX_IVAR_SLOTS ) n = MRBC_MAX_IVAR_SLOTS;
+    mrb_value *ivar = mrbc_alloc_by_vm_id( mrbc_get_vm_id(instance),
+					   sizeof(mrb_value) * n );
+    if( !ivar ) return;		// ENOMEM
+
+    int i;
+    for( i = 0; i < instance->n_ivar; i++ ) {
+      ivar[i] = instance->ivar[i];
+    }
+    for( ; i < n; i++ ) {
+      mrbc_set_nil(&ivar[i]);
+    }
+    if( instance->flag_ivar_ext ) mrbc_raw_free( instance->ivar );
+
+    instance->ivar = ivar;
+    instance->n_ivar = n;
+    instance->flag_ivar_ext = 1;
+  }
+
+  mrbc_dup(v);
+  mrbc_release( &instance->ivar[slot] );
+  instance->ivar[slot] = *v;
 }
 
 
@@ -394,8 +555,10 @@ void mrbc_instance_delete(mrb_value *v)
 */
 void mrbc_instance_setiv(mrb_object *obj, mrb_sym sym_id, mrb_value *v)
 {
-  mrbc_dup(v);
-  mrbc_kv_set( obj->instance->ivar, sym_id, v );
+  int slot = mrbc_class_ivar_slot( obj->instance->cls, sym_id, 1 );
+  if( slot < 0 ) return;	// ENOMEM or too many ivars.
+
+  mrbc_instance_setiv_slot( obj, slot, v );
 }
 
 
@@ -408,9 +571,10 @@ void mrbc_instance_setiv(mrb_object *obj, mrb_sym sym_id, mrb_value *v)
 */
 mrb_value mrbc_instance_getiv(mrb_object *obj, mrb_sym sym_id)
 {
-  mrb_value *v = mrbc_kv_get( obj->instance->ivar, sym_id );
-  if( !v ) return mrb_nil_value();
+  int slot = mrbc_class_ivar_slot( obj->instance->cls, sym_id, 0 );
+  if( slot < 0 || slot >= obj->instance->n_ivar ) return mrb_nil_value();
 
+  mrb_value *v = &obj->instance->ivar[slot];
   mrbc_dup(v);
   return *v;
 }
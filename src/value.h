@@ -35,7 +35,8 @@ typedef int16_t mrb_sym;
 
 #define MRBC_OBJECT_HEADER \
   uint16_t ref_count; \
-  mrb_vtype tt : 8  // TODO: for debug use only.
+  mrb_vtype tt : 8; /* TODO: for debug use only. */ \
+  uint8_t gc_flag   // see gc.h
 
 
 struct VM;
@@ -97,6 +98,81 @@ typedef enum {
 
 
 
+#if MRBC_USE_FLOAT
+#if MRBC_FLOAT_TYPE == MRBC_FLOAT_SINGLE
+typedef float mrbc_float_t;
+#define MRBC_MATH(func)		func##f		// e.g. sin -> sinf
+#define mrbc_atof(s)		strtof((s), NULL)
+#else
+typedef double mrbc_float_t;
+#define MRBC_MATH(func)		func
+#define mrbc_atof(s)		atof(s)
+#endif
+#endif
+
+// NaN-boxing is used only if Float is double.
+#define MRBC_NAN_BOXING (MRBC_USE_COMPACT_VALUE && MRBC_USE_FLOAT && \
+			 MRBC_FLOAT_TYPE == MRBC_FLOAT_DOUBLE)
+
+
+#if MRBC_USE_COMPACT_VALUE
+//================================================================
+/*!@brief
+  mruby/c value object. (compact, 8 bytes)
+
+  The upper word is MRBC_BOX_MARK | type, and the lower word is
+  the payload (Fixnum, Symbol, single Float or pointer).
+  A double Float is stored as is; other types are in its NaN space.
+  The mark is a negative quiet NaN, so that it doesn't match
+  -Infinity (0xfff00000_00000000). Real NaNs are stored as the
+  positive quiet NaN. (see mrbc_set_float_)
+  Access tt, i and d through the accessor macros below.
+*/
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__ || \
+    !defined(__SIZEOF_POINTER__) || __SIZEOF_POINTER__ != 4
+#error "MRBC_USE_COMPACT_VALUE needs little endian CPU with 32-bit pointer."
+#endif
+
+#define MRBC_BOX_MARK	0xfff80000
+
+typedef struct RObject {
+  union {
+    struct {
+      union {
+	int32_t i;			// MRB_TT_FIXNUM, SYMBOL
+#if MRBC_USE_FLOAT && !MRBC_NAN_BOXING
+	mrbc_float_t d;			// MRB_TT_FLOAT
+#endif
+	struct RClass *cls;		// MRB_TT_CLASS
+	struct RObject *handle;	// handle to objects
+	struct RInstance *instance;	// MRB_TT_OBJECT
+	struct RProc *proc;		// MRB_TT_PROC
+	struct RArray *array;		// MRB_TT_ARRAY
+	struct RString *string;	// MRB_TT_STRING
+	const char *str;		// C-string (only loader use.)
+	struct RRange *range;		// MRB_TT_RANGE
+	struct RHash *hash;		// MRB_TT_HASH
+      };
+      uint32_t tag;			// MRBC_BOX_MARK | tt
+    };
+#if MRBC_NAN_BOXING
+    double d;				// MRB_TT_FLOAT
+#endif
+  };
+} mrb_object;
+
+#define MRBC_VALUE_INIT(t)	{ .tag = MRBC_BOX_MARK | (uint8_t)(t) }
+#define mrbc_set_tt(p,t)	((p)->tag = MRBC_BOX_MARK | (uint8_t)(t))
+#if MRBC_NAN_BOXING
+#define mrbc_type(o)		(((o).tag & MRBC_BOX_MARK) == MRBC_BOX_MARK ? \
+				 (mrb_vtype)(int8_t)(o).tag : MRB_TT_FLOAT)
+#define mrbc_set_float(p,n)	mrbc_set_float_((p),(n))
+#else
+#define mrbc_type(o)		((mrb_vtype)(int8_t)(o).tag)
+#define mrbc_set_float(p,n)	(mrbc_set_tt((p), MRB_TT_FLOAT), (p)->d = (n))
+#endif
+
+#else
 //================================================================
 /*!@brief
   mruby/c value object.
@@ -106,7 +182,7 @@ typedef struct RObject {
   union {
     int32_t i;			// MRB_TT_FIXNUM, SYMBOL
 #if MRBC_USE_FLOAT
-    double d;			// MRB_TT_FLOAT
+    mrbc_float_t d;		// MRB_TT_FLOAT
 #endif
     struct RClass *cls;		// MRB_TT_CLASS
     struct RObject *handle;	// handle to objects
@@ -119,8 +195,46 @@ typedef struct RObject {
     struct RHash *hash;		// MRB_TT_HASH
   };
 } mrb_object;
+
+#define MRBC_VALUE_INIT(t)	{ .tt = (t) }
+#define mrbc_type(o)		((o).tt)
+#define mrbc_set_tt(p,t)	((p)->tt = (t))
+#define mrbc_set_float(p,n)	((p)->tt = MRB_TT_FLOAT, (p)->d = (n))
+#endif
 typedef struct RObject mrb_value;
 
+// accessors. (use these instead of the members tt, i and d)
+#define mrbc_integer(o)		((o).i)
+#define mrbc_symbol(o)		((o).i)
+#define mrbc_float(o)		((o).d)
+#define mrbc_set_integer(p,n)	(mrbc_set_tt((p), MRB_TT_FIXNUM), (p)->i = (n))
+#define mrbc_set_symbol(p,n)	(mrbc_set_tt((p), MRB_TT_SYMBOL), (p)->i = (n))
+#define mrbc_set_nil(p)		mrbc_set_tt((p), MRB_TT_NIL)
+#define mrbc_set_true(p)	mrbc_set_tt((p), MRB_TT_TRUE)
+#define mrbc_set_false(p)	mrbc_set_tt((p), MRB_TT_FALSE)
+#define mrbc_set_bool(p,n)	mrbc_set_tt((p), (n) ? MRB_TT_TRUE : MRB_TT_FALSE)
+
+#if MRBC_NAN_BOXING
+//================================================================
+/*!@brief
+  set a float value. (compact value version)
+
+  NaN is stored as the positive quiet NaN, not to be taken as
+  a boxed value.
+
+  @param  p	pointer to the value.
+  @param  n	double value.
+*/
+static inline void mrbc_set_float_( mrb_value *p, double n )
+{
+  p->d = n;
+  if( (p->tag & MRBC_BOX_MARK) == MRBC_BOX_MARK ) {
+    p->tag = 0x7ff80000;
+    p->i = 0;
+  }
+}
+#endif
+
 
 //================================================================
 /*!@brief
@@ -133,6 +247,8 @@ typedef struct RClass {
 #endif
   struct RClass *super;	// mrbc_class[super]
   struct RProc *procs;	// mrbc_proc[rprocs], linked list
+  uint8_t n_ivar;	// number of instance variables (shape)
+  mrb_sym *ivar_syms;	// instance variable names. index is slot number.
 } mrb_class;
 
 
@@ -142,12 +258,16 @@ typedef struct RClass {
 */
 typedef struct RInstance {
   MRBC_OBJECT_HEADER;
+  uint8_t n_ivar : 7;		// number of ivar slots.
+  uint8_t flag_ivar_ext : 1;	// ivar slots are allocated separately.
 
   struct RClass *cls;
-  struct RKeyValueHandle *ivar;
+  struct RObject *ivar;		// ivar slots, indexed by class shape.
   uint8_t data[];
 } mrb_instance;
 
+#define MRBC_MAX_IVAR_SLOTS 127
+
 
 //================================================================
 /*!@brief
@@ -158,6 +278,7 @@ typedef struct RProc {
 
   unsigned int c_func : 1;	// 0:IREP, 1:C Func
   mrb_sym sym_id;
+  mrb_sym ivar_sym_id;		// "@name" for attr_reader/accessor.
 #ifdef MRBC_DEBUG
   const char *names;		// for debug; delete soon
 #endif
@@ -170,19 +291,19 @@ typedef struct RProc {
 
 
 
-// for C call
-#define SET_INT_RETURN(n)	(mrbc_release(v), v[0].tt=MRB_TT_FIXNUM, v[0].i=(n))
-#define SET_NIL_RETURN()	(mrbc_release(v), v[0].tt=MRB_TT_NIL)
-#define SET_FLOAT_RETURN(n)	(mrbc_release(v), v[0].tt=MRB_TT_FLOAT, v[0].d=(n))
-#define SET_FALSE_RETURN()	(mrbc_release(v), v[0].tt=MRB_TT_FALSE)
-#define SET_TRUE_RETURN()	(mrbc_release(v), v[0].tt=MRB_TT_TRUE)
-#define SET_RETURN(n)		(mrbc_release(v), v[0]=(n))
+// for C call. (v[0] is a temporary register of the caller)
+#define SET_INT_RETURN(n)	(mrbc_release_temp(v), mrbc_set_integer(v, (n)))
+#define SET_NIL_RETURN()	(mrbc_release_temp(v), mrbc_set_nil(v))
+#define SET_FLOAT_RETURN(n)	(mrbc_release_temp(v), mrbc_set_float(v, (n)))
+#define SET_FALSE_RETURN()	(mrbc_release_temp(v), mrbc_set_false(v))
+#define SET_TRUE_RETURN()	(mrbc_release_temp(v), mrbc_set_true(v))
+#define SET_RETURN(n)		(mrbc_release_temp(v), v[0]=(n))
 
-#define GET_TT_ARG(n)		(v[(n)].tt)
-#define GET_INT_ARG(n)		(v[(n)].i)
+#define GET_TT_ARG(n)		mrbc_type(v[(n)])
+#define GET_INT_ARG(n)		mrbc_integer(v[(n)])
 #define GET_ARY_ARG(n)		(v[(n)])
 #define GET_ARG(n)		(v[(n)])
-#define GET_FLOAT_ARG(n)	(v[(n)].d)
+#define GET_FLOAT_ARG(n)	mrbc_float(v[(n)])
 #define GET_STRING_ARG(n)	(v[(n)].string->data)
 
 
@@ -192,6 +313,7 @@ mrb_proc *mrbc_rproc_alloc(struct VM *vm, const char *name);
 int mrbc_compare(const mrb_value *v1, const mrb_value *v2);
 void mrbc_dup(mrb_value *v);
 void mrbc_release(mrb_value *v);
+void mrbc_release_temp(mrb_value *v);
 void mrbc_dec_ref_counter(mrb_value *v);
 void mrbc_clear_vm_id(mrb_value *v);
 int32_t mrbc_atoi(const char *s, int base);
@@ -201,6 +323,8 @@ mrb_value mrbc_instance_new(struct VM *vm, mrb_class *cls, int size);
 void mrbc_instance_delete(mrb_value *v);
 void mrbc_instance_setiv(mrb_object *obj, mrb_sym sym_id, mrb_value *v);
 mrb_value mrbc_instance_getiv(mrb_object *obj, mrb_sym sym_id);
+int mrbc_class_ivar_slot(mrb_class *cls, mrb_sym sym_id, int flag_add);
+void mrbc_instance_setiv_slot(mrb_object *obj, int slot, mrb_value *v);
 
 
 
@@ -213,8 +337,8 @@ mrb_value mrbc_instance_getiv(mrb_object *obj, mrb_sym sym_id);
 */
 static inline mrb_value mrb_fixnum_value( int32_t n )
 {
-  mrb_value value = {.tt = MRB_TT_FIXNUM};
-  value.i = n;
+  mrb_value value;
+  mrbc_set_integer(&value, n);
   return value;
 }
 
@@ -227,10 +351,10 @@ static inline mrb_value mrb_fixnum_value( int32_t n )
   @param  n	dluble value
   @return	mrb_value of type float.
 */
-static inline mrb_value mrb_float_value( double n )
+static inline mrb_value mrb_float_value( mrbc_float_t n )
 {
-  mrb_value value = {.tt = MRB_TT_FLOAT};
-  value.d = n;
+  mrb_value value;
+  mrbc_set_float(&value, n);
   return value;
 }
 #endif
@@ -244,7 +368,7 @@ static inline mrb_value mrb_float_value( double n )
 */
 static inline mrb_value mrb_nil_value(void)
 {
-  mrb_value value = {.tt = MRB_TT_NIL};
+  mrb_value value = MRBC_VALUE_INIT(MRB_TT_NIL);
   return value;
 }
 
@@ -257,7 +381,7 @@ static inline mrb_value mrb_nil_value(void)
 */
 static inline mrb_value mrb_true_value(void)
 {
-  mrb_value value = {.tt = MRB_TT_TRUE};
+  mrb_value value = MRBC_VALUE_INIT(MRB_TT_TRUE);
   return value;
 }
 
@@ -270,11 +394,30 @@ static inline mrb_value mrb_true_value(void)
 */
 static inline mrb_value mrb_false_value(void)
 {
-  mrb_value value = {.tt = MRB_TT_FALSE};
+  mrb_value value = MRBC_VALUE_INIT(MRB_TT_FALSE);
   return value;
 }
 
 
+//================================================================
+/*!@brief
+  Returns the next size of a growing container buffer.
+
+  The size is limited to 0xffff (uint16_t) unless already there,
+  in which case the resize function fails.
+
+  @param  size	current size.
+  @return	new size.
+*/
+static inline int mrbc_grow_size(int size)
+{
+  int size2 = size * MRBC_GROWTH_RATE / 100;
+  if( size2 < size + MRBC_GROWTH_MIN ) size2 = size + MRBC_GROWTH_MIN;
+  if( size2 > 0xffff && size < 0xffff ) size2 = 0xffff;
+  return size2;
+}
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,6 +31,7 @@
 #include "c_range.h"
 #include "c_array.h"
 #include "c_hash.h"
+#include "gc.h"
 
 
 static uint32_t free_vm_bitmap[MAX_VM_COUNT / 32 + 1];
@@ -57,6 +58,50 @@ static inline int nlz32(uint32_t x)
 }
 
 
+#if MRBC_PROFILE_OPCODE_PAIRS
+static void count_opcode_pair( int opcode );
+#define PROFILE_OPCODE(op)	count_opcode_pair(op)
+#else
+#define PROFILE_OPCODE(op)	((void)0)
+#endif
+
+//================================================================
+/*!@brief
+  Release a register.
+
+  The temporary registers after the local variables are released
+  without registering a candidate of the cycle collector.
+
+  @param  vm	Pointer to VM
+  @param  regs	vm->current_regs
+  @param  n	register number.
+*/
+static inline void release_register(mrb_vm *vm, mrb_value *regs, int n)
+{
+  if( n < vm->pc_irep->nlocals ) {
+    mrbc_release(&regs[n]);
+  } else {
+    mrbc_release_temp(&regs[n]);
+  }
+}
+
+
+#if MRBC_PROFILE_CONST_CACHE
+static uint32_t const_cache_hit, const_cache_miss;
+#define PROFILE_CONST_CACHE(n)	((n)++)
+#else
+#define PROFILE_CONST_CACHE(n)	((void)0)
+#endif
+
+#if MRBC_USE_DECODED_ISEQ
+#define CODE_SIZE		((int)sizeof(mrbc_insn))
+#define FETCH_CODE(p)		((mrbc_code_t)(p))
+#else
+#define CODE_SIZE		4
+#define FETCH_CODE(p)		bin_to_uint32(p)
+#endif
+
+
 //================================================================
 /*! get sym[n] from symbol table in irep
 
@@ -86,9 +131,21 @@ const char * mrbc_get_irep_symbol( const uint8_t *p, int n )
 */
 const char *mrbc_get_callee_name( mrb_vm *vm )
 {
-  uint32_t code = bin_to_uint32(vm->pc_irep->code + (vm->pc - 1) * 4);
+  return symid_to_str(mrbc_get_callee_symid(vm));
+}
+
+
+//================================================================
+/*! get callee symbol ID
+
+  @param  vm	Pointer to VM
+  @return	symbol ID
+*/
+mrb_sym mrbc_get_callee_symid( mrb_vm *vm )
+{
+  mrbc_code_t code = FETCH_CODE(vm->pc_irep->code + (vm->pc - 1) * CODE_SIZE);
   int rb = GETARG_B(code);  // index of method sym
-  return mrbc_get_irep_symbol(vm->pc_irep->ptr_to_sym, rb);
+  return vm->pc_irep->syms[rb];
 }
 
 
@@ -103,20 +160,65 @@ static void not_supported(void)
 
 
 
+//================================================================
+/*!@brief
+  Extend callinfo stack
+
+  The stack is allocated at the first call, and grows on demand.
+
+  @param  vm	Pointer to VM
+  @param  n	num of callinfo to be pushed.
+  @retval 0	No error.
+  @retval -1	Stack overflow or not enough memory.
+*/
+static int extend_callinfo(mrb_vm *vm, int n)
+{
+  int size = vm->callinfo_size ? vm->callinfo_size * 2 : MRBC_CALLINFO_INIT_SIZE;
+  if( size < vm->callinfo_top + n ) size = vm->callinfo_top + n;
+  if( size > MAX_CALLINFO_SIZE ) size = MAX_CALLINFO_SIZE;
+  if( size < vm->callinfo_top + n ) goto STACK_OVERFLOW;
+
+  mrb_callinfo *callinfo = vm->callinfo ?
+    mrbc_realloc(vm, vm->callinfo, sizeof(mrb_callinfo) * size) :
+    mrbc_alloc(vm, sizeof(mrb_callinfo) * size);
+  if( callinfo == NULL ) goto STACK_OVERFLOW;
+
+  vm->callinfo = callinfo;
+  vm->callinfo_size = size;
+  return 0;
+
+ STACK_OVERFLOW:
+  console_printf("Error: callinfo stack overflow.\n");
+  vm->error_code = E_RUNTIME_ERROR;
+  vm->flag_preemption = 1;
+  return -1;
+}
+
+
+
 //================================================================
 /*!@brief
   Push current status to callinfo stack
 
+  @param  vm	Pointer to VM
+  @param  n_args num of args
+  @retval 0	No error.
+  @retval -1	Stack overflow or not enough memory.
 */
-void mrbc_push_callinfo(mrb_vm *vm, int n_args)
+int mrbc_push_callinfo(mrb_vm *vm, int n_args)
 {
+  if( vm->callinfo_top >= vm->callinfo_size &&
+      extend_callinfo(vm, 1) != 0 ) return -1;
+
   mrb_callinfo *callinfo = vm->callinfo + vm->callinfo_top;
   callinfo->current_regs = vm->current_regs;
   callinfo->pc_irep = vm->pc_irep;
   callinfo->pc = vm->pc;
   callinfo->n_args = n_args;
+  callinfo->flag_yield = 0;
   callinfo->target_class = vm->target_class;
   vm->callinfo_top++;
+  return 0;
 }
 
 
@@ -138,6 +240,185 @@ void mrbc_pop_callinfo(mrb_vm *vm)
 
 
 
+//================================================================
+/*!@brief
+  Make sure that n registers from current_regs are available.
+
+  The register stack grows on demand, and it may be moved.
+  (caution) Pointers to the registers held by the caller are
+  invalid after this. vm->current_regs and callinfo are rebased.
+
+  @param  vm	Pointer to VM
+  @param  n	num of registers needed.
+  @retval 0	No error.
+  @retval -1	Stack overflow or not enough memory.
+*/
+int mrbc_extend_regs(mrb_vm *vm, int n)
+{
+  int need = vm->current_regs - vm->regs + n;
+  if( need <= vm->regs_size ) return 0;
+  if( need > MAX_REGS_SIZE ) goto STACK_OVERFLOW;
+
+  int size = vm->regs_size * 2;
+  if( size < need ) size = need;
+  if( size > MAX_REGS_SIZE ) size = MAX_REGS_SIZE;
+
+  mrb_value *old_regs = vm->regs;
+  mrb_value *regs = mrbc_realloc(vm, old_regs, sizeof(mrb_value) * size);
+  if( regs == NULL ) goto STACK_OVERFLOW;
+
+  int i;
+  for( i = vm->regs_size; i < size; i++ ) {
+    mrbc_set_tt(&regs[i], MRB_TT_EMPTY);
+  }
+
+  // rebase pointers to the registers.
+  if( regs != old_regs ) {
+    vm->current_regs = regs + (vm->current_regs - old_regs);
+    for( i = 0; i < vm->callinfo_top; i++ ) {
+      mrb_callinfo *callinfo = vm->callinfo + i;
+      callinfo->current_regs = regs + (callinfo->current_regs - old_regs);
+    }
+    vm->regs = regs;
+  }
+  vm->regs_size = size;
+  return 0;
+
+ STACK_OVERFLOW:
+  console_printf("Error: register stack overflow.\n");
+  vm->error_code = E_RUNTIME_ERROR;
+  vm->flag_preemption = 1;
+  return -1;
+}
+
+
+
+//================================================================
+/*!@brief
+  Call a block from a C method.
+
+  The block is not executed here. It is executed by the VM after
+  the C method returns, without re-entering mrbc_vm_run().
+  When the block returns, the method call instruction is executed
+  again with vm->flag_resume = 1, so the C method is called again
+  with the same registers and can continue its iteration.
+  If the C method returns without mrbc_yield(), the call finishes.
+
+  Registers (block[0] is the block parameter of the C method):
+    block[1]	free. the C method can keep its state here.
+    block[2]	work for the block call. the return value of
+		the block is stored here.
+  op_send() makes sure that these registers exist before it calls
+  the C method, so the C method can write block[1] before this.
+
+  (caution) argv must not point to the registers, because the
+  register stack may be moved.
+
+  @param  vm	Pointer to VM
+  @param  block	block parameter (Proc) of the C method.
+  @param  argv	arguments to the block.
+  @param  argc	num of arguments.
+  @retval 0	No error.
+  @retval -1	Not a Proc, stack overflow or not enough memory.
+*/
+int mrbc_yield(mrb_vm *vm, mrb_value *block, mrb_value *argv, int argc)
+{
+  if( mrbc_type(*block) != MRB_TT_PROC ) return -1;
+
+  mrb_irep *irep = block->proc->irep;
+  if( block + 2 + irep->nregs > vm->regs + vm->regs_size ) {
+    int ofs = block - vm->current_regs;
+    if( mrbc_extend_regs(vm, ofs + 2 + irep->nregs) != 0 ) return -1;
+    block = vm->current_regs + ofs;
+  }
+  if( vm->callinfo_top + 2 > vm->callinfo_size &&
+      extend_callinfo(vm, 2) != 0 ) return -1;
+
+  // set the block and arguments.
+  mrb_value *regs = block + 2;
+  int i;
+  mrbc_release( &regs[0] );
+  regs[0] = *block;
+  mrbc_dup( &regs[0] );
+  for( i = 0; i < argc; i++ ) {
+    mrbc_release( &regs[i+1] );
+    regs[i+1] = argv[i];
+    mrbc_dup( &regs[i+1] );
+  }
+
+  // 1st callinfo returns to the method call instruction,
+  // and 2nd one is for the block.
+  mrb_callinfo *callinfo = vm->callinfo + vm->callinfo_top;
+  callinfo->current_regs = vm->current_regs;
+  callinfo->pc_irep = vm->pc_irep;
+  callinfo->pc = vm->pc - 1;
+  callinfo->n_args = 0;
+  callinfo->flag_yield = 0;
+  callinfo->target_class = vm->target_class;
+  callinfo[1] = callinfo[0];
+  callinfo[1].current_regs = regs;
+  callinfo[1].n_args = argc;
+  callinfo[1].flag_yield = 1;
+  vm->callinfo_top += 2;
+
+  vm->current_regs = regs;
+  vm->pc_irep = irep;
+  vm->pc = 0;
+
+  return 0;
+}
+
+
+
+#if MRBC_IV_CACHE_SIZE > 0
+//================================================================
+/*!@brief
+  Instance variable slot cache, indexed by the instruction address.
+*/
+typedef struct IV_CACHE {
+  mrb_class *cls;
+  mrb_sym sym_id;
+  uint8_t slot;
+} mrb_iv_cache;
+
+static mrb_iv_cache iv_cache[MRBC_IV_CACHE_SIZE];
+#endif
+
+
+//================================================================
+/*!@brief
+  find the ivar slot number, using call site cache.
+
+  A slot number in the class shape never changes,
+  so the cache entries are never invalidated.
+
+  @param  vm		A pointer of VM.
+  @param  cls		class of the object.
+  @param  sym_id	ivar symbol ID.
+  @param  flag_add	add to shape if not found.
+  @return		slot number or -1.
+*/
+static int find_ivar_slot( mrb_vm *vm, mrb_class *cls, mrb_sym sym_id, int flag_add )
+{
+#if MRBC_IV_CACHE_SIZE > 0
+  // (note) vm->pc is saved by the dispatcher before OP_GETIV/SETIV.
+  uintptr_t addr = (uintptr_t)(vm->pc_irep->code + vm->pc * CODE_SIZE);
+  mrb_iv_cache *cache = &iv_cache[(addr / CODE_SIZE) & (MRBC_IV_CACHE_SIZE - 1)];
+  if( cache->cls == cls && cache->sym_id == sym_id ) return cache->slot;
+
+  int slot = mrbc_class_ivar_slot(cls, sym_id, flag_add);
+  if( slot >= 0 ) {
+    cache->cls = cls;
+    cache->sym_id = sym_id;
+    cache->slot = slot;
+  }
+  return slot;
+#else
+  return mrbc_class_ivar_slot(cls, sym_id, flag_add);
+#endif
+}
+
+
 //================================================================
 /*!@brief
   Execute OP_NOP
@@ -149,7 +430,7 @@ void mrbc_pop_callinfo(mrb_vm *vm)
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_nop( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_nop( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   return 0;
 }
@@ -166,12 +447,12 @@ inline static int op_nop( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_move( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_move( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_B(code);
 
-  mrbc_release(&regs[ra]);
+  release_register(vm, regs, ra);
   mrbc_dup(&regs[rb]);
   regs[ra] = regs[rb];
 
@@ -190,12 +471,12 @@ inline static int op_move( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_loadl( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_loadl( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_Bx(code);
 
-  mrbc_release(&regs[ra]);
+  release_register(vm, regs, ra);
 
   // regs[ra] = vm->pc_irep->pools[rb];
 
@@ -217,13 +498,12 @@ inline static int op_loadl( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_loadi( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_loadi( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
-  mrbc_release(&regs[ra]);
-  regs[ra].tt = MRB_TT_FIXNUM;
-  regs[ra].i = GETARG_sBx(code);
+  release_register(vm, regs, ra);
+  mrbc_set_integer(&regs[ra], GETARG_sBx(code));
 
   return 0;
 }
@@ -240,16 +520,14 @@ inline static int op_loadi( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_loadsym( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_loadsym( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_Bx(code);
-  const char *sym_name = mrbc_get_irep_symbol(vm->pc_irep->ptr_to_sym, rb);
-  mrb_sym sym_id = str_to_symid(sym_name);
+  mrb_sym sym_id = vm->pc_irep->syms[rb];
 
-  mrbc_release(&regs[ra]);
-  regs[ra].tt = MRB_TT_SYMBOL;
-  regs[ra].i = sym_id;
+  release_register(vm, regs, ra);
+  mrbc_set_symbol(&regs[ra], sym_id);
 
   return 0;
 }
@@ -266,12 +544,12 @@ inline static int op_loadsym( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_loadnil( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_loadnil( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
-  mrbc_release(&regs[ra]);
-  regs[ra].tt = MRB_TT_NIL;
+  release_register(vm, regs, ra);
+  mrbc_set_nil(&regs[ra]);
 
   return 0;
 }
@@ -288,11 +566,11 @@ inline static int op_loadnil( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_loadself( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_loadself( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
-  mrbc_release(&regs[ra]);
+  release_register(vm, regs, ra);
   mrbc_dup(&regs[0]);       // TODO: Need?
   regs[ra] = regs[0];
 
@@ -311,12 +589,12 @@ inline static int op_loadself( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_loadt( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_loadt( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
-  mrbc_release(&regs[ra]);
-  regs[ra].tt = MRB_TT_TRUE;
+  release_register(vm, regs, ra);
+  mrbc_set_true(&regs[ra]);
 
   return 0;
 }
@@ -333,12 +611,12 @@ inline static int op_loadt( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_loadf( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_loadf( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
-  mrbc_release(&regs[ra]);
-  regs[ra].tt = MRB_TT_FALSE;
+  release_register(vm, regs, ra);
+  mrbc_set_false(&regs[ra]);
 
   return 0;
 }
@@ -355,14 +633,13 @@ inline static int op_loadf( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_getglobal( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_getglobal( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_Bx(code);
-  const char *sym_name = mrbc_get_irep_symbol(vm->pc_irep->ptr_to_sym, rb);
-  mrb_sym sym_id = str_to_symid(sym_name);
+  mrb_sym sym_id = vm->pc_irep->syms[rb];
 
-  mrbc_release(&regs[ra]);
+  release_register(vm, regs, ra);
   regs[ra] = global_object_get(sym_id);
 
   return 0;
@@ -380,12 +657,11 @@ inline static int op_getglobal( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_setglobal( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_setglobal( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_Bx(code);
-  const char *sym_name = mrbc_get_irep_symbol(vm->pc_irep->ptr_to_sym, rb);
-  mrb_sym sym_id = str_to_symid(sym_name);
+  mrb_sym sym_id = vm->pc_irep->syms[rb];
   global_object_add(sym_id, regs[ra]);
 
   return 0;
@@ -403,17 +679,24 @@ inline static int op_setglobal( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_getiv( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_getiv( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_Bx(code);
 
-  const char *sym_name = mrbc_get_irep_symbol(vm->pc_irep->ptr_to_sym, rb);
-  mrb_sym sym_id = str_to_symid(sym_name+1);	// skip '@'
+  mrb_sym sym_id = vm->pc_irep->syms[rb];
+  mrb_value val = mrb_nil_value();
 
-  mrb_value val = mrbc_instance_getiv(&regs[0], sym_id);
+  if( mrbc_type(regs[0]) == MRB_TT_OBJECT ) {
+    mrb_instance *instance = regs[0].instance;
+    int slot = find_ivar_slot(vm, instance->cls, sym_id, 0);
+    if( slot >= 0 && slot < instance->n_ivar ) {
+      val = instance->ivar[slot];
+      mrbc_dup(&val);
+    }
+  }
 
-  mrbc_release(&regs[ra]);
+  release_register(vm, regs, ra);
   regs[ra] = val;
 
   return 0;
@@ -431,15 +714,17 @@ inline static int op_getiv( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_setiv( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_setiv( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_Bx(code);
 
-  const char *sym_name = mrbc_get_irep_symbol(vm->pc_irep->ptr_to_sym, rb);
-  mrb_sym sym_id = str_to_symid(sym_name+1);	// skip '@'
+  mrb_sym sym_id = vm->pc_irep->syms[rb];
 
-  mrbc_instance_setiv(&regs[0], sym_id, &regs[ra]);
+  if( mrbc_type(regs[0]) == MRB_TT_OBJECT ) {
+    int slot = find_ivar_slot(vm, regs[0].instance->cls, sym_id, 1);
+    if( slot >= 0 ) mrbc_instance_setiv_slot(&regs[0], slot, &regs[ra]);
+  }
 
   return 0;
 }
@@ -456,15 +741,29 @@ inline static int op_setiv( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_getconst( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_getconst( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_Bx(code);
-  const char *sym_name = mrbc_get_irep_symbol(vm->pc_irep->ptr_to_sym, rb);
-  mrb_sym sym_id = str_to_symid(sym_name);
-
-  mrbc_release(&regs[ra]);
+  mrb_sym sym_id = vm->pc_irep->syms[rb];
+
+  release_register(vm, regs, ra);
+#if MRBC_USE_CONST_CACHE
+  // the cache is valid until any constant is added.
+  mrbc_const_cache *cache = &vm->pc_irep->const_cache[rb];
+  if( cache->epoch == mrbc_const_epoch ) {
+    PROFILE_CONST_CACHE(const_cache_hit);
+    regs[ra] = cache->value;
+    mrbc_dup(&regs[ra]);
+    return 0;
+  }
+  PROFILE_CONST_CACHE(const_cache_miss);
+  regs[ra] = const_object_get(sym_id);
+  cache->value = regs[ra];
+  cache->epoch = mrbc_const_epoch;
+#else
   regs[ra] = const_object_get(sym_id);
+#endif
 
   return 0;
 }
@@ -482,11 +781,10 @@ inline static int op_getconst( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @retval 0  No error.
 */
 
-inline static int op_setconst( mrb_vm *vm, uint32_t code, mrb_value *regs ) {
+inline static int op_setconst( mrb_vm *vm, mrbc_code_t code, mrb_value *regs ) {
   int ra = GETARG_A(code);
   int rb = GETARG_Bx(code);
-  const char *sym_name = mrbc_get_irep_symbol(vm->pc_irep->ptr_to_sym, rb);
-  mrb_sym sym_id = str_to_symid(sym_name);
+  mrb_sym sym_id = vm->pc_irep->syms[rb];
   const_object_add(sym_id, &regs[ra]);
 
   return 0;
@@ -505,16 +803,17 @@ inline static int op_setconst( mrb_vm *vm, uint32_t code, mrb_value *regs ) {
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_getupvar( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_getupvar( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_B(code);
   int rc = GETARG_C(code);   // UP
 
-  mrb_callinfo *callinfo = vm->callinfo + vm->callinfo_top - 2 - rc;
+  // a block call takes 2 callinfo. (method call and block call)
+  mrb_callinfo *callinfo = vm->callinfo + vm->callinfo_top - 2 - rc * 2;
   mrb_value *up_regs = callinfo->current_regs;
 
-  mrbc_release( &regs[ra] );
+  release_register(vm, regs, ra);
   mrbc_dup( &up_regs[rb] );
   regs[ra] = up_regs[rb];
 
@@ -534,13 +833,14 @@ inline static int op_getupvar( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_setupvar( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_setupvar( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_B(code);
   int rc = GETARG_C(code);   // UP
 
-  mrb_callinfo *callinfo = vm->callinfo + vm->callinfo_top - 2 - rc;
+  // a block call takes 2 callinfo. (method call and block call)
+  mrb_callinfo *callinfo = vm->callinfo + vm->callinfo_top - 2 - rc * 2;
   mrb_value *up_regs = callinfo->current_regs;
 
   mrbc_release( &up_regs[rb] );
@@ -563,7 +863,7 @@ inline static int op_setupvar( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_jmp( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_jmp( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   vm->pc += GETARG_sBx(code) - 1;
   return 0;
@@ -581,9 +881,9 @@ inline static int op_jmp( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_jmpif( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_jmpif( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
-  if( regs[GETARG_A(code)].tt > MRB_TT_FALSE ) {
+  if( mrbc_type(regs[GETARG_A(code)]) > MRB_TT_FALSE ) {
     vm->pc += GETARG_sBx(code) - 1;
   }
   return 0;
@@ -601,9 +901,9 @@ inline static int op_jmpif( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_jmpnot( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_jmpnot( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
-  if( regs[GETARG_A(code)].tt <= MRB_TT_FALSE ) {
+  if( mrbc_type(regs[GETARG_A(code)]) <= MRB_TT_FALSE ) {
     vm->pc += GETARG_sBx(code) - 1;
   }
   return 0;
@@ -622,7 +922,7 @@ inline static int op_jmpnot( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_send( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_send( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_B(code);  // index of method sym
@@ -634,13 +934,13 @@ inline static int op_send( mrb_vm *vm, uint32_t code, mrb_value *regs )
   switch( GET_OPCODE(code) ) {
   case OP_SEND:
     // set nil
-    mrbc_release( &regs[bidx] );
-    regs[bidx].tt = MRB_TT_NIL;
+    release_register(vm, regs, bidx);
+    mrbc_set_nil(&regs[bidx]);
     break;
 
   case OP_SENDB:
     // set Proc object
-    if( regs[bidx].tt != MRB_TT_NIL && regs[bidx].tt != MRB_TT_PROC ){
+    if( mrbc_type(regs[bidx]) != MRB_TT_NIL && mrbc_type(regs[bidx]) != MRB_TT_PROC ){
       // TODO: fix the following behavior
       // convert to Proc ?
       // raise exceprion in mruby/c ?
@@ -652,30 +952,38 @@ inline static int op_send( mrb_vm *vm, uint32_t code, mrb_value *regs )
     break;
   }
 
-  const char *sym_name = mrbc_get_irep_symbol(vm->pc_irep->ptr_to_sym, rb);
-  mrb_sym sym_id = str_to_symid(sym_name);
-  mrb_proc *m = find_method(vm, recv, sym_id);
+  mrb_sym sym_id = vm->pc_irep->syms[rb];
+  mrb_proc *m = find_method_cached(vm, recv, sym_id);
 
   if( m == 0 ) {
-    console_printf("No method. vtype=%d method='%s'\n", recv.tt, sym_name);
+    console_printf("No method. vtype=%d method='%s'\n", mrbc_type(recv), symid_to_str(sym_id));
     return 0;
   }
 
   // m is C func
   if( m->c_func ) {
+    // 2 registers after the block parameter are for mrbc_yield().
+    if( mrbc_extend_regs(vm, bidx + 3) != 0 ) return -1;
+    regs = vm->current_regs;
     m->func(vm, regs + ra, rc);
+    vm->flag_resume = 0;
+    if( vm->error_code ) return -1;	// e.g. stack overflow in Proc#call
 
     int release_reg = ra+rc+1;
     while( release_reg <= bidx ) {
       // mrbc_release(&regs[release_reg]);
       release_reg++;
     }
+    // the operator methods (OP_ADD etc.) leave the argument in R(A+1).
+    if( GET_OPCODE(code) != OP_SEND && GET_OPCODE(code) != OP_SENDB ) {
+      release_register(vm, regs, ra+1);
+    }
     return 0;
   }
 
   // m is Ruby method.
   // callinfo
-  mrbc_push_callinfo(vm, rc);
+  if( mrbc_push_callinfo(vm, rc) != 0 ) return -1;
 
   // target irep
   vm->pc = 0;
@@ -683,6 +991,7 @@ inline static int op_send( mrb_vm *vm, uint32_t code, mrb_value *regs )
 
   // new regs
   vm->current_regs += ra;
+  if( mrbc_extend_regs(vm, m->irep->nregs) != 0 ) return -1;
 
   return 0;
 }
@@ -699,13 +1008,14 @@ inline static int op_send( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_call( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_call( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
-  mrbc_push_callinfo(vm, 0);
+  if( mrbc_push_callinfo(vm, 0) != 0 ) return -1;
 
   // jump to proc
   vm->pc = 0;
   vm->pc_irep = regs[0].proc->irep;
+  if( mrbc_extend_regs(vm, vm->pc_irep->nregs) != 0 ) return -1;
 
   return 0;
 }
@@ -723,7 +1033,7 @@ inline static int op_call( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_enter( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_enter( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   mrb_callinfo *callinfo = vm->callinfo + vm->callinfo_top - 1;
   uint32_t enter_param = GETARG_Ax(code);
@@ -747,16 +1057,24 @@ inline static int op_enter( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_return( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_return( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   // return value
   int ra = GETARG_A(code);
   //  if( ra != 0 ){
   mrb_value v = regs[ra];
   mrbc_dup(&v);
-  mrbc_release(&regs[0]);
+  mrbc_release_temp(&regs[0]);
   regs[0] = v;
   //  }
+#if MRBC_GC_CANDIDATES > 0
+  // release the local variables, so that a cycle dropped by the
+  // return is registered as a candidate of the cycle collector.
+  int i;
+  for( i = 1; i < vm->pc_irep->nlocals; i++ ) {
+    mrbc_release(&regs[i]);
+  }
+#endif
   // restore irep,pc,regs
   vm->callinfo_top--;
   mrb_callinfo *callinfo = vm->callinfo + vm->callinfo_top;
@@ -772,6 +1090,12 @@ inline static int op_return( mrb_vm *vm, uint32_t code, mrb_value *regs )
   vm->pc_irep = callinfo->pc_irep;
   vm->pc = callinfo->pc;
   vm->target_class = callinfo->target_class;
+
+  // return from the block called by mrbc_yield()
+  if( callinfo->flag_yield ) {
+    mrbc_pop_callinfo(vm);
+    vm->flag_resume = 1;
+  }
   return 0;
 }
 
@@ -787,17 +1111,17 @@ inline static int op_return( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_blkpush( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_blkpush( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
   mrb_value *stack = regs + 1;
 
-  if( stack[0].tt == MRB_TT_NIL ){
+  if( mrbc_type(stack[0]) == MRB_TT_NIL ){
     return -1;  // EYIELD
   }
 
-  mrbc_release(&regs[ra]);
+  release_register(vm, regs, ra);
   mrbc_dup( stack );
   regs[ra] = stack[0];
 
@@ -817,37 +1141,35 @@ inline static int op_blkpush( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_add( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_add( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
-  if( regs[ra].tt == MRB_TT_FIXNUM ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {	// in case of Fixnum, Fixnum
-      regs[ra].i += regs[ra+1].i;
+  if( mrbc_type(regs[ra]) == MRB_TT_FIXNUM ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {	// in case of Fixnum, Fixnum
+      mrbc_integer(regs[ra]) += mrbc_integer(regs[ra+1]);
       return 0;
     }
 #if MRBC_USE_FLOAT
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {	// in case of Fixnum, Float
-      regs[ra].tt = MRB_TT_FLOAT;
-      regs[ra].d = regs[ra].i + regs[ra+1].d;
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {	// in case of Fixnum, Float
+      mrbc_set_float(&regs[ra], mrbc_integer(regs[ra]) + mrbc_float(regs[ra+1]));
       return 0;
     }
   }
-  if( regs[ra].tt == MRB_TT_FLOAT ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {	// in case of Float, Fixnum
-      regs[ra].d += regs[ra+1].i;
+  if( mrbc_type(regs[ra]) == MRB_TT_FLOAT ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {	// in case of Float, Fixnum
+      mrbc_set_float(&regs[ra], mrbc_float(regs[ra]) + mrbc_integer(regs[ra+1]));
       return 0;
     }
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {	// in case of Float, Float
-      regs[ra].d += regs[ra+1].d;
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {	// in case of Float, Float
+      mrbc_set_float(&regs[ra], mrbc_float(regs[ra]) + mrbc_float(regs[ra+1]));
       return 0;
     }
 #endif
   }
 
   // other case
-  op_send(vm, code, regs);
-  return 0;
+  return op_send(vm, code, regs);
 }
 
 
@@ -862,18 +1184,18 @@ inline static int op_add( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_addi( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_addi( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
-  if( regs[ra].tt == MRB_TT_FIXNUM ) {
-    regs[ra].i += GETARG_C(code);
+  if( mrbc_type(regs[ra]) == MRB_TT_FIXNUM ) {
+    mrbc_integer(regs[ra]) += GETARG_C(code);
     return 0;
   }
 
 #if MRBC_USE_FLOAT
-  if( regs[ra].tt == MRB_TT_FLOAT ) {
-    regs[ra].d += GETARG_C(code);
+  if( mrbc_type(regs[ra]) == MRB_TT_FLOAT ) {
+    mrbc_set_float(&regs[ra], mrbc_float(regs[ra]) + GETARG_C(code));
     return 0;
   }
 #endif
@@ -894,38 +1216,35 @@ inline static int op_addi( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_sub( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_sub( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
-  if( regs[ra].tt == MRB_TT_FIXNUM ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {	// in case of Fixnum, Fixnum
-      regs[ra].i -= regs[ra+1].i;
+  if( mrbc_type(regs[ra]) == MRB_TT_FIXNUM ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {	// in case of Fixnum, Fixnum
+      mrbc_integer(regs[ra]) -= mrbc_integer(regs[ra+1]);
       return 0;
     }
 #if MRBC_USE_FLOAT
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {	// in case of Fixnum, Float
-      regs[ra].tt = MRB_TT_FLOAT;
-      regs[ra].d = regs[ra].i - regs[ra+1].d;
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {	// in case of Fixnum, Float
+      mrbc_set_float(&regs[ra], mrbc_integer(regs[ra]) - mrbc_float(regs[ra+1]));
       return 0;
     }
   }
-  if( regs[ra].tt == MRB_TT_FLOAT ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {	// in case of Float, Fixnum
-      regs[ra].d -= regs[ra+1].i;
+  if( mrbc_type(regs[ra]) == MRB_TT_FLOAT ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {	// in case of Float, Fixnum
+      mrbc_set_float(&regs[ra], mrbc_float(regs[ra]) - mrbc_integer(regs[ra+1]));
       return 0;
     }
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {	// in case of Float, Float
-      regs[ra].d -= regs[ra+1].d;
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {	// in case of Float, Float
+      mrbc_set_float(&regs[ra], mrbc_float(regs[ra]) - mrbc_float(regs[ra+1]));
       return 0;
     }
 #endif
   }
 
   // other case
-  op_send(vm, code, regs);
-  mrbc_release(&regs[ra+1]);
-  return 0;
+  return op_send(vm, code, regs);
 }
 
 
@@ -940,18 +1259,18 @@ inline static int op_sub( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_subi( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_subi( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
-  if( regs[ra].tt == MRB_TT_FIXNUM ) {
-    regs[ra].i -= GETARG_C(code);
+  if( mrbc_type(regs[ra]) == MRB_TT_FIXNUM ) {
+    mrbc_integer(regs[ra]) -= GETARG_C(code);
     return 0;
   }
 
 #if MRBC_USE_FLOAT
-  if( regs[ra].tt == MRB_TT_FLOAT ) {
-    regs[ra].d -= GETARG_C(code);
+  if( mrbc_type(regs[ra]) == MRB_TT_FLOAT ) {
+    mrbc_set_float(&regs[ra], mrbc_float(regs[ra]) - GETARG_C(code));
     return 0;
   }
 #endif
@@ -972,38 +1291,35 @@ inline static int op_subi( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_mul( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_mul( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
-  if( regs[ra].tt == MRB_TT_FIXNUM ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {	// in case of Fixnum, Fixnum
-      regs[ra].i *= regs[ra+1].i;
+  if( mrbc_type(regs[ra]) == MRB_TT_FIXNUM ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {	// in case of Fixnum, Fixnum
+      mrbc_integer(regs[ra]) *= mrbc_integer(regs[ra+1]);
       return 0;
     }
 #if MRBC_USE_FLOAT
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {	// in case of Fixnum, Float
-      regs[ra].tt = MRB_TT_FLOAT;
-      regs[ra].d = regs[ra].i * regs[ra+1].d;
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {	// in case of Fixnum, Float
+      mrbc_set_float(&regs[ra], mrbc_integer(regs[ra]) * mrbc_float(regs[ra+1]));
       return 0;
     }
   }
-  if( regs[ra].tt == MRB_TT_FLOAT ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {	// in case of Float, Fixnum
-      regs[ra].d *= regs[ra+1].i;
+  if( mrbc_type(regs[ra]) == MRB_TT_FLOAT ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {	// in case of Float, Fixnum
+      mrbc_set_float(&regs[ra], mrbc_float(regs[ra]) * mrbc_integer(regs[ra+1]));
       return 0;
     }
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {	// in case of Float, Float
-      regs[ra].d *= regs[ra+1].d;
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {	// in case of Float, Float
+      mrbc_set_float(&regs[ra], mrbc_float(regs[ra]) * mrbc_float(regs[ra+1]));
       return 0;
     }
 #endif
   }
 
   // other case
-  op_send(vm, code, regs);
-  mrbc_release(&regs[ra+1]);
-  return 0;
+  return op_send(vm, code, regs);
 }
 
 
@@ -1018,38 +1334,35 @@ inline static int op_mul( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_div( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_div( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
-  if( regs[ra].tt == MRB_TT_FIXNUM ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {	// in case of Fixnum, Fixnum
-      regs[ra].i /= regs[ra+1].i;
+  if( mrbc_type(regs[ra]) == MRB_TT_FIXNUM ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {	// in case of Fixnum, Fixnum
+      mrbc_integer(regs[ra]) /= mrbc_integer(regs[ra+1]);
       return 0;
     }
 #if MRBC_USE_FLOAT
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {	// in case of Fixnum, Float
-      regs[ra].tt = MRB_TT_FLOAT;
-      regs[ra].d = regs[ra].i / regs[ra+1].d;
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {	// in case of Fixnum, Float
+      mrbc_set_float(&regs[ra], mrbc_integer(regs[ra]) / mrbc_float(regs[ra+1]));
       return 0;
     }
   }
-  if( regs[ra].tt == MRB_TT_FLOAT ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {	// in case of Float, Fixnum
-      regs[ra].d /= regs[ra+1].i;
+  if( mrbc_type(regs[ra]) == MRB_TT_FLOAT ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {	// in case of Float, Fixnum
+      mrbc_set_float(&regs[ra], mrbc_float(regs[ra]) / mrbc_integer(regs[ra+1]));
       return 0;
     }
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {	// in case of Float, Float
-      regs[ra].d /= regs[ra+1].d;
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {	// in case of Float, Float
+      mrbc_set_float(&regs[ra], mrbc_float(regs[ra]) / mrbc_float(regs[ra+1]));
       return 0;
     }
 #endif
   }
 
   // other case
-  op_send(vm, code, regs);
-  mrbc_release(&regs[ra+1]);
-  return 0;
+  return op_send(vm, code, regs);
 }
 
 
@@ -1064,14 +1377,14 @@ inline static int op_div( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_eq( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_eq( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int result = mrbc_compare(&regs[ra], &regs[ra+1]);
 
-  mrbc_release(&regs[ra+1]);
-  mrbc_release(&regs[ra]);
-  regs[ra].tt = result ? MRB_TT_FALSE : MRB_TT_TRUE;
+  release_register(vm, regs, ra+1);
+  release_register(vm, regs, ra);
+  mrbc_set_bool(&regs[ra], !result);
 
   return 0;
 }
@@ -1088,41 +1401,39 @@ inline static int op_eq( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_lt( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_lt( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int result;
 
-  if( regs[ra].tt == MRB_TT_FIXNUM ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {
-      result = regs[ra].i < regs[ra+1].i;	// in case of Fixnum, Fixnum
+  if( mrbc_type(regs[ra]) == MRB_TT_FIXNUM ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {
+      result = mrbc_integer(regs[ra]) < mrbc_integer(regs[ra+1]);	// in case of Fixnum, Fixnum
       goto DONE;
     }
 #if MRBC_USE_FLOAT
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {
-      result = regs[ra].i < regs[ra+1].d;	// in case of Fixnum, Float
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {
+      result = mrbc_integer(regs[ra]) < mrbc_float(regs[ra+1]);	// in case of Fixnum, Float
       goto DONE;
     }
   }
-  if( regs[ra].tt == MRB_TT_FLOAT ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {
-      result = regs[ra].d < regs[ra+1].i;	// in case of Float, Fixnum
+  if( mrbc_type(regs[ra]) == MRB_TT_FLOAT ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {
+      result = mrbc_float(regs[ra]) < mrbc_integer(regs[ra+1]);	// in case of Float, Fixnum
       goto DONE;
     }
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {
-      result = regs[ra].d < regs[ra+1].d;	// in case of Float, Float
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {
+      result = mrbc_float(regs[ra]) < mrbc_float(regs[ra+1]);	// in case of Float, Float
       goto DONE;
     }
 #endif
   }
 
   // other case
-  op_send(vm, code, regs);
-  mrbc_release(&regs[ra+1]);
-  return 0;
+  return op_send(vm, code, regs);
 
 DONE:
-  regs[ra].tt = result ? MRB_TT_TRUE : MRB_TT_FALSE;
+  mrbc_set_bool(&regs[ra], result);
   return 0;
 }
 
@@ -1138,41 +1449,39 @@ DONE:
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_le( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_le( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int result;
 
-  if( regs[ra].tt == MRB_TT_FIXNUM ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {
-      result = regs[ra].i <= regs[ra+1].i;	// in case of Fixnum, Fixnum
+  if( mrbc_type(regs[ra]) == MRB_TT_FIXNUM ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {
+      result = mrbc_integer(regs[ra]) <= mrbc_integer(regs[ra+1]);	// in case of Fixnum, Fixnum
       goto DONE;
     }
 #if MRBC_USE_FLOAT
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {
-      result = regs[ra].i <= regs[ra+1].d;	// in case of Fixnum, Float
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {
+      result = mrbc_integer(regs[ra]) <= mrbc_float(regs[ra+1]);	// in case of Fixnum, Float
       goto DONE;
     }
   }
-  if( regs[ra].tt == MRB_TT_FLOAT ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {
-      result = regs[ra].d <= regs[ra+1].i;	// in case of Float, Fixnum
+  if( mrbc_type(regs[ra]) == MRB_TT_FLOAT ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {
+      result = mrbc_float(regs[ra]) <= mrbc_integer(regs[ra+1]);	// in case of Float, Fixnum
       goto DONE;
     }
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {
-      result = regs[ra].d <= regs[ra+1].d;	// in case of Float, Float
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {
+      result = mrbc_float(regs[ra]) <= mrbc_float(regs[ra+1]);	// in case of Float, Float
       goto DONE;
     }
 #endif
   }
 
   // other case
-  op_send(vm, code, regs);
-  mrbc_release(&regs[ra+1]);
-  return 0;
+  return op_send(vm, code, regs);
 
 DONE:
-  regs[ra].tt = result ? MRB_TT_TRUE : MRB_TT_FALSE;
+  mrbc_set_bool(&regs[ra], result);
   return 0;
 }
 
@@ -1188,41 +1497,39 @@ DONE:
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_gt( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_gt( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int result;
 
-  if( regs[ra].tt == MRB_TT_FIXNUM ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {
-      result = regs[ra].i > regs[ra+1].i;	// in case of Fixnum, Fixnum
+  if( mrbc_type(regs[ra]) == MRB_TT_FIXNUM ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {
+      result = mrbc_integer(regs[ra]) > mrbc_integer(regs[ra+1]);	// in case of Fixnum, Fixnum
       goto DONE;
     }
 #if MRBC_USE_FLOAT
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {
-      result = regs[ra].i > regs[ra+1].d;	// in case of Fixnum, Float
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {
+      result = mrbc_integer(regs[ra]) > mrbc_float(regs[ra+1]);	// in case of Fixnum, Float
       goto DONE;
     }
   }
-  if( regs[ra].tt == MRB_TT_FLOAT ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {
-      result = regs[ra].d > regs[ra+1].i;	// in case of Float, Fixnum
+  if( mrbc_type(regs[ra]) == MRB_TT_FLOAT ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {
+      result = mrbc_float(regs[ra]) > mrbc_integer(regs[ra+1]);	// in case of Float, Fixnum
       goto DONE;
     }
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {
-      result = regs[ra].d > regs[ra+1].d;	// in case of Float, Float
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {
+      result = mrbc_float(regs[ra]) > mrbc_float(regs[ra+1]);	// in case of Float, Float
       goto DONE;
     }
 #endif
   }
 
   // other case
-  op_send(vm, code, regs);
-  mrbc_release(&regs[ra+1]);
-  return 0;
+  return op_send(vm, code, regs);
 
 DONE:
-  regs[ra].tt = result ? MRB_TT_TRUE : MRB_TT_FALSE;
+  mrbc_set_bool(&regs[ra], result);
   return 0;
 }
 
@@ -1238,41 +1545,39 @@ DONE:
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_ge( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_ge( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int result;
 
-  if( regs[ra].tt == MRB_TT_FIXNUM ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {
-      result = regs[ra].i >= regs[ra+1].i;	// in case of Fixnum, Fixnum
+  if( mrbc_type(regs[ra]) == MRB_TT_FIXNUM ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {
+      result = mrbc_integer(regs[ra]) >= mrbc_integer(regs[ra+1]);	// in case of Fixnum, Fixnum
       goto DONE;
     }
 #if MRBC_USE_FLOAT
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {
-      result = regs[ra].i >= regs[ra+1].d;	// in case of Fixnum, Float
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {
+      result = mrbc_integer(regs[ra]) >= mrbc_float(regs[ra+1]);	// in case of Fixnum, Float
       goto DONE;
     }
   }
-  if( regs[ra].tt == MRB_TT_FLOAT ) {
-    if( regs[ra+1].tt == MRB_TT_FIXNUM ) {
-      result = regs[ra].d >= regs[ra+1].i;	// in case of Float, Fixnum
+  if( mrbc_type(regs[ra]) == MRB_TT_FLOAT ) {
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FIXNUM ) {
+      result = mrbc_float(regs[ra]) >= mrbc_integer(regs[ra+1]);	// in case of Float, Fixnum
       goto DONE;
     }
-    if( regs[ra+1].tt == MRB_TT_FLOAT ) {
-      result = regs[ra].d >= regs[ra+1].d;	// in case of Float, Float
+    if( mrbc_type(regs[ra+1]) == MRB_TT_FLOAT ) {
+      result = mrbc_float(regs[ra]) >= mrbc_float(regs[ra+1]);	// in case of Float, Float
       goto DONE;
     }
 #endif
   }
 
   // other case
-  op_send(vm, code, regs);
-  mrbc_release(&regs[ra+1]);
-  return 0;
+  return op_send(vm, code, regs);
 
 DONE:
-  regs[ra].tt = result ? MRB_TT_TRUE : MRB_TT_FALSE;
+  mrbc_set_bool(&regs[ra], result);
   return 0;
 }
 
@@ -1288,7 +1593,7 @@ DONE:
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_array( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_array( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_B(code);
@@ -1301,7 +1606,7 @@ inline static int op_array( mrb_vm *vm, uint32_t code, mrb_value *regs )
   memset( &regs[rb], 0, sizeof(mrb_value) * rc );
   value.array->n_stored = rc;
 
-  mrbc_release(&regs[ra]);
+  release_register(vm, regs, ra);
   regs[ra] = value;
 
   return 0;
@@ -1319,7 +1624,7 @@ inline static int op_array( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_string( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_string( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
 #if MRBC_USE_STRING
   int ra = GETARG_A(code);
@@ -1331,7 +1636,7 @@ inline static int op_string( mrb_vm *vm, uint32_t code, mrb_value *regs )
   mrb_value value = mrbc_string_new(vm, pool_obj->str, len);
   if( value.string == NULL ) return -1;		// ENOMEM
 
-  mrbc_release(&regs[ra]);
+  release_register(vm, regs, ra);
   regs[ra] = value;
 
 #else
@@ -1352,14 +1657,14 @@ inline static int op_string( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_strcat( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_strcat( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
 #if MRBC_USE_STRING
   int ra = GETARG_A(code);
   int rb = GETARG_B(code);
 
   // call "to_s"
-  mrb_sym sym_id = str_to_symid("to_s");
+  mrb_sym sym_id = MRBC_SYM_to_s;
   mrb_proc *m;
   m = find_method(vm, regs[ra], sym_id);
   if( m && m->c_func ){
@@ -1371,7 +1676,7 @@ inline static int op_strcat( mrb_vm *vm, uint32_t code, mrb_value *regs )
   }
 
   mrb_value v = mrbc_string_add(vm, &regs[ra], &regs[rb]);
-  mrbc_release(&regs[ra]);
+  release_register(vm, regs, ra);
   regs[ra] = v;
 
 #else
@@ -1392,7 +1697,7 @@ inline static int op_strcat( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_hash( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_hash( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_B(code);
@@ -1406,7 +1711,7 @@ inline static int op_hash( mrb_vm *vm, uint32_t code, mrb_value *regs )
   memset( &regs[rb], 0, sizeof(mrb_value) * rc );
   value.hash->n_stored = rc;
 
-  mrbc_release(&regs[ra]);
+  release_register(vm, regs, ra);
   regs[ra] = value;
 
   return 0;
@@ -1424,7 +1729,7 @@ inline static int op_hash( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_lambda( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_lambda( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_Bz(code);      // sequence position in irep list
@@ -1434,8 +1739,8 @@ inline static int op_lambda( mrb_vm *vm, uint32_t code, mrb_value *regs )
   proc->c_func = 0;
   proc->irep = vm->pc_irep->reps[rb];
 
-  mrbc_release(&regs[ra]);
-  regs[ra].tt = MRB_TT_PROC;
+  release_register(vm, regs, ra);
+  mrbc_set_tt(&regs[ra], MRB_TT_PROC);
   regs[ra].proc = proc;
 
   return 0;
@@ -1453,7 +1758,7 @@ inline static int op_lambda( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_range( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_range( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_B(code);
@@ -1465,7 +1770,7 @@ inline static int op_range( mrb_vm *vm, uint32_t code, mrb_value *regs )
   mrb_value value = mrbc_range_new(vm, &regs[rb], &regs[rb+1], rc);
   if( value.range == NULL ) return -1;		// ENOMEM
 
-  mrbc_release(&regs[ra]);
+  release_register(vm, regs, ra);
   regs[ra] = value;
 
   return 0;
@@ -1485,18 +1790,17 @@ inline static int op_range( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_class( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_class( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_B(code);
 
-  mrb_irep *cur_irep = vm->pc_irep;
-  const char *sym_name = mrbc_get_irep_symbol(cur_irep->ptr_to_sym, rb);
-  mrb_class *super = (regs[ra+1].tt == MRB_TT_CLASS) ? regs[ra+1].cls : mrbc_class_object;
+  const char *sym_name = symid_to_str(vm->pc_irep->syms[rb]);
+  mrb_class *super = (mrbc_type(regs[ra+1]) == MRB_TT_CLASS) ? regs[ra+1].cls : mrbc_class_object;
 
   mrb_class *cls = mrbc_define_class(vm, sym_name, super);
 
-  mrb_value ret = {.tt = MRB_TT_CLASS};
+  mrb_value ret = MRBC_VALUE_INIT(MRB_TT_CLASS);
   ret.cls = cls;
 
   regs[ra] = ret;
@@ -1516,7 +1820,7 @@ inline static int op_class( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_exec( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_exec( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_Bx(code);
@@ -1524,13 +1828,7 @@ inline static int op_exec( mrb_vm *vm, uint32_t code, mrb_value *regs )
   mrb_value recv = regs[ra];
 
   // prepare callinfo
-  mrb_callinfo *callinfo = vm->callinfo + vm->callinfo_top;
-  callinfo->current_regs = vm->current_regs;
-  callinfo->pc_irep = vm->pc_irep;
-  callinfo->pc = vm->pc;
-  callinfo->target_class = vm->target_class;
-  callinfo->n_args = 0;
-  vm->callinfo_top++;
+  if( mrbc_push_callinfo(vm, 0) != 0 ) return -1;
 
   // target irep
   vm->pc = 0;
@@ -1538,6 +1836,7 @@ inline static int op_exec( mrb_vm *vm, uint32_t code, mrb_value *regs )
 
   // new regs
   vm->current_regs += ra;
+  if( mrbc_extend_regs(vm, vm->pc_irep->nregs) != 0 ) return -1;
 
   vm->target_class = find_class_by_object(vm, &recv);
 
@@ -1557,19 +1856,17 @@ inline static int op_exec( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_method( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_method( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
   int rb = GETARG_B(code);
   mrb_proc *proc = regs[ra+1].proc;
 
-  if( regs[ra].tt == MRB_TT_CLASS ) {
+  if( mrbc_type(regs[ra]) == MRB_TT_CLASS ) {
     mrb_class *cls = regs[ra].cls;
 
     // sym_id : method name
-    mrb_irep *cur_irep = vm->pc_irep;
-    const char *sym_name = mrbc_get_irep_symbol(cur_irep->ptr_to_sym, rb);
-    int sym_id = str_to_symid(sym_name);
+    mrb_sym sym_id = vm->pc_irep->syms[rb];
 
     // check same name method
     mrb_proc *p = cls->procs;
@@ -1583,7 +1880,7 @@ inline static int op_method( mrb_vm *vm, uint32_t code, mrb_value *regs )
       // found it.
       *((mrb_proc**)pp) = p->next;
       if( !p->c_func ) {
-	mrb_value v = {.tt = MRB_TT_PROC};
+	mrb_value v = MRBC_VALUE_INIT(MRB_TT_PROC);
 	v.proc = p;
 	mrbc_release(&v);
       }
@@ -1593,13 +1890,15 @@ inline static int op_method( mrb_vm *vm, uint32_t code, mrb_value *regs )
     proc->c_func = 0;
     proc->sym_id = sym_id;
 #ifdef MRBC_DEBUG
-    proc->names = sym_name;		// debug only.
+    proc->names = symid_to_str(sym_id);	// debug only.
 #endif
     proc->next = cls->procs;
     cls->procs = proc;
 
     mrbc_set_vm_id(proc, 0);
-    regs[ra+1].tt = MRB_TT_EMPTY;
+    mrbc_set_tt(&regs[ra+1], MRB_TT_EMPTY);
+
+    mrbc_clear_method_cache();
   }
 
   return 0;
@@ -1617,12 +1916,12 @@ inline static int op_method( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval 0  No error.
 */
-inline static int op_tclass( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_tclass( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   int ra = GETARG_A(code);
 
-  mrbc_release(&regs[ra]);
-  regs[ra].tt = MRB_TT_CLASS;
+  release_register(vm, regs, ra);
+  mrbc_set_tt(&regs[ra], MRB_TT_CLASS);
   regs[ra].cls = vm->target_class;
 
   return 0;
@@ -1641,14 +1940,14 @@ inline static int op_tclass( mrb_vm *vm, uint32_t code, mrb_value *regs )
   @param  regs  vm->regs + vm->reg_top
   @retval -1  No error and exit from vm.
 */
-inline static int op_stop( mrb_vm *vm, uint32_t code, mrb_value *regs )
+inline static int op_stop( mrb_vm *vm, mrbc_code_t code, mrb_value *regs )
 {
   if( GET_OPCODE(code) == OP_STOP ) {
 #ifdef ENABLE_RMIRB
      if(vm->callinfo_top!=0){
 #endif
       int i;
-      for( i = 0; i < MAX_REGS_SIZE; i++ ) {
+      for( i = 0; i < vm->regs_size; i++ ) {
         mrbc_release(&vm->regs[i]);
       }
 #ifdef ENABLE_RMIRB
@@ -1662,6 +1961,207 @@ inline static int op_stop( mrb_vm *vm, uint32_t code, mrb_value *regs )
 }
 
 
+#if MRBC_USE_SUPERINSTRUCTION
+//================================================================
+/*!@brief
+  Execute fused opcodes (superinstructions)
+
+  Execute code[0] and code[1] in one dispatch.
+  code[1] is left as is in ISEQ, and is skipped here.
+
+  @param  vm    A pointer of VM.
+  @param  code  bytecode
+  @param  regs  vm->regs + vm->reg_top
+  @retval 0  No error.
+*/
+#define FUSED_OP(name, op1, op2)					\
+inline static int op_##name( mrb_vm *vm, mrbc_code_t code, mrb_value *regs ) \
+{									\
+  op1(vm, code, regs);							\
+  vm->pc++;								\
+  return op2(vm, code + 1, regs);					\
+}
+
+// op1 calls a method if operands are not numeric.
+// In that case, execute op1 only and code[1] is executed after return.
+#if MRBC_USE_FLOAT
+#define IS_NUMERIC(v) (mrbc_type(v) == MRB_TT_FIXNUM || mrbc_type(v) == MRB_TT_FLOAT)
+#else
+#define IS_NUMERIC(v) (mrbc_type(v) == MRB_TT_FIXNUM)
+#endif
+#define FUSED_CMP_OP(name, op1, op2)					\
+inline static int op_##name( mrb_vm *vm, mrbc_code_t code, mrb_value *regs ) \
+{									\
+  int ra = GETARG_A(code);						\
+  if( !IS_NUMERIC(regs[ra]) || !IS_NUMERIC(regs[ra+1]) ) {		\
+    return op1(vm, code, regs);						\
+  }									\
+  op1(vm, code, regs);							\
+  vm->pc++;								\
+  return op2(vm, code + 1, regs);					\
+}
+
+FUSED_OP    ( x_eq_jmpif,      op_eq,       op_jmpif )
+FUSED_OP    ( x_eq_jmpnot,     op_eq,       op_jmpnot )
+FUSED_CMP_OP( x_lt_jmpif,      op_lt,       op_jmpif )
+FUSED_CMP_OP( x_lt_jmpnot,     op_lt,       op_jmpnot )
+FUSED_CMP_OP( x_le_jmpif,      op_le,       op_jmpif )
+FUSED_CMP_OP( x_le_jmpnot,     op_le,       op_jmpnot )
+FUSED_CMP_OP( x_gt_jmpif,      op_gt,       op_jmpif )
+FUSED_CMP_OP( x_gt_jmpnot,     op_gt,       op_jmpnot )
+FUSED_CMP_OP( x_ge_jmpif,      op_ge,       op_jmpif )
+FUSED_CMP_OP( x_ge_jmpnot,     op_ge,       op_jmpnot )
+FUSED_OP    ( x_loadi_add,     op_loadi,    op_add )
+FUSED_OP    ( x_loadi_sub,     op_loadi,    op_sub )
+FUSED_OP    ( x_loadi_lt,      op_loadi,    op_lt )
+FUSED_OP    ( x_move_send,     op_move,     op_send )
+FUSED_OP    ( x_loadself_send, op_loadself, op_send )
+FUSED_OP    ( x_getiv_send,    op_getiv,    op_send )
+
+#undef FUSED_OP
+#undef FUSED_CMP_OP
+#undef IS_NUMERIC
+#endif
+
+
+#if MRBC_PROFILE_CONST_CACHE
+//================================================================
+/*!@brief
+  get the counters of the constant cache.
+
+  @param  hit	pointer to store the number of hits.
+  @param  miss	pointer to store the number of misses.
+*/
+void mrbc_get_const_cache_stat( uint32_t *hit, uint32_t *miss )
+{
+  *hit = const_cache_hit;
+  *miss = const_cache_miss;
+}
+
+
+//================================================================
+/*!@brief
+  clear the counters of the constant cache.
+*/
+void mrbc_clear_const_cache_stat( void )
+{
+  const_cache_hit = 0;
+  const_cache_miss = 0;
+}
+#endif
+
+
+#if MRBC_PROFILE_OPCODE_PAIRS
+#define OPCODE_PAIRS_SIZE 256	// power of 2
+static struct {
+  uint8_t op1;
+  uint8_t op2;
+  uint32_t count;
+} opcode_pairs[OPCODE_PAIRS_SIZE];
+static uint8_t prev_opcode;
+
+//================================================================
+/*!@brief
+  count an executed opcode pair (previous opcode, this opcode).
+
+  @param  opcode	opcode
+*/
+static void count_opcode_pair( int opcode )
+{
+  int i = (prev_opcode * 127 + opcode) & (OPCODE_PAIRS_SIZE-1);
+  int n;
+
+  for( n = 0; n < OPCODE_PAIRS_SIZE; n++ ) {
+    if( opcode_pairs[i].count == 0 ) {
+      opcode_pairs[i].op1 = prev_opcode;
+      opcode_pairs[i].op2 = opcode;
+      break;
+    }
+    if( opcode_pairs[i].op1 == prev_opcode &&
+	opcode_pairs[i].op2 == opcode ) break;
+    i = (i + 1) & (OPCODE_PAIRS_SIZE-1);
+  }
+  if( n < OPCODE_PAIRS_SIZE ) opcode_pairs[i].count++;
+
+  prev_opcode = opcode;
+}
+
+
+//================================================================
+/*!@brief
+  print most frequent opcode pairs.
+
+  @param  n	number of pairs to print.
+*/
+void mrbc_print_opcode_pairs( int n )
+{
+  static const char * const names[128] = {
+    [OP_NOP] = "NOP", [OP_MOVE] = "MOVE", [OP_LOADL] = "LOADL",
+    [OP_LOADI] = "LOADI", [OP_LOADSYM] = "LOADSYM", [OP_LOADNIL] = "LOADNIL",
+    [OP_LOADSELF] = "LOADSELF", [OP_LOADT] = "LOADT", [OP_LOADF] = "LOADF",
+    [OP_GETGLOBAL] = "GETGLOBAL", [OP_SETGLOBAL] = "SETGLOBAL",
+    [OP_GETIV] = "GETIV", [OP_SETIV] = "SETIV",
+    [OP_GETCONST] = "GETCONST", [OP_SETCONST] = "SETCONST",
+    [OP_GETUPVAR] = "GETUPVAR", [OP_SETUPVAR] = "SETUPVAR",
+    [OP_JMP] = "JMP", [OP_JMPIF] = "JMPIF", [OP_JMPNOT] = "JMPNOT",
+    [OP_SEND] = "SEND", [OP_SENDB] = "SENDB", [OP_CALL] = "CALL",
+    [OP_ENTER] = "ENTER", [OP_RETURN] = "RETURN", [OP_BLKPUSH] = "BLKPUSH",
+    [OP_ADD] = "ADD", [OP_ADDI] = "ADDI", [OP_SUB] = "SUB", [OP_SUBI] = "SUBI",
+    [OP_MUL] = "MUL", [OP_DIV] = "DIV", [OP_EQ] = "EQ", [OP_LT] = "LT",
+    [OP_LE] = "LE", [OP_GT] = "GT", [OP_GE] = "GE",
+    [OP_ARRAY] = "ARRAY", [OP_STRING] = "STRING", [OP_STRCAT] = "STRCAT",
+    [OP_HASH] = "HASH", [OP_LAMBDA] = "LAMBDA", [OP_RANGE] = "RANGE",
+    [OP_CLASS] = "CLASS", [OP_EXEC] = "EXEC", [OP_METHOD] = "METHOD",
+    [OP_TCLASS] = "TCLASS", [OP_STOP] = "STOP", [OP_ABORT] = "ABORT",
+#if MRBC_USE_SUPERINSTRUCTION
+    [OP_X_EQ_JMPIF] = "X_EQ_JMPIF", [OP_X_EQ_JMPNOT] = "X_EQ_JMPNOT",
+    [OP_X_LT_JMPIF] = "X_LT_JMPIF", [OP_X_LT_JMPNOT] = "X_LT_JMPNOT",
+    [OP_X_LE_JMPIF] = "X_LE_JMPIF", [OP_X_LE_JMPNOT] = "X_LE_JMPNOT",
+    [OP_X_GT_JMPIF] = "X_GT_JMPIF", [OP_X_GT_JMPNOT] = "X_GT_JMPNOT",
+    [OP_X_GE_JMPIF] = "X_GE_JMPIF", [OP_X_GE_JMPNOT] = "X_GE_JMPNOT",
+    [OP_X_LOADI_ADD] = "X_LOADI_ADD", [OP_X_LOADI_SUB] = "X_LOADI_SUB",
+    [OP_X_LOADI_LT] = "X_LOADI_LT", [OP_X_MOVE_SEND] = "X_MOVE_SEND",
+    [OP_X_LOADSELF_SEND] = "X_LOADSELF_SEND",
+    [OP_X_GETIV_SEND] = "X_GETIV_SEND",
+#endif
+  };
+  uint8_t done[OPCODE_PAIRS_SIZE / 8] = {0};
+
+  console_printf("     count  opcode pair\n");
+  while( n-- > 0 ) {
+    // find the largest count, not printed yet.
+    int i, max_i = -1;
+    for( i = 0; i < OPCODE_PAIRS_SIZE; i++ ) {
+      if( opcode_pairs[i].count == 0 ) continue;
+      if( done[i / 8] & (1 << (i % 8)) ) continue;
+      if( max_i < 0 || opcode_pairs[i].count > opcode_pairs[max_i].count ) {
+	max_i = i;
+      }
+    }
+    if( max_i < 0 ) break;
+    done[max_i / 8] |= 1 << (max_i % 8);
+
+    const char *s1 = names[opcode_pairs[max_i].op1];
+    const char *s2 = names[opcode_pairs[max_i].op2];
+    console_printf("%10d  %s(%02x) %s(%02x)\n", opcode_pairs[max_i].count,
+		   s1 ? s1 : "?", opcode_pairs[max_i].op1,
+		   s2 ? s2 : "?", opcode_pairs[max_i].op2);
+  }
+}
+
+
+//================================================================
+/*!@brief
+  clear opcode pair counters.
+*/
+void mrbc_clear_opcode_pairs( void )
+{
+  memset( opcode_pairs, 0, sizeof(opcode_pairs) );
+  prev_opcode = 0;
+}
+#endif
+
+
 //================================================================
 /*!@brief
   Open the VM.
@@ -1730,27 +2230,47 @@ void mrbc_vm_close(mrb_vm *vm)
 /*!@brief
   VM initializer.
 
+  The register stack is allocated by the need of top level IREP.
+
   @param  vm  Pointer to VM
+  @retval 0	No error.
+  @retval -1	Not enough memory.
 */
-void mrbc_vm_begin(mrb_vm *vm)
+int mrbc_vm_begin(mrb_vm *vm)
 {
+  int i;
+  int size = vm->irep->nregs ? vm->irep->nregs : 1;
+
+  if( vm->regs ) mrbc_free(vm, vm->regs);
+  vm->regs = mrbc_alloc(vm, sizeof(mrb_value) * size);
+  if( vm->regs == NULL ) {
+    vm->regs_size = 0;
+    return -1;	// ENOMEM
+  }
+  vm->regs_size = size;
+
   vm->pc_irep = vm->irep;
   vm->pc = 0;
   vm->current_regs = vm->regs;
-  memset(vm->regs, 0, sizeof(vm->regs));
+  for( i = 0; i < size; i++ ) {
+    mrbc_set_tt(&vm->regs[i], MRB_TT_EMPTY);
+  }
 
   // set self to reg[0]
-  vm->regs[0].tt = MRB_TT_CLASS;
+  mrbc_set_tt(&vm->regs[0], MRB_TT_CLASS);
   vm->regs[0].cls = mrbc_class_object;
 
   vm->callinfo_top = 0;
-  memset(vm->callinfo, 0, sizeof(vm->callinfo));
 
   // target_class
   vm->target_class = mrbc_class_object;
 
   vm->error_code = 0;
   vm->flag_preemption = 0;
+  vm->flag_resume = 0;
+  vm->memory_events = 0;
+
+  return 0;
 }
 
 
@@ -1763,10 +2283,247 @@ void mrbc_vm_begin(mrb_vm *vm)
 void mrbc_vm_end(mrb_vm *vm)
 {
   mrbc_global_clear_vm_id();
+#if MRBC_FREE_QUEUE_SIZE > 0
+  mrbc_deferred_free_all();
+#endif
+#if MRBC_GC_CANDIDATES > 0
+  mrbc_gc_clear_candidates(vm->vm_id);
+#endif
+
+  if( vm->regs ) mrbc_free(vm, vm->regs);
+  if( vm->callinfo ) mrbc_free(vm, vm->callinfo);
+  vm->regs = NULL;
+  vm->current_regs = NULL;
+  vm->callinfo = NULL;
+  vm->regs_size = 0;
+  vm->callinfo_size = 0;
+  vm->callinfo_top = 0;
+
   mrbc_free_all(vm);
 }
 
 
+#if MRBC_USE_THREADED_CODE && defined(__GNUC__)
+//================================================================
+/*!@brief
+  Fetch a bytecode and execute (direct threaded version)
+
+  PC and register base are held in local variables. They are written
+  back to the VM only around instructions that refer to them (method
+  call, return and so on), and flag_preemption is checked only there
+  and on jump instructions.
+
+  @param  vm    A pointer of VM.
+  @retval 0  No error.
+*/
+int mrbc_vm_run( mrb_vm *vm )
+{
+  static const void * const dispatch_table[128] = {
+    [0 ... 127]   = &&L_SKIP,
+    [OP_NOP]      = &&L_OP_NOP,
+    [OP_MOVE]     = &&L_OP_MOVE,
+    [OP_LOADL]    = &&L_OP_LOADL,
+    [OP_LOADI]    = &&L_OP_LOADI,
+    [OP_LOADSYM]  = &&L_OP_LOADSYM,
+    [OP_LOADNIL]  = &&L_OP_LOADNIL,
+    [OP_LOADSELF] = &&L_OP_LOADSELF,
+    [OP_LOADT]    = &&L_OP_LOADT,
+    [OP_LOADF]    = &&L_OP_LOADF,
+    [OP_GETGLOBAL]= &&L_OP_GETGLOBAL,
+    [OP_SETGLOBAL]= &&L_OP_SETGLOBAL,
+    [OP_GETIV]    = &&L_OP_GETIV,
+    [OP_SETIV]    = &&L_OP_SETIV,
+    [OP_GETCONST] = &&L_OP_GETCONST,
+    [OP_SETCONST] = &&L_OP_SETCONST,
+    [OP_GETUPVAR] = &&L_OP_GETUPVAR,
+    [OP_SETUPVAR] = &&L_OP_SETUPVAR,
+    [OP_JMP]      = &&L_OP_JMP,
+    [OP_JMPIF]    = &&L_OP_JMPIF,
+    [OP_JMPNOT]   = &&L_OP_JMPNOT,
+    [OP_SEND]     = &&L_OP_SEND,
+    [OP_SENDB]    = &&L_OP_SEND,	// reuse
+    [OP_CALL]     = &&L_OP_CALL,
+    [OP_ENTER]    = &&L_OP_ENTER,
+    [OP_RETURN]   = &&L_OP_RETURN,
+    [OP_BLKPUSH]  = &&L_OP_BLKPUSH,
+    [OP_ADD]      = &&L_OP_ADD,
+    [OP_ADDI]     = &&L_OP_ADDI,
+    [OP_SUB]      = &&L_OP_SUB,
+    [OP_SUBI]     = &&L_OP_SUBI,
+    [OP_MUL]      = &&L_OP_MUL,
+    [OP_DIV]      = &&L_OP_DIV,
+    [OP_EQ]       = &&L_OP_EQ,
+    [OP_LT]       = &&L_OP_LT,
+    [OP_LE]       = &&L_OP_LE,
+    [OP_GT]       = &&L_OP_GT,
+    [OP_GE]       = &&L_OP_GE,
+    [OP_ARRAY]    = &&L_OP_ARRAY,
+    [OP_STRING]   = &&L_OP_STRING,
+    [OP_STRCAT]   = &&L_OP_STRCAT,
+    [OP_HASH]     = &&L_OP_HASH,
+    [OP_LAMBDA]   = &&L_OP_LAMBDA,
+    [OP_RANGE]    = &&L_OP_RANGE,
+    [OP_CLASS]    = &&L_OP_CLASS,
+    [OP_EXEC]     = &&L_OP_EXEC,
+    [OP_METHOD]   = &&L_OP_METHOD,
+    [OP_TCLASS]   = &&L_OP_TCLASS,
+    [OP_STOP]     = &&L_OP_STOP,
+    [OP_ABORT]    = &&L_OP_STOP,	// reuse
+#if MRBC_USE_SUPERINSTRUCTION
+    [OP_X_EQ_JMPIF]      = &&L_OP_X_EQ_JMPIF,
+    [OP_X_EQ_JMPNOT]     = &&L_OP_X_EQ_JMPNOT,
+    [OP_X_LT_JMPIF]      = &&L_OP_X_LT_JMPIF,
+    [OP_X_LT_JMPNOT]     = &&L_OP_X_LT_JMPNOT,
+    [OP_X_LE_JMPIF]      = &&L_OP_X_LE_JMPIF,
+    [OP_X_LE_JMPNOT]     = &&L_OP_X_LE_JMPNOT,
+    [OP_X_GT_JMPIF]      = &&L_OP_X_GT_JMPIF,
+    [OP_X_GT_JMPNOT]     = &&L_OP_X_GT_JMPNOT,
+    [OP_X_GE_JMPIF]      = &&L_OP_X_GE_JMPIF,
+    [OP_X_GE_JMPNOT]     = &&L_OP_X_GE_JMPNOT,
+    [OP_X_LOADI_ADD]     = &&L_OP_X_LOADI_ADD,
+    [OP_X_LOADI_SUB]     = &&L_OP_X_LOADI_SUB,
+    [OP_X_LOADI_LT]      = &&L_OP_X_LOADI_LT,
+    [OP_X_MOVE_SEND]     = &&L_OP_X_MOVE_SEND,
+    [OP_X_LOADSELF_SEND] = &&L_OP_X_LOADSELF_SEND,
+    [OP_X_GETIV_SEND]    = &&L_OP_X_GETIV_SEND,
+#endif
+  };
+
+  int ret = 0;
+  const uint8_t *pc_ptr = vm->pc_irep->code + vm->pc * CODE_SIZE;
+  mrb_value *regs = vm->current_regs;
+  mrbc_code_t code;
+
+#define SAVE_PC()	(vm->pc = (pc_ptr - vm->pc_irep->code) / CODE_SIZE)
+#define LOAD_PC()	(pc_ptr = vm->pc_irep->code + vm->pc * CODE_SIZE, \
+			 regs = vm->current_regs)
+#define NEXT()		do {						\
+    code = FETCH_CODE(pc_ptr);						\
+    pc_ptr += CODE_SIZE;						\
+    PROFILE_OPCODE(GET_OPCODE(code));					\
+    goto *dispatch_table[GET_OPCODE(code)];				\
+  } while(0)
+#define CHECK_PREEMPTION() do {						\
+    if( vm->flag_preemption ) goto L_EXIT;				\
+  } while(0)
+
+  // operations that don't touch PC and registers base.
+#define OP_LOCAL(op, func)						\
+  L_##op: ret = func(vm, code, regs); NEXT()
+
+  // operations that may refer or change PC, registers base or callinfo.
+#define OP_SYNC(op, func)						\
+  L_##op: SAVE_PC(); ret = func(vm, code, regs); LOAD_PC();		\
+  CHECK_PREEMPTION(); NEXT()
+
+  NEXT();
+
+  OP_LOCAL( OP_NOP,       op_nop );
+  OP_LOCAL( OP_MOVE,      op_move );
+  OP_LOCAL( OP_LOADL,     op_loadl );
+  OP_LOCAL( OP_LOADI,     op_loadi );
+  OP_LOCAL( OP_LOADSYM,   op_loadsym );
+  OP_LOCAL( OP_LOADNIL,   op_loadnil );
+  OP_LOCAL( OP_LOADSELF,  op_loadself );
+  OP_LOCAL( OP_LOADT,     op_loadt );
+  OP_LOCAL( OP_LOADF,     op_loadf );
+  OP_LOCAL( OP_GETGLOBAL, op_getglobal );
+  OP_LOCAL( OP_SETGLOBAL, op_setglobal );
+  OP_LOCAL( OP_GETCONST,  op_getconst );
+  OP_LOCAL( OP_SETCONST,  op_setconst );
+  OP_LOCAL( OP_GETUPVAR,  op_getupvar );
+  OP_LOCAL( OP_SETUPVAR,  op_setupvar );
+
+ L_OP_JMP:
+  pc_ptr += ((int)GETARG_sBx(code) - 1) * CODE_SIZE;
+  ret = 0;
+  CHECK_PREEMPTION();
+  NEXT();
+
+ L_OP_JMPIF:
+  if( mrbc_type(regs[GETARG_A(code)]) > MRB_TT_FALSE ) {
+    pc_ptr += ((int)GETARG_sBx(code) - 1) * CODE_SIZE;
+  }
+  ret = 0;
+  CHECK_PREEMPTION();
+  NEXT();
+
+ L_OP_JMPNOT:
+  if( mrbc_type(regs[GETARG_A(code)]) <= MRB_TT_FALSE ) {
+    pc_ptr += ((int)GETARG_sBx(code) - 1) * CODE_SIZE;
+  }
+  ret = 0;
+  CHECK_PREEMPTION();
+  NEXT();
+
+  OP_SYNC ( OP_GETIV,     op_getiv );	// the iv cache refers to PC.
+  OP_SYNC ( OP_SETIV,     op_setiv );
+  OP_SYNC ( OP_SEND,      op_send );
+  OP_SYNC ( OP_CALL,      op_call );
+  OP_SYNC ( OP_ENTER,     op_enter );
+  OP_SYNC ( OP_RETURN,    op_return );
+  OP_LOCAL( OP_BLKPUSH,   op_blkpush );
+  OP_SYNC ( OP_ADD,       op_add );
+  OP_LOCAL( OP_ADDI,      op_addi );
+  OP_SYNC ( OP_SUB,       op_sub );
+  OP_LOCAL( OP_SUBI,      op_subi );
+  OP_SYNC ( OP_MUL,       op_mul );
+  OP_SYNC ( OP_DIV,       op_div );
+  OP_LOCAL( OP_EQ,        op_eq );
+  OP_SYNC ( OP_LT,        op_lt );
+  OP_SYNC ( OP_LE,        op_le );
+  OP_SYNC ( OP_GT,        op_gt );
+  OP_SYNC ( OP_GE,        op_ge );
+  OP_LOCAL( OP_ARRAY,     op_array );
+  OP_LOCAL( OP_STRING,    op_string );
+  OP_SYNC ( OP_STRCAT,    op_strcat );
+  OP_LOCAL( OP_HASH,      op_hash );
+  OP_LOCAL( OP_LAMBDA,    op_lambda );
+  OP_LOCAL( OP_RANGE,     op_range );
+  OP_SYNC ( OP_CLASS,     op_class );
+  OP_SYNC ( OP_EXEC,      op_exec );
+  OP_SYNC ( OP_METHOD,    op_method );
+  OP_LOCAL( OP_TCLASS,    op_tclass );
+  OP_SYNC ( OP_STOP,      op_stop );
+
+#if MRBC_USE_SUPERINSTRUCTION
+  OP_SYNC ( OP_X_EQ_JMPIF,      op_x_eq_jmpif );
+  OP_SYNC ( OP_X_EQ_JMPNOT,     op_x_eq_jmpnot );
+  OP_SYNC ( OP_X_LT_JMPIF,      op_x_lt_jmpif );
+  OP_SYNC ( OP_X_LT_JMPNOT,     op_x_lt_jmpnot );
+  OP_SYNC ( OP_X_LE_JMPIF,      op_x_le_jmpif );
+  OP_SYNC ( OP_X_LE_JMPNOT,     op_x_le_jmpnot );
+  OP_SYNC ( OP_X_GT_JMPIF,      op_x_gt_jmpif );
+  OP_SYNC ( OP_X_GT_JMPNOT,     op_x_gt_jmpnot );
+  OP_SYNC ( OP_X_GE_JMPIF,      op_x_ge_jmpif );
+  OP_SYNC ( OP_X_GE_JMPNOT,     op_x_ge_jmpnot );
+  OP_SYNC ( OP_X_LOADI_ADD,     op_x_loadi_add );
+  OP_SYNC ( OP_X_LOADI_SUB,     op_x_loadi_sub );
+  OP_SYNC ( OP_X_LOADI_LT,      op_x_loadi_lt );
+  OP_SYNC ( OP_X_MOVE_SEND,     op_x_move_send );
+  OP_SYNC ( OP_X_LOADSELF_SEND, op_x_loadself_send );
+  OP_SYNC ( OP_X_GETIV_SEND,    op_x_getiv_send );
+#endif
+
+ L_SKIP:
+  console_printf("Skip OP=%02x\n", GET_OPCODE(code));
+  NEXT();
+
+ L_EXIT:
+  SAVE_PC();
+  vm->flag_preemption = 0;
+
+  return ret;
+
+#undef SAVE_PC
+#undef LOAD_PC
+#undef NEXT
+#undef CHECK_PREEMPTION
+#undef OP_LOCAL
+#undef OP_SYNC
+}
+
+#else
 //================================================================
 /*!@brief
   Fetch a bytecode and execute
@@ -1780,7 +2537,7 @@ int mrbc_vm_run( mrb_vm *vm )
 
   do {
     // get one bytecode
-    uint32_t code = bin_to_uint32(vm->pc_irep->code + vm->pc * 4);
+    mrbc_code_t code = FETCH_CODE(vm->pc_irep->code + vm->pc * CODE_SIZE);
     vm->pc++;
 
     // regs
@@ -1788,6 +2545,7 @@ int mrbc_vm_run( mrb_vm *vm )
 
     // Dispatch
     int opcode = GET_OPCODE(code);
+    PROFILE_OPCODE(opcode);
     switch( opcode ) {
     case OP_NOP:        ret = op_nop       (vm, code, regs); break;
     case OP_MOVE:       ret = op_move      (vm, code, regs); break;
@@ -1838,6 +2596,24 @@ int mrbc_vm_run( mrb_vm *vm )
     case OP_TCLASS:     ret = op_tclass    (vm, code, regs); break;
     case OP_STOP:       ret = op_stop      (vm, code, regs); break;
     case OP_ABORT:      ret = op_stop      (vm, code, regs); break;  // reuse
+#if MRBC_USE_SUPERINSTRUCTION
+    case OP_X_EQ_JMPIF:      ret = op_x_eq_jmpif      (vm, code, regs); break;
+    case OP_X_EQ_JMPNOT:     ret = op_x_eq_jmpnot     (vm, code, regs); break;
+    case OP_X_LT_JMPIF:      ret = op_x_lt_jmpif      (vm, code, regs); break;
+    case OP_X_LT_JMPNOT:     ret = op_x_lt_jmpnot     (vm, code, regs); break;
+    case OP_X_LE_JMPIF:      ret = op_x_le_jmpif      (vm, code, regs); break;
+    case OP_X_LE_JMPNOT:     ret = op_x_le_jmpnot     (vm, code, regs); break;
+    case OP_X_GT_JMPIF:      ret = op_x_gt_jmpif      (vm, code, regs); break;
+    case OP_X_GT_JMPNOT:     ret = op_x_gt_jmpnot     (vm, code, regs); break;
+    case OP_X_GE_JMPIF:      ret = op_x_ge_jmpif      (vm, code, regs); break;
+    case OP_X_GE_JMPNOT:     ret = op_x_ge_jmpnot     (vm, code, regs); break;
+    case OP_X_LOADI_ADD:     ret = op_x_loadi_add     (vm, code, regs); break;
+    case OP_X_LOADI_SUB:     ret = op_x_loadi_sub     (vm, code, regs); break;
+    case OP_X_LOADI_LT:      ret = op_x_loadi_lt      (vm, code, regs); break;
+    case OP_X_MOVE_SEND:     ret = op_x_move_send     (vm, code, regs); break;
+    case OP_X_LOADSELF_SEND: ret = op_x_loadself_send (vm, code, regs); break;
+    case OP_X_GETIV_SEND:    ret = op_x_getiv_send    (vm, code, regs); break;
+#endif
     default:
       console_printf("Skip OP=%02x\n", GET_OPCODE(code));
       break;
@@ -1848,3 +2624,4 @@ int mrbc_vm_run( mrb_vm *vm )
 
   return ret;
 }
+#endif
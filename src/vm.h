@@ -25,6 +25,16 @@ extern "C" {
 #endif
 
 
+//================================================================
+/*!@brief
+  Constant cache of an OP_GETCONST site.
+*/
+typedef struct CONST_CACHE {
+  uint32_t   epoch;		//!< mrbc_const_epoch when cached. 0 is empty.
+  mrb_object value;		//!< not referenced. valid while epoch matches.
+} mrbc_const_cache;
+
+
 //================================================================
 /*!@brief
   IREP Internal REPresentation
@@ -35,11 +45,16 @@ typedef struct IREP {
   uint16_t rlen;		//!< # of child IREP blocks
   uint16_t ilen;		//!< # of irep
   uint16_t plen;		//!< # of pool
+  uint16_t slen;		//!< # of symbol
 
-  uint8_t     *code;		//!< ISEQ (code) BLOCK
+  uint8_t     *code;		//!< ISEQ (code) BLOCK, or pre-decoded instructions
   mrb_object  **pools;          //!< array of POOL objects pointer.
   uint8_t     *ptr_to_sym;
+  mrb_sym     *syms;		//!< array of symbol IDs, resolved at load time.
   struct IREP **reps;		//!< array of child IREP's pointer.
+#if MRBC_USE_CONST_CACHE
+  mrbc_const_cache *const_cache; //!< indexed by the symbol index of OP_GETCONST.
+#endif
 
 } mrb_irep;
 
@@ -54,6 +69,7 @@ typedef struct CALLINFO {
   mrb_value *current_regs;
   mrb_class *target_class;
   uint8_t   n_args;     // num of args
+  uint8_t   flag_yield; // called by mrbc_yield()
 } mrb_callinfo;
 
 
@@ -70,11 +86,12 @@ typedef struct VM {
   mrb_irep *pc_irep;    // PC
   uint16_t  pc;         // PC
 
-  //  uint16_t     reg_top;
-  mrb_value    regs[MAX_REGS_SIZE];
-  mrb_value   *current_regs;
-  uint16_t     callinfo_top;
-  mrb_callinfo callinfo[MAX_CALLINFO_SIZE];
+  mrb_value    *regs;		// register stack, grows on demand.
+  mrb_value    *current_regs;
+  mrb_callinfo *callinfo;	// callinfo stack, grows on demand.
+  uint16_t      regs_size;
+  uint16_t      callinfo_size;
+  uint16_t      callinfo_top;
 
   mrb_class *target_class;
 
@@ -82,19 +99,32 @@ typedef struct VM {
 
   volatile int8_t flag_preemption;
   int8_t flag_need_memfree;
+  int8_t flag_resume;	// C method is called again by mrbc_yield()
+  int8_t memory_events;	// MRBC_ALLOC_EVENT_xxx not yet returned.
 } mrb_vm;
 
 
 const char *mrbc_get_irep_symbol(const uint8_t *p, int n);
 const char *mrbc_get_callee_name(mrb_vm *vm);
+mrb_sym mrbc_get_callee_symid(mrb_vm *vm);
 mrb_vm *mrbc_vm_open(mrb_vm *vm_arg);
 void mrbc_vm_close(mrb_vm *vm);
-void mrbc_vm_begin(mrb_vm *vm);
+int mrbc_vm_begin(mrb_vm *vm);
 void mrbc_vm_end(mrb_vm *vm);
 int mrbc_vm_run(mrb_vm *vm);
 
-void mrbc_push_callinfo(mrb_vm *vm, int n_args);
+int mrbc_push_callinfo(mrb_vm *vm, int n_args);
 void mrbc_pop_callinfo(mrb_vm *vm);
+int mrbc_extend_regs(mrb_vm *vm, int n);
+int mrbc_yield(mrb_vm *vm, mrb_value *block, mrb_value *argv, int argc);
+#if MRBC_PROFILE_CONST_CACHE
+void mrbc_get_const_cache_stat(uint32_t *hit, uint32_t *miss);
+void mrbc_clear_const_cache_stat(void);
+#endif
+#if MRBC_PROFILE_OPCODE_PAIRS
+void mrbc_print_opcode_pairs(int n);
+void mrbc_clear_opcode_pairs(void);
+#endif
 
 //================================================================
 /*!@brief
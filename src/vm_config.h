@@ -21,6 +21,7 @@
 #endif
 
 /* maximum size of registers */
+/* register stack is allocated by IREP nregs, and grows up to this. */
 #ifndef MAX_REGS_SIZE
 #define MAX_REGS_SIZE 100
 #endif
@@ -30,6 +31,11 @@
 #define MAX_CALLINFO_SIZE 100
 #endif
 
+/* initial size of callinfo. allocated at the first method call. */
+#ifndef MRBC_CALLINFO_INIT_SIZE
+#define MRBC_CALLINFO_INIT_SIZE 4
+#endif
+
 /* maximum number of objects */
 #ifndef MAX_OBJECT_COUNT
 #define MAX_OBJECT_COUNT 400
@@ -40,19 +46,134 @@
 #define MAX_CLASS_COUNT 20
 #endif
 
-/* maximum number of symbols */
+/* maximum number of symbols, not including the built-in ones */
+/* the symbol table grows from the heap up to this. */
 #ifndef MAX_SYMBOLS_COUNT
-#define MAX_SYMBOLS_COUNT 200
+#define MAX_SYMBOLS_COUNT 30000
+#endif
+
+/* initial size of the symbol table. (power of 2) */
+#ifndef MRBC_SYMBOL_TABLE_INIT_SIZE
+#define MRBC_SYMBOL_TABLE_INIT_SIZE 32
 #endif
 
-/* maximum size of global objects */
+/* size of a chunk of the symbol name arena. */
+#ifndef MRBC_SYMBOL_ARENA_SIZE
+#define MRBC_SYMBOL_ARENA_SIZE 256
+#endif
+
+/* initial size of the global object table. (power of 2) */
+/* the table grows from the heap on demand. */
 #ifndef MAX_GLOBAL_OBJECT_SIZE
-#define MAX_GLOBAL_OBJECT_SIZE 20
+#define MAX_GLOBAL_OBJECT_SIZE 16
 #endif
 
-/* maximum size of consts */
+/* initial size of the constant table. (power of 2) */
 #ifndef MAX_CONST_COUNT
-#define MAX_CONST_COUNT 20
+#define MAX_CONST_COUNT 32
+#endif
+
+/* number of method cache entries (power of 2). 0: not use */
+#ifndef MRBC_METHOD_CACHE_SIZE
+#define MRBC_METHOD_CACHE_SIZE 32
+#endif
+
+/* number of instance variable slot cache entries (power of 2). 0: not use */
+#ifndef MRBC_IV_CACHE_SIZE
+#define MRBC_IV_CACHE_SIZE 32
+#endif
+
+/* number of candidates for the cycle collector. 0: not use */
+/* see gc.c */
+#ifndef MRBC_GC_CANDIDATES
+#define MRBC_GC_CANDIDATES 32
+#endif
+
+/* maximum number of objects traced in a step of the cycle collector. */
+/* it bounds the pause between the timeslices. 0: no limit */
+#ifndef MRBC_GC_STEP_SIZE
+#define MRBC_GC_STEP_SIZE 64
+#endif
+
+/* growth rate of Array, Hash and key-value buffers. (percent) */
+/* 100 and MRBC_GROWTH_MIN 6 grow the buffers by a constant size. */
+#ifndef MRBC_GROWTH_RATE
+#define MRBC_GROWTH_RATE 150
+#endif
+
+/* minimum number of elements added when the buffer grows. */
+#ifndef MRBC_GROWTH_MIN
+#define MRBC_GROWTH_MIN 4
+#endif
+
+/* number of bins of the allocation size histogram. */
+/* bin n counts the sizes up to (16 << n), and the last bin the rest. */
+#ifndef MRBC_ALLOC_HISTOGRAM_BINS
+#define MRBC_ALLOC_HISTOGRAM_BINS 8
+#endif
+
+/* size of the emergency reserve, released when out of memory. 0: not use */
+#ifndef MRBC_ALLOC_RESERVE_SIZE
+#define MRBC_ALLOC_RESERVE_SIZE 256
+#endif
+
+/* max number of the low memory hooks. see mrbc_add_low_memory_hook() */
+#ifndef MRBC_LOW_MEMORY_HOOKS
+#define MRBC_LOW_MEMORY_HOOKS 4
+#endif
+
+/* watermarks of the used memory. (percent of the total) */
+#ifndef MRBC_ALLOC_WARNING_LEVEL
+#define MRBC_ALLOC_WARNING_LEVEL 85
+#endif
+#ifndef MRBC_ALLOC_RECOVER_LEVEL
+#define MRBC_ALLOC_RECOVER_LEVEL 70
+#endif
+
+/* number of entries of the allocation trace ring buffer. 0: not use */
+/* 16 bytes each. see mrbc_alloc_trace_dump() and tools/alloc_replay */
+#ifndef MRBC_ALLOC_TRACE
+#define MRBC_ALLOC_TRACE 0
+#endif
+
+/* size of the deferred release queue. 0: not use */
+/* enabled by mrbc_set_deferred_free(1). see gc.c */
+#ifndef MRBC_FREE_QUEUE_SIZE
+#define MRBC_FREE_QUEUE_SIZE 16
+#endif
+
+/* number of references released in a step of the deferred release. */
+#ifndef MRBC_FREE_STEP_SIZE
+#define MRBC_FREE_STEP_SIZE 64
+#endif
+
+/* use 32-bit block size in the memory pool. */
+/* It needs for a memory pool larger than 64KB. (e.g. PSRAM) */
+#ifndef MRBC_ALLOC_LARGE_HEAP
+#define MRBC_ALLOC_LARGE_HEAP 0
+#endif
+
+/* maximum number of memory regions. (up to 8) */
+/* see mrbc_add_alloc_region() */
+#ifndef MRBC_ALLOC_MAX_REGIONS
+#define MRBC_ALLOC_MAX_REGIONS 2
+#endif
+
+/* requests of this size or more are allocated from slow regions. */
+/* see mrbc_set_alloc_policy() */
+#ifndef MRBC_ALLOC_BULK_SIZE
+#define MRBC_ALLOC_BULK_SIZE 256
+#endif
+
+/* maximum size of small objects allocated from slab pages. */
+/* (multiple of 4) 0: not use */
+#ifndef MRBC_SLAB_MAX_SIZE
+#define MRBC_SLAB_MAX_SIZE 32
+#endif
+
+/* size of slab page. it is allocated from the memory pool. */
+#ifndef MRBC_SLAB_PAGE_SIZE
+#define MRBC_SLAB_PAGE_SIZE 256
 #endif
 
 
@@ -63,12 +184,63 @@
 /* USE Float. Support Float class */
 #define MRBC_USE_FLOAT 1
 
+/* Float type. MRBC_FLOAT_DOUBLE or MRBC_FLOAT_SINGLE */
+/* Use single for a CPU with single precision FPU only. (e.g. ESP32) */
+#define MRBC_FLOAT_DOUBLE 1
+#define MRBC_FLOAT_SINGLE 2
+#ifndef MRBC_FLOAT_TYPE
+#define MRBC_FLOAT_TYPE MRBC_FLOAT_DOUBLE
+#endif
+
+/* USE compact (8 bytes) mrb_value. Float is NaN-boxed. */
+/* It needs little endian CPU with 32-bit pointer. (e.g. ESP32) */
+#ifndef MRBC_USE_COMPACT_VALUE
+#define MRBC_USE_COMPACT_VALUE 0
+#endif
+
 /* USE Math class */
 #define MRBC_USE_MATH 0
 
 /* USE String. Support String class */
 #define MRBC_USE_STRING 1
 
+/* USE direct threaded code. (GCC labels as values extension) */
+/* If the compiler is not GCC compatible, switch statement is used. */
+#ifndef MRBC_USE_THREADED_CODE
+#define MRBC_USE_THREADED_CODE 0
+#endif
+
+/* Convert ISEQ to pre-decoded host endian instructions at load time. */
+/* It needs RAM of 8 bytes per instruction. */
+/* 0: execute bytecode in place (low RAM) */
+#ifndef MRBC_USE_DECODED_ISEQ
+#define MRBC_USE_DECODED_ISEQ 0
+#endif
+
+/* Fuse common opcode pairs into superinstructions at load time. */
+/* It needs MRBC_USE_DECODED_ISEQ. */
+#ifndef MRBC_USE_SUPERINSTRUCTION
+#define MRBC_USE_SUPERINSTRUCTION MRBC_USE_DECODED_ISEQ
+#endif
+
+/* Cache the constant of each OP_GETCONST site in the irep. */
+/* It needs RAM of a mrb_value and 4 bytes per constant used in an irep. */
+#ifndef MRBC_USE_CONST_CACHE
+#define MRBC_USE_CONST_CACHE 1
+#endif
+
+/* Count hits and misses of the constant cache. */
+/* see mrbc_get_const_cache_stat() */
+#ifndef MRBC_PROFILE_CONST_CACHE
+#define MRBC_PROFILE_CONST_CACHE 0
+#endif
+
+/* Count executed opcode pairs, for choosing the fused set. */
+/* see mrbc_print_opcode_pairs() */
+#ifndef MRBC_PROFILE_OPCODE_PAIRS
+#define MRBC_PROFILE_OPCODE_PAIRS 0
+#endif
+
 
 
 /* Hardware dependent flags */
@@ -0,0 +1,249 @@
+/*! @file
+  @brief
+  Replay an allocation trace on the host.
+
+  <pre>
+  Copyright (C) 2015-2018 Kyushu Institute of Technology.
+  Copyright (C) 2015-2018 Shimane IT Open-Innovation Center.
+
+  This file is distributed under BSD 3-Clause License.
+
+  Feeds the output of mrbc_alloc_trace_dump() (MRBC_ALLOC_TRACE > 0)
+  into src/alloc.c, and reports the peak usage, the fragmentation and
+  the latency of each operation. Lines other than the trace in the
+  input, such as other serial output, are ignored.
+
+  build (on Linux):
+    gcc -O2 -DMRBC_DEBUG -DMRBC_FREE_QUEUE_SIZE=0 -I../../src \
+      alloc_replay.c ../../src/alloc.c -o alloc_replay
+
+  usage:
+    alloc_replay [-s pool_size] [-S slow_region_size] [-b bulk_size] trace.txt
+
+  Add the flags of the target, such as -DMRBC_SLAB_MAX_SIZE=0 or
+  -DMRBC_ALLOC_LARGE_HEAP=1, to evaluate an allocator policy.
+  (note) Pointers are 64 bits on the host, so the usage is larger
+  than on the target. Blocks allocated before the oldest entry of the
+  ring buffer are unknown, and the operations on them are skipped.
+  MRBC_DEBUG fills the free blocks, and it is included in the latency.
+  </pre>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "alloc.h"
+
+#define MAX_LIVE 8192
+
+// live blocks. address in the trace -> address in the replay.
+static struct {
+  uint32_t addr;
+  void    *ptr;
+  int      vm_id;
+} live[MAX_LIVE];
+static int n_live;
+
+// latency of each operation.
+static const char ops[] = "arfFv";
+static const char *op_names[] = {"alloc", "realloc", "free", "free_all", "set_vm_id"};
+static struct {
+  long count;
+  double total_ns;
+  double max_ns;
+} stat[sizeof(ops) - 1];
+
+// write function for console.h
+int hal_write(int fd, const void *buf, int nbytes)
+{
+  return fwrite(buf, 1, nbytes, stderr);
+}
+
+
+static int find_live(uint32_t addr)
+{
+  int i;
+  for( i = 0; i < n_live; i++ ) {
+    if( live[i].addr == addr ) return i;
+  }
+  return -1;
+}
+
+static void add_live(uint32_t addr, void *ptr, int vm_id)
+{
+  if( n_live >= MAX_LIVE ) {
+    fprintf(stderr, "too many live blocks.\n");
+    exit(1);
+  }
+  live[n_live].addr = addr;
+  live[n_live].ptr = ptr;
+  live[n_live].vm_id = vm_id;
+  n_live++;
+}
+
+static void remove_live(int idx)
+{
+  live[idx] = live[--n_live];
+}
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int pool_size = 1024 * 30;
+  unsigned int slow_size = 0;
+  unsigned int bulk_size = 0;
+  const char *filename = NULL;
+  int i;
+
+  for( i = 1; i < argc; i++ ) {
+    if( strcmp(argv[i], "-s") == 0 && i+1 < argc ) {
+      pool_size = strtoul(argv[++i], NULL, 0);
+    } else if( strcmp(argv[i], "-S") == 0 && i+1 < argc ) {
+      slow_size = strtoul(argv[++i], NULL, 0);
+    } else if( strcmp(argv[i], "-b") == 0 && i+1 < argc ) {
+      bulk_size = strtoul(argv[++i], NULL, 0);
+    } else {
+      filename = argv[i];
+    }
+  }
+  if( filename == NULL ) {
+    fprintf(stderr, "usage: %s [-s pool_size] [-S slow_region_size] "
+	    "[-b bulk_size] trace.txt\n", argv[0]);
+    return 1;
+  }
+  FILE *fp = fopen(filename, "r");
+  if( fp == NULL ) {
+    perror(filename);
+    return 1;
+  }
+
+  mrbc_init_alloc(malloc(pool_size), pool_size);
+  if( slow_size ) mrbc_add_alloc_region(malloc(slow_size), slow_size, MRBC_ALLOC_SLOW);
+  if( bulk_size ) mrbc_set_alloc_policy(bulk_size);
+
+  long n_unknown = 0, n_field_fail = 0, n_replay_fail = 0;
+  int frag_max = 0;
+  int total, used, free, frag;
+  int in_trace = 0;
+  char line[256];
+
+  while( fgets(line, sizeof(line), fp) ) {
+    if( strncmp(line, "== alloc trace", 14) == 0 ) { in_trace = 1; continue; }
+    if( strncmp(line, "== end", 6) == 0 ) { in_trace = 0; continue; }
+    if( !in_trace ) continue;
+
+    char op;
+    int vm_id;
+    unsigned int tick, size, addr, ret;
+    if( sscanf(line, "%c %d %x %x %x %x",
+	       &op, &vm_id, &tick, &size, &addr, &ret) != 6 ) continue;
+    const char *p = strchr(ops, op);
+    if( p == NULL || op == 0 ) continue;
+
+    int idx = (op == 'a') ? -1 : find_live(addr);
+    void *ptr = NULL;
+    mrb_vm vm;
+    vm.vm_id = vm_id;
+    double t = now_ns();
+
+    switch( op ) {
+    case 'a':
+      ptr = mrbc_alloc(&vm, size);
+      break;
+
+    case 'r':
+      if( idx < 0 ) {			// unknown. allocate instead.
+	ptr = mrbc_alloc(&vm, size);
+	n_unknown++;
+      } else {
+	ptr = mrbc_raw_realloc(live[idx].ptr, size);
+      }
+      break;
+
+    case 'f':
+      if( idx < 0 ) { n_unknown++; continue; }
+      mrbc_raw_free(live[idx].ptr);
+      break;
+
+    case 'F':
+      mrbc_free_all(&vm);
+      break;
+
+    case 'v':
+      if( idx < 0 ) { n_unknown++; continue; }
+      mrbc_set_vm_id(live[idx].ptr, vm_id);
+      break;
+    }
+
+    t = now_ns() - t;
+    int n = p - ops;
+    stat[n].count++;
+    stat[n].total_ns += t;
+    if( stat[n].max_ns < t ) stat[n].max_ns = t;
+
+    // update live blocks.
+    switch( op ) {
+    case 'a':
+    case 'r':
+      if( ret == 0 ) n_field_fail++;
+      if( ptr == NULL ) {
+	n_replay_fail++;
+	if( idx >= 0 ) live[idx].addr = ret;	// follow the address in the field.
+	break;
+      }
+      if( idx >= 0 ) remove_live(idx);
+      if( ret == 0 ) {
+	// failed in the field, but not here.
+	if( idx >= 0 ) add_live(addr, ptr, vm_id); else mrbc_raw_free(ptr);
+	break;
+      }
+      add_live(ret, ptr, vm_id);
+      break;
+
+    case 'f':
+      remove_live(idx);
+      break;
+
+    case 'F':
+      for( i = n_live - 1; i >= 0; i-- ) {
+	if( live[i].vm_id == vm_id ) remove_live(i);
+      }
+      break;
+
+    case 'v':
+      live[idx].vm_id = vm_id;
+      break;
+    }
+
+    mrbc_alloc_statistics(&total, &used, &free, &frag);
+    if( frag_max < frag ) frag_max = frag;
+  }
+  fclose(fp);
+
+  MRBC_ALLOC_STATS stats;
+  mrbc_alloc_get_stats(&stats);
+  mrbc_alloc_statistics(&total, &used, &free, &frag);
+  printf("pool          %u bytes", pool_size);
+  if( slow_size ) printf(" + slow region %u bytes", slow_size);
+  printf("\n");
+  printf("peak used     %u bytes\n", stats.peak);
+  printf("largest free  %u bytes at the end\n", stats.largest_free);
+  printf("fragmentation max %d, end %d\n", frag_max, frag);
+  printf("failed        field %ld, replay %ld\n", n_field_fail, n_replay_fail);
+  printf("unknown addr  %ld\n", n_unknown);
+  printf("%-10s %8s %10s %10s\n", "op", "count", "avg ns", "max ns");
+  for( i = 0; i < sizeof(ops) - 1; i++ ) {
+    if( stat[i].count == 0 ) continue;
+    printf("%-10s %8ld %10.0f %10.0f\n", op_names[i], stat[i].count,
+	   stat[i].total_ns / stat[i].count, stat[i].max_ns);
+  }
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+/*! @file
+  @brief
+  Count the opcode pairs of a mruby program on the host.
+
+  <pre>
+  Copyright (C) 2015-2018 Kyushu Institute of Technology.
+  Copyright (C) 2015-2018 Shimane IT Open-Innovation Center.
+
+  This file is distributed under BSD 3-Clause License.
+
+  Runs a .mrb file made by mrbc, and prints the most frequent
+  opcode pairs. (see mrbc_print_opcode_pairs)
+  This is the host version of examples/opcode_pairs, that needs no
+  board and no bytecode compiled in.
+
+  build (on Linux):
+    gcc -O2 -DMRBC_PROFILE_OPCODE_PAIRS=1 -DMRBC_USE_SUPERINSTRUCTION=0 \
+      -I../../src -I../../src/hal opcode_pairs.c \
+      ../../src/[a-z]*.c -o opcode_pairs -lm
+
+  usage:
+    opcode_pairs [-n num_pairs] [-s pool_size] program.mrb
+
+  The script can call micros(). puts and other outputs go to stdout.
+  MRBC_USE_SUPERINSTRUCTION=0 counts the original opcodes.
+  </pre>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mrubyc.h"
+
+#if !MRBC_PROFILE_OPCODE_PAIRS
+#error "build with -DMRBC_PROFILE_OPCODE_PAIRS=1"
+#endif
+
+
+// hal functions. (instead of src/hal/hal.c)
+void hal_init(void)
+{
+}
+
+void hal_init_cpp(void)
+{
+}
+
+void hal_delay(unsigned long t)
+{
+}
+
+int hal_write(int fd, const void *buf, int nbytes)
+{
+  return fwrite(buf, 1, nbytes, stdout);
+}
+
+
+// micros() for ruby script.
+static void c_micros(mrb_vm *vm, mrb_value *v, int argc)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  SET_INT_RETURN((int32_t)(ts.tv_sec * 1000000 + ts.tv_nsec / 1000));
+}
+
+
+static uint8_t *load_file(const char *filename)
+{
+  FILE *fp = fopen(filename, "rb");
+  if( fp == NULL ) {
+    perror(filename);
+    return NULL;
+  }
+
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  uint8_t *p = malloc(size);
+  if( p == NULL || (long)fread(p, 1, size, fp) != size ) {
+    fprintf(stderr, "%s: read error\n", filename);
+    free(p);
+    p = NULL;
+  }
+  fclose(fp);
+  return p;
+}
+
+
+int main(int argc, char *argv[])
+{
+  unsigned int pool_size = 1024 * 30;
+  int n_pairs = 20;
+  const char *filename = NULL;
+  int i;
+
+  for( i = 1; i < argc; i++ ) {
+    if( strcmp(argv[i], "-n") == 0 && i+1 < argc ) {
+      n_pairs = atoi(argv[++i]);
+    } else if( strcmp(argv[i], "-s") == 0 && i+1 < argc ) {
+      pool_size = strtoul(argv[++i], NULL, 0);
+    } else {
+      filename = argv[i];
+    }
+  }
+  if( filename == NULL ) {
+    fprintf(stderr, "usage: %s [-n num_pairs] [-s pool_size] program.mrb\n",
+	    argv[0]);
+    return 1;
+  }
+
+  uint8_t *code = load_file(filename);
+  if( code == NULL ) return 1;
+
+  mrbc_init(malloc(pool_size), pool_size);
+  mrbc_define_method(0, mrbc_class_object, "micros", c_micros);
+  if( mrbc_create_task(code, 0) == NULL ) {
+    fprintf(stderr, "%s: can't load\n", filename);
+    return 1;
+  }
+  mrbc_run();
+
+  fflush(stdout);
+  printf("--- opcode pairs\n");
+  mrbc_print_opcode_pairs(n_pairs);
+
+  return 0;
+}
@@ -0,0 +1,156 @@
+#!/usr/bin/env ruby
+#
+# Generate the built-in symbol table, src/symbol_builtin.h
+#
+#  Copyright (C) 2015-2018 Kyushu Institute of Technology.
+#  Copyright (C) 2015-2018 Shimane IT Open-Innovation Center.
+#
+#  This file is distributed under BSD 3-Clause License.
+#
+# Collects the names given as string literals to mrbc_define_class(),
+# mrbc_define_method(), str_to_symid() and mrbc_symbol_new(), the names
+# of the MRBC_SYM_xxx constants used in src/ and the operators of the
+# instructions, and writes them with the precomputed hashes and hash
+# table of src/symbol.c.
+# Run this after adding built-in classes or methods. A name missing
+# from the table still works, but it is interned in RAM at runtime.
+#
+# usage:
+#   ruby tools/sym_gen/sym_gen.rb [src_dir]
+#
+
+SRC_DIR = ARGV[0] || File.expand_path('../../src', __dir__)
+OUTPUT = 'symbol_builtin.h'
+
+# operator names and their constant names. (MRBC_SYM_OP_xxx)
+OPERATORS = {
+  '+' => 'add', '-' => 'sub', '*' => 'mul', '/' => 'div', '%' => 'mod',
+  '**' => 'pow', '==' => 'eq', '!=' => 'neq', '===' => 'eqq',
+  '<' => 'lt', '<=' => 'le', '>' => 'gt', '>=' => 'ge', '<=>' => 'cmp',
+  '<<' => 'lshift', '>>' => 'rshift', '&' => 'and', '|' => 'or',
+  '^' => 'xor', '~' => 'neg', '!' => 'not', '=~' => 'match',
+  '!~' => 'nmatch', '[]' => 'aref', '[]=' => 'aset', '+@' => 'plus',
+  '-@' => 'minus',
+}
+
+# name -> constant name, or nil.
+def const_name(name)
+  return "MRBC_SYM_OP_#{OPERATORS[name]}" if OPERATORS[name]
+  case name
+  when /\A[A-Za-z_][A-Za-z0-9_]*\z/ then "MRBC_SYM_#{name}"
+  when /\A([A-Za-z_][A-Za-z0-9_]*)\?\z/ then "MRBC_SYM_Q_#{$1}"
+  when /\A([A-Za-z_][A-Za-z0-9_]*)!\z/ then "MRBC_SYM_B_#{$1}"
+  when /\A([A-Za-z_][A-Za-z0-9_]*)=\z/ then "MRBC_SYM_E_#{$1}"
+  end
+end
+
+# constant name -> name. (inverse of const_name)
+def sym_name(const)
+  case const
+  when /\AMRBC_SYM_OP_(\w+)\z/ then OPERATORS.key($1)
+  when /\AMRBC_SYM_Q_(\w+)\z/ then "#{$1}?"
+  when /\AMRBC_SYM_B_(\w+)\z/ then "#{$1}!"
+  when /\AMRBC_SYM_E_(\w+)\z/ then "#{$1}="
+  when /\AMRBC_SYM_(\w+)\z/ then $1
+  end
+end
+
+# 32-bit FNV-1a. same as calc_hash() in symbol.c
+def calc_hash(str)
+  str.each_byte.inject(2166136261) {|h, c| ((h ^ c) * 16777619) & 0xffffffff }
+end
+
+LITERAL = /"((?:[^"\\]|\\.)*)"/
+PATTERNS = [
+  /mrbc_define_class\s*\([^,]*,\s*#{LITERAL}/m,
+  /mrbc_define_method\s*\([^,]*,[^,]*,\s*#{LITERAL}/m,
+  /str_to_symid\s*\(\s*#{LITERAL}\s*\)/m,
+  /mrbc_symbol_new\s*\([^,]*,\s*#{LITERAL}\s*\)/m,
+]
+
+# names in the irep of the arithmetic and comparison instructions.
+# (OP_ADD, OP_EQ etc. have no methods)
+EXTRA_SYMBOLS = %w(+ - * / == < <= > >=)
+
+NOT_SYMBOLS = %w(MRBC_SYM_BUILTIN_COUNT MRBC_SYM_OP_ MRBC_SYM_Q_
+                 MRBC_SYM_B_ MRBC_SYM_E_)
+
+names = []
+files = Dir.glob("#{SRC_DIR}/**/*.{c,cpp,h}").sort
+files.reject! {|f| File.basename(f) == OUTPUT }
+files.each {|file|
+  src = File.read(file, encoding: 'binary')
+  src = src.gsub(%r{/\*.*?\*/}m, '').gsub(%r{//[^\n]*}, '')
+  PATTERNS.each {|re| src.scan(re) {|m| names << m[0] } }
+  src.scan(/\bMRBC_SYM_\w+/) {|m|
+    next if NOT_SYMBOLS.include?(m)
+    name = sym_name(m)
+    abort "#{file}: unknown constant #{m}" unless name
+    names << name
+  }
+}
+names.concat(EXTRA_SYMBOLS)
+names.uniq!
+
+# hash table. the same layout as add_index() in symbol.c
+table_size = 128
+table_size *= 2 while table_size < names.size * 2
+table = [0] * table_size
+hashes = names.map {|name| calc_hash(name) }
+hashes.each_with_index {|h, id|
+  i = h & (table_size - 1)
+  i = (i + 1) & (table_size - 1) while table[i] != 0
+  table[i] = id + 1
+}
+
+File.open(File.join(SRC_DIR, OUTPUT), 'w') {|f|
+  f.puts <<EOS
+/*! @file
+  @brief
+  mruby/c built-in symbols.
+
+  <pre>
+  Copyright (C) 2015-2018 Kyushu Institute of Technology.
+  Copyright (C) 2015-2018 Shimane IT Open-Innovation Center.
+
+  This file is distributed under BSD 3-Clause License.
+
+  Generated by tools/sym_gen/sym_gen.rb. DO NOT EDIT.
+  </pre>
+*/
+
+#ifndef MRBC_SRC_SYMBOL_BUILTIN_H_
+#define MRBC_SRC_SYMBOL_BUILTIN_H_
+
+#define MRBC_SYM_BUILTIN_COUNT #{names.size}
+
+EOS
+  names.each_with_index {|name, id|
+    const = const_name(name)
+    f.printf("#define %-32s %d\t// %s\n", const, id, name) if const
+  }
+  f.puts <<EOS
+
+#endif
+
+
+#ifdef MRBC_SYMBOL_BUILTIN_TABLE
+// symbol id -> hash and name.
+static const struct SYM_INDEX builtin_sym_index[MRBC_SYM_BUILTIN_COUNT] = {
+EOS
+  names.each_with_index {|name, id|
+    f.printf("  { 0x%08x, \"%s\" },\n", hashes[id], name)
+  }
+  f.puts <<EOS
+};
+
+// open addressing hash table. sym_id + 1 of each slot. 0 is empty.
+#define BUILTIN_SYM_TABLE_SIZE #{table_size}
+static const uint16_t builtin_sym_table[BUILTIN_SYM_TABLE_SIZE] = {
+EOS
+  table.each_slice(12) {|a| f.puts "  " + a.map {|v| "#{v}," }.join(' ') }
+  f.puts <<EOS
+};
+#endif
+EOS
+}